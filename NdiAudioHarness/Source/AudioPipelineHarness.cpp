@@ -0,0 +1,500 @@
+/*
+  ==============================================================================
+
+    AudioPipelineHarness.cpp
+    Created: 19 Oct 2026 11:03:26pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include "AudioPipelineHarness.h"
+#include "PluginsUnderTest.h"
+#include "NdiLoopbackBackend.h"
+#include "NdiReplayBackend.h"
+#include <algorithm>
+#include <functional>
+
+//==============================================================================
+namespace
+{
+    const double pulseIntervalSeconds = 0.5;
+    const double chirpSeconds = 0.01;
+    const double chirpStartHz = 200.0;
+    const double chirpEndHz = 8000.0;
+    const double chirpLevel = 0.5;
+
+    const double maxLatencySeconds = 1.0;
+    const double minCorrelation = 0.6;
+    const int connectTimeOutMsec = 5000;
+
+    /** A Hann windowed linear sweep, it correlates to a single sharp peak at any sample rate. */
+    float getChirpSample(double seconds)
+    {
+        if (seconds < 0.0 || seconds >= chirpSeconds)
+            return 0.0f;
+
+        const double sweep_rate = (chirpEndHz - chirpStartHz) / chirpSeconds;
+        const double phase = juce::MathConstants<double>::twoPi * (chirpStartHz * seconds + 0.5 * sweep_rate * seconds * seconds);
+        const double window = 0.5 - 0.5 * std::cos(juce::MathConstants<double>::twoPi * seconds / chirpSeconds);
+
+        return (float)(chirpLevel * window * std::sin(phase));
+    }
+
+    double ticksToSeconds(juce::int64 ticks)
+    {
+        return juce::Time::highResolutionTicksToSeconds(ticks);
+    }
+
+    //==============================================================================
+    /** Calls processBlock in real time, like the audio device of a host. */
+    class HostThread : public juce::Thread
+    {
+    public:
+        //==============================================================================
+        HostThread(const juce::String& threadName, juce::AudioProcessor& processor_, double sampleRate_, int blockSize_, double maxSeconds)
+            : juce::Thread(threadName)
+            , processor(processor_)
+            , sampleRate(sampleRate_)
+            , blockSize(blockSize_)
+            , maxCallbacks((int)std::ceil(maxSeconds * sampleRate_ / blockSize_))
+        {
+            buffer.setSize(juce::jmax(processor.getTotalNumInputChannels(), processor.getTotalNumOutputChannels()), blockSize);
+            callbackTicks.resize((size_t)maxCallbacks);
+            callbackCostSeconds.resize((size_t)maxCallbacks);
+        }
+
+        ~HostThread() override
+        {
+            stopThread(1000);
+        }
+
+        //==============================================================================
+        void run() override
+        {
+            const double ticks_per_period = (double)blockSize / sampleRate * (double)juce::Time::getHighResolutionTicksPerSecond();
+            juce::int64 schedule_start_ticks = juce::Time::getHighResolutionTicks();
+            int schedule_start_callback = 0;
+            juce::int64 sample_position = 0;
+            juce::MidiBuffer midi_messages;
+
+            while (!threadShouldExit() && numCallbacks < maxCallbacks)
+            {
+                // Sleep most of the way, then yield for the rest, so even the smallest blocks are on time.
+                const auto next_ticks = schedule_start_ticks + (juce::int64)((numCallbacks - schedule_start_callback) * ticks_per_period);
+                for (;;)
+                {
+                    const double remaining_seconds = ticksToSeconds(next_ticks - juce::Time::getHighResolutionTicks());
+                    if (remaining_seconds <= 0.0)
+                        break;
+
+                    if (remaining_seconds > 0.002)
+                        juce::Thread::sleep((int)(remaining_seconds * 1000.0) - 1);
+                    else
+                        juce::Thread::yield();
+                }
+
+                const auto start_ticks = juce::Time::getHighResolutionTicks();
+
+                if (fillInput)
+                    fillInput(buffer, sample_position);
+                else
+                    buffer.clear();
+
+                processor.processBlock(buffer, midi_messages);
+
+                const auto end_ticks = juce::Time::getHighResolutionTicks();
+
+                callbackTicks[(size_t)numCallbacks] = start_ticks;
+                callbackCostSeconds[(size_t)numCallbacks] = ticksToSeconds(end_ticks - start_ticks);
+                if (output.size() >= (size_t)((numCallbacks + 1) * blockSize))
+                    std::copy(buffer.getReadPointer(0), buffer.getReadPointer(0) + blockSize, output.begin() + (size_t)numCallbacks * (size_t)blockSize);
+
+                ++numCallbacks;
+                sample_position += blockSize;
+
+                // Like an audio device, a callback that is far behind restarts the schedule instead of bursting to catch up.
+                if (end_ticks - next_ticks > (juce::int64)(4.0 * ticks_per_period))
+                {
+                    schedule_start_ticks = end_ticks;
+                    schedule_start_callback = numCallbacks;
+                }
+            }
+        }
+
+        //==============================================================================
+        void recordOutput()
+        {
+            output.assign((size_t)maxCallbacks * (size_t)blockSize, 0.0f);
+        }
+
+        double getSecondsAt(juce::int64 sampleIndex) const
+        {
+            const auto callback_index = (size_t)(sampleIndex / blockSize);
+            return ticksToSeconds(callbackTicks[callback_index]) + (double)(sampleIndex % blockSize) / sampleRate;
+        }
+
+        AudioPipelineHarness::CallbackStats getCallbackStats(juce::int64 fromTicks) const
+        {
+            std::vector<double> costs_usec;
+            for (int i = 0; i < numCallbacks; ++i)
+            {
+                if (callbackTicks[(size_t)i] >= fromTicks)
+                    costs_usec.push_back(callbackCostSeconds[(size_t)i] * 1.0e6);
+            }
+
+            AudioPipelineHarness::CallbackStats stats;
+            stats.periodUsec = (double)blockSize / sampleRate * 1.0e6;
+            if (costs_usec.empty())
+                return stats;
+
+            std::sort(costs_usec.begin(), costs_usec.end());
+            stats.numCallbacks = (int)costs_usec.size();
+            stats.p50Usec = costs_usec[costs_usec.size() / 2];
+            stats.p99Usec = costs_usec[juce::jmin(costs_usec.size() - 1, (size_t)((double)costs_usec.size() * 0.99))];
+            stats.maxUsec = costs_usec.back();
+            return stats;
+        }
+
+        //==============================================================================
+        juce::AudioProcessor& processor;
+        const double sampleRate;
+        const int blockSize;
+        const int maxCallbacks;
+
+        std::function<void(juce::AudioBuffer<float>&, juce::int64)> fillInput;
+
+        // Written by this thread only, read after it has stopped.
+        std::vector<juce::int64> callbackTicks;
+        std::vector<double> callbackCostSeconds;
+        std::vector<float> output;
+        int numCallbacks{ 0 };
+
+    private:
+        juce::AudioBuffer<float> buffer;
+
+        //==============================================================================
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(HostThread)
+    };
+
+    //==============================================================================
+    /** Finds every chirp the sender played after the warm up in the receiver output. */
+    void findLatencies(AudioPipelineHarness::Result& result, const HostThread& senderThread, const HostThread& receiverThread, juce::int64 fromTicks)
+    {
+        const double receiver_rate = receiverThread.sampleRate;
+        const int template_length = (int)std::ceil(chirpSeconds * receiver_rate);
+
+        std::vector<float> chirp_template((size_t)template_length);
+        double template_energy = 0.0;
+        for (int i = 0; i < template_length; ++i)
+        {
+            chirp_template[(size_t)i] = getChirpSample((double)i / receiver_rate);
+            template_energy += (double)chirp_template[(size_t)i] * chirp_template[(size_t)i];
+        }
+
+        const juce::int64 num_output_samples = (juce::int64)receiverThread.numCallbacks * receiverThread.blockSize;
+        if (num_output_samples <= template_length)
+            return;
+
+        const double output_end_seconds = receiverThread.getSecondsAt(num_output_samples - 1);
+        const double from_seconds = ticksToSeconds(fromTicks);
+        const auto pulse_interval_samples = (juce::int64)std::llround(pulseIntervalSeconds * senderThread.sampleRate);
+        const juce::int64 num_input_samples = (juce::int64)senderThread.numCallbacks * senderThread.blockSize;
+
+        std::vector<double> latencies_msec;
+        juce::int64 search_start = 0;
+
+        for (juce::int64 pulse_sample = 0; pulse_sample < num_input_samples; pulse_sample += pulse_interval_samples)
+        {
+            const double sent_seconds = senderThread.getSecondsAt(pulse_sample);
+            if (sent_seconds < from_seconds || sent_seconds + maxLatencySeconds > output_end_seconds)
+                continue;
+
+            ++result.numPulsesSent;
+
+            while (search_start < num_output_samples && receiverThread.getSecondsAt(search_start) < sent_seconds)
+                ++search_start;
+
+            // Normalised cross-correlation against the chirp, with the window energy kept as a running sum.
+            double best_correlation = 0.0;
+            juce::int64 best_index = -1;
+            double window_energy = 0.0;
+            for (int i = 0; i < template_length && search_start + i < num_output_samples; ++i)
+                window_energy += (double)receiverThread.output[(size_t)(search_start + i)] * receiverThread.output[(size_t)(search_start + i)];
+
+            for (juce::int64 index = search_start; index + template_length < num_output_samples; ++index)
+            {
+                if (receiverThread.getSecondsAt(index) > sent_seconds + maxLatencySeconds)
+                    break;
+
+                if (window_energy > 1.0e-9)
+                {
+                    double dot = 0.0;
+                    const float* window = receiverThread.output.data() + index;
+                    for (int i = 0; i < template_length; ++i)
+                        dot += (double)window[i] * chirp_template[(size_t)i];
+
+                    const double correlation = dot / std::sqrt(window_energy * template_energy);
+                    if (correlation > best_correlation)
+                    {
+                        best_correlation = correlation;
+                        best_index = index;
+                    }
+                }
+
+                const double leaving = receiverThread.output[(size_t)index];
+                const double entering = receiverThread.output[(size_t)(index + template_length)];
+                window_energy = juce::jmax(0.0, window_energy - leaving * leaving + entering * entering);
+            }
+
+            if (best_index >= 0 && best_correlation >= minCorrelation)
+                latencies_msec.push_back((receiverThread.getSecondsAt(best_index) - sent_seconds) * 1000.0);
+        }
+
+        result.numPulsesFound = (int)latencies_msec.size();
+        if (latencies_msec.empty())
+            return;
+
+        std::sort(latencies_msec.begin(), latencies_msec.end());
+        result.minLatencyMsec = latencies_msec.front();
+        result.medianLatencyMsec = latencies_msec[latencies_msec.size() / 2];
+        result.maxLatencyMsec = latencies_msec.back();
+    }
+}
+
+//==============================================================================
+juce::String AudioPipelineHarness::Scenario::getName() const
+{
+    juce::String name;
+    name << blockSize << " " << (int)senderSampleRate << "->" << (int)receiverSampleRate
+         << " j" << jitterMsec << " d" << (clockDriftPpm > 0.0 ? "+" : "") << juce::String(clockDriftPpm, 0);
+    return name;
+}
+
+//==============================================================================
+AudioPipelineHarness::AudioPipelineHarness(const Options& options_)
+    : options(options_)
+{
+}
+
+AudioPipelineHarness::Result AudioPipelineHarness::run(const Scenario& scenario) const
+{
+    Result result;
+    result.scenario = scenario;
+
+    NdiLoopbackBackend::Settings settings;
+    settings.jitterMsec = scenario.jitterMsec;
+    settings.clockDriftPpm = scenario.clockDriftPpm;
+    settings.randomSeed = options.randomSeed;
+    NdiBackend::setDefault(std::make_shared<NdiLoopbackBackend>(settings));
+
+    {
+        auto sender = SenderUnderTest::create();
+        auto receiver = ReceiverUnderTest::create();
+
+        sender->setRateAndBufferSizeDetails(scenario.senderSampleRate, scenario.blockSize);
+        sender->prepareToPlay(scenario.senderSampleRate, scenario.blockSize);
+        receiver->setRateAndBufferSizeDetails(scenario.receiverSampleRate, scenario.blockSize);
+        receiver->prepareToPlay(scenario.receiverSampleRate, scenario.blockSize);
+
+        result.isConnected = ReceiverUnderTest::connectToFirstSource(*receiver, connectTimeOutMsec);
+        if (result.isConnected)
+        {
+            const double max_seconds = options.warmUpSeconds + options.measureSeconds + 1.0;
+            HostThread sender_thread("Harness Sender Host", *sender, scenario.senderSampleRate, scenario.blockSize, max_seconds);
+            HostThread receiver_thread("Harness Receiver Host", *receiver, scenario.receiverSampleRate, scenario.blockSize, max_seconds);
+
+            const auto pulse_interval_samples = (juce::int64)std::llround(pulseIntervalSeconds * scenario.senderSampleRate);
+            const double sender_rate = scenario.senderSampleRate;
+            sender_thread.fillInput = [pulse_interval_samples, sender_rate](juce::AudioBuffer<float>& buffer, juce::int64 samplePosition)
+            {
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                {
+                    const float sample = getChirpSample((double)((samplePosition + i) % pulse_interval_samples) / sender_rate);
+                    for (int ch_idx = 0; ch_idx < buffer.getNumChannels(); ++ch_idx)
+                        buffer.setSample(ch_idx, i, sample);
+                }
+            };
+            receiver_thread.recordOutput();
+
+            receiver_thread.startThread(9);
+            sender_thread.startThread(9);
+
+            juce::Thread::sleep((int)(options.warmUpSeconds * 1000.0));
+            const auto measure_start_ticks = juce::Time::getHighResolutionTicks();
+            const int fades_at_start = ReceiverUnderTest::getNumUnderrunFades(*receiver);
+
+            juce::Thread::sleep((int)(options.measureSeconds * 1000.0));
+            sender_thread.stopThread(1000);
+            receiver_thread.stopThread(1000);
+
+            result.numUnderrunFades = ReceiverUnderTest::getNumUnderrunFades(*receiver) - fades_at_start;
+            result.reportedLatencyMsec = ReceiverUnderTest::getReportedLatencySamples(*receiver) * 1000.0 / scenario.receiverSampleRate;
+            result.sender = sender_thread.getCallbackStats(measure_start_ticks);
+            result.receiver = receiver_thread.getCallbackStats(measure_start_ticks);
+            findLatencies(result, sender_thread, receiver_thread, measure_start_ticks);
+            result.pipelineStats = ReceiverUnderTest::getPipelineStats(*receiver);
+        }
+
+        receiver->releaseResources();
+        sender->releaseResources();
+    }
+
+    NdiBackend::setDefault(nullptr);
+    return result;
+}
+
+AudioPipelineHarness::Result AudioPipelineHarness::runReplay(const juce::File& file, const Scenario& scenario, bool asFastAsPossible) const
+{
+    Result result;
+    result.scenario = scenario;
+
+    NdiReplayBackend::Settings settings;
+    settings.isRealTime = !asFastAsPossible;
+    auto replay = std::make_shared<NdiReplayBackend>(file, settings);
+    if (!replay->isAvailable())
+        return result;
+
+    NdiBackend::setDefault(replay);
+
+    {
+        auto receiver = ReceiverUnderTest::create();
+        receiver->setRateAndBufferSizeDetails(scenario.receiverSampleRate, scenario.blockSize);
+        receiver->prepareToPlay(scenario.receiverSampleRate, scenario.blockSize);
+
+        result.isConnected = ReceiverUnderTest::connectToFirstSource(*receiver, connectTimeOutMsec);
+        if (result.isConnected)
+        {
+            // The whole recording is measured, it ends by going quiet.
+            const double play_seconds = asFastAsPossible ? options.measureSeconds : replay->getLengthSeconds();
+            HostThread receiver_thread("Harness Receiver Host", *receiver, scenario.receiverSampleRate, scenario.blockSize, play_seconds + 1.0);
+
+            const auto start_ticks = juce::Time::getHighResolutionTicks();
+            receiver_thread.startThread(9);
+
+            juce::Thread::sleep((int)(play_seconds * 1000.0));
+            receiver_thread.stopThread(1000);
+
+            result.numUnderrunFades = ReceiverUnderTest::getNumUnderrunFades(*receiver);
+            result.receiver = receiver_thread.getCallbackStats(start_ticks);
+            result.pipelineStats = ReceiverUnderTest::getPipelineStats(*receiver);
+        }
+
+        receiver->releaseResources();
+    }
+
+    NdiBackend::setDefault(nullptr);
+    return result;
+}
+
+//==============================================================================
+juce::String AudioPipelineHarness::toJson(const std::vector<Result>& results, const juce::String& label) const
+{
+    auto callback_stats_to_var = [](const CallbackStats& stats)
+    {
+        auto* entry = new juce::DynamicObject();
+        entry->setProperty("callbacks", stats.numCallbacks);
+        entry->setProperty("p50_us", stats.p50Usec);
+        entry->setProperty("p99_us", stats.p99Usec);
+        entry->setProperty("max_us", stats.maxUsec);
+        entry->setProperty("period_us", stats.periodUsec);
+        return juce::var(entry);
+    };
+
+    juce::Array<juce::var> result_list;
+    for (const auto& result : results)
+    {
+        auto* entry = new juce::DynamicObject();
+        entry->setProperty("scenario", result.scenario.getName());
+        entry->setProperty("block_size", result.scenario.blockSize);
+        entry->setProperty("sender_rate", result.scenario.senderSampleRate);
+        entry->setProperty("receiver_rate", result.scenario.receiverSampleRate);
+        entry->setProperty("jitter_ms", result.scenario.jitterMsec);
+        entry->setProperty("drift_ppm", result.scenario.clockDriftPpm);
+        entry->setProperty("connected", result.isConnected);
+        entry->setProperty("sender_callback", callback_stats_to_var(result.sender));
+        entry->setProperty("receiver_callback", callback_stats_to_var(result.receiver));
+        entry->setProperty("pulses_sent", result.numPulsesSent);
+        entry->setProperty("pulses_found", result.numPulsesFound);
+        entry->setProperty("latency_min_ms", result.minLatencyMsec);
+        entry->setProperty("latency_median_ms", result.medianLatencyMsec);
+        entry->setProperty("latency_max_ms", result.maxLatencyMsec);
+        entry->setProperty("latency_reported_ms", result.reportedLatencyMsec);
+        entry->setProperty("underrun_fades", result.numUnderrunFades);
+        entry->setProperty("pipeline_stats", juce::var(result.pipelineStats));
+        result_list.add(juce::var(entry));
+    }
+
+    auto* machine = new juce::DynamicObject();
+    machine->setProperty("os", juce::SystemStats::getOperatingSystemName());
+    machine->setProperty("cpu_vendor", juce::SystemStats::getCpuVendor());
+    machine->setProperty("num_cpus", juce::SystemStats::getNumCpus());
+
+    auto* root = new juce::DynamicObject();
+    root->setProperty("benchmark", "audio-pipeline");
+    root->setProperty("label", label);
+    root->setProperty("time", juce::Time::getCurrentTime().toISO8601(true));
+    root->setProperty("warm_up_s", options.warmUpSeconds);
+    root->setProperty("measure_s", options.measureSeconds);
+    root->setProperty("seed", options.randomSeed);
+    root->setProperty("machine", juce::var(machine));
+    root->setProperty("results", result_list);
+
+    return juce::JSON::toString(juce::var(root));
+}
+
+juce::String AudioPipelineHarness::toCsv(const std::vector<Result>& results)
+{
+    juce::String csv("scenario,block_size,sender_rate,receiver_rate,jitter_ms,drift_ppm,connected,"
+                     "sender_p50_us,sender_p99_us,sender_max_us,receiver_p50_us,receiver_p99_us,receiver_max_us,period_us,"
+                     "pulses_sent,pulses_found,latency_min_ms,latency_median_ms,latency_max_ms,latency_reported_ms,underrun_fades\n");
+    for (const auto& result : results)
+    {
+        csv << result.scenario.getName() << "," << result.scenario.blockSize << ","
+            << (int)result.scenario.senderSampleRate << "," << (int)result.scenario.receiverSampleRate << ","
+            << result.scenario.jitterMsec << "," << juce::String(result.scenario.clockDriftPpm, 1) << ","
+            << (result.isConnected ? 1 : 0) << ","
+            << juce::String(result.sender.p50Usec, 2) << "," << juce::String(result.sender.p99Usec, 2) << "," << juce::String(result.sender.maxUsec, 2) << ","
+            << juce::String(result.receiver.p50Usec, 2) << "," << juce::String(result.receiver.p99Usec, 2) << "," << juce::String(result.receiver.maxUsec, 2) << ","
+            << juce::String(result.receiver.periodUsec, 2) << ","
+            << result.numPulsesSent << "," << result.numPulsesFound << ","
+            << juce::String(result.minLatencyMsec, 3) << "," << juce::String(result.medianLatencyMsec, 3) << "," << juce::String(result.maxLatencyMsec, 3) << ","
+            << juce::String(result.reportedLatencyMsec, 3) << ","
+            << result.numUnderrunFades << "\n";
+    }
+    return csv;
+}
+
+juce::String AudioPipelineHarness::toTable(const std::vector<Result>& results)
+{
+    juce::String table;
+    table << juce::String("scenario").paddedRight(' ', 28)
+          << juce::String("recv p50/p99/max us").paddedLeft(' ', 24)
+          << juce::String("send p99 us").paddedLeft(' ', 12)
+          << juce::String("latency ms").paddedLeft(' ', 20)
+          << juce::String("reported").paddedLeft(' ', 10)
+          << juce::String("pulses").paddedLeft(' ', 8)
+          << juce::String("fades").paddedLeft(' ', 7) << "\n";
+
+    for (const auto& result : results)
+    {
+        if (!result.isConnected)
+        {
+            table << result.scenario.getName().paddedRight(' ', 28) << "  not connected\n";
+            continue;
+        }
+
+        const juce::String receiver_cost = juce::String(result.receiver.p50Usec, 1) + "/" + juce::String(result.receiver.p99Usec, 1) + "/" + juce::String(result.receiver.maxUsec, 1);
+        const juce::String latency = juce::String(result.minLatencyMsec, 1) + ".." + juce::String(result.maxLatencyMsec, 1) + " (" + juce::String(result.medianLatencyMsec, 1) + ")";
+        const juce::String pulses = juce::String(result.numPulsesFound) + "/" + juce::String(result.numPulsesSent);
+
+        table << result.scenario.getName().paddedRight(' ', 28)
+              << receiver_cost.paddedLeft(' ', 24)
+              << juce::String(result.sender.p99Usec, 1).paddedLeft(' ', 12)
+              << latency.paddedLeft(' ', 20)
+              << juce::String(result.reportedLatencyMsec, 1).paddedLeft(' ', 10)
+              << pulses.paddedLeft(' ', 8)
+              << juce::String(result.numUnderrunFades).paddedLeft(' ', 7) << "\n";
+    }
+    return table;
+}
@@ -0,0 +1,104 @@
+/*
+  ==============================================================================
+
+    AudioPipelineHarness.h
+    Created: 19 Oct 2026 11:03:26pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+
+//==============================================================================
+/**
+    Runs a sender and a receiver processor back to back over an in-memory NDI.
+
+    Each processor is driven by its own host thread, paced in real time at its
+    own sample rate and block size, like two audio devices. The sender plays a
+    chirp every half second and the receiver output is correlated against it to
+    find the end-to-end latency, from the sender's input to the receiver's
+    output at callback times. Jitter and clock drift are simulated by the
+    NdiLoopbackBackend in between.
+
+    runReplay() drives the receiver alone from a recording instead, see
+    NdiReplayBackend, so a problem captured in the field can be run again.
+*/
+class AudioPipelineHarness
+{
+public:
+    //==============================================================================
+    struct Scenario
+    {
+        int blockSize{ 512 };
+        double senderSampleRate{ 48000.0 };
+        double receiverSampleRate{ 48000.0 };
+        int jitterMsec{ 0 };
+        double clockDriftPpm{ 0.0 };
+
+        juce::String getName() const;
+    };
+
+    struct Options
+    {
+        double warmUpSeconds{ 1.5 };
+        double measureSeconds{ 3.0 };
+        juce::int64 randomSeed{ 1 };
+    };
+
+    struct CallbackStats
+    {
+        int numCallbacks{ 0 };
+        double p50Usec{ 0.0 };
+        double p99Usec{ 0.0 };
+        double maxUsec{ 0.0 };
+        double periodUsec{ 0.0 };
+    };
+
+    struct Result
+    {
+        Scenario scenario;
+        bool isConnected{ false };
+
+        CallbackStats sender;
+        CallbackStats receiver;
+
+        int numPulsesSent{ 0 };
+        int numPulsesFound{ 0 };
+        double minLatencyMsec{ 0.0 };
+        double medianLatencyMsec{ 0.0 };
+        double maxLatencyMsec{ 0.0 };
+        // What the receiver tells the host, the measured median should be close to it.
+        double reportedLatencyMsec{ 0.0 };
+
+        int numUnderrunFades{ 0 };
+
+        // The receiver's NdiPipelineStats at the end of the run.
+        juce::StringArray pipelineStats;
+    };
+
+    //==============================================================================
+    explicit AudioPipelineHarness(const Options& options);
+
+    Result run(const Scenario& scenario) const;
+
+    /** Plays a recording into the receiver, at the recorded pace or as fast as it is taken.
+        Only the receiver's block size and sample rate of the scenario are used,
+        and there are no pulses to measure the latency with.
+    */
+    Result runReplay(const juce::File& file, const Scenario& scenario, bool asFastAsPossible) const;
+
+    //==============================================================================
+    juce::String toJson(const std::vector<Result>& results, const juce::String& label) const;
+    static juce::String toCsv(const std::vector<Result>& results);
+    static juce::String toTable(const std::vector<Result>& results);
+
+private:
+    //==============================================================================
+    const Options options;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioPipelineHarness)
+};
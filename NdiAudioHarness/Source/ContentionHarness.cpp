@@ -0,0 +1,309 @@
+/*
+  ==============================================================================
+
+    ContentionHarness.cpp
+    Created: 20 Oct 2026 12:06:33pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include "ContentionHarness.h"
+#include "NdiExecutor.h"
+#include "PluginsUnderTest.h"
+#include "NdiLoopbackBackend.h"
+#include <algorithm>
+
+//==============================================================================
+namespace
+{
+    // Far longer than an audio block, like a 4K conversion or an editor connecting.
+    const double busyJobMsec = 20.0;
+    const int audioIntervalMsec = 2;
+    const int numOrderedTasks = 1000;
+
+    const double sampleRate = 48000.0;
+    const int blockSize = 512;
+    const int connectTimeOutMsec = 2000;
+    // Longer than the sender's check for receivers.
+    const int sendWarmUpMsec = 3000;
+    // Far beyond any send, only a stuck one gets near it.
+    const double audioSendTimeOutMsec = 200.0;
+
+    void spinFor(double msec)
+    {
+        const auto end_msec = juce::Time::getMillisecondCounterHiRes() + msec;
+        while (juce::Time::getMillisecondCounterHiRes() < end_msec) {}
+    }
+
+    /** Touched by the audio task only, and read once it is cancelled. */
+    struct AudioTiming
+    {
+        double dueMsec{ 0.0 };
+        double maxLateMsec{ 0.0 };
+        double totalLateMsec{ 0.0 };
+        int numRuns{ 0 };
+    };
+
+    //==============================================================================
+    /** Queues a new 4K frame whenever the sender has room, like a camera the sender cannot keep up with. */
+    class CameraThread : public juce::Thread
+    {
+    public:
+        //==============================================================================
+        explicit CameraThread(juce::AudioProcessor& sender_)
+            : juce::Thread("Harness Camera")
+            , sender(sender_)
+            , image(juce::Image::ARGB, 3840, 2160, true)
+        {
+            // Converting costs the same whatever the pixels are.
+            image.clear(image.getBounds(), juce::Colours::orange);
+        }
+
+        ~CameraThread() override
+        {
+            stopThread(1000);
+        }
+
+        //==============================================================================
+        void run() override
+        {
+            while (!threadShouldExit())
+            {
+                // A copy each time, the send task clears the image it took.
+                if (!SenderUnderTest::pushVideoFrame(sender, image.createCopy()))
+                    juce::Thread::sleep(5);
+            }
+        }
+
+    private:
+        //==============================================================================
+        juce::AudioProcessor& sender;
+        juce::Image image;
+
+        //==============================================================================
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CameraThread)
+    };
+}
+
+//==============================================================================
+bool ContentionHarness::ExecutorResult::hasPassed(double lateLimitMsec) const
+{
+    return maxLateMsec <= lateLimitMsec && numAudioRuns > 0 && numBusyJobs > 0
+        && numOrderedRuns == numOrderedTasks && numOutOfOrder == 0 && numRunsAfterCancel == 0;
+}
+
+juce::String ContentionHarness::ExecutorResult::toText() const
+{
+    juce::String text;
+    text << "Executor     " << numWorkers << " workers, " << numBusyQueues << " queues of " << juce::String(busyJobMsec, 0) << " ms jobs, "
+         << numBusyJobs << " jobs run\n"
+         << "Audio lane   " << numAudioRuns << "/" << numExpectedAudioRuns << " runs, late by " << juce::String(maxLateMsec, 2)
+         << " ms max, " << juce::String(meanLateMsec, 3) << " ms mean\n"
+         << "Ordering     " << numOrderedRuns << "/" << numOrderedTasks << " tasks run, " << numOutOfOrder << " out of order\n"
+         << "Cancel       " << numRunsAfterCancel << " runs after cancelAndWait\n";
+    return text;
+}
+
+bool ContentionHarness::SendLatencyResult::hasPassed(double audioSendLimitMsec) const
+{
+    return isConnected && numBlocks > 0 && numAudioSent == numBlocks && numVideoFramesSent > 0
+        && maxAudioSendMsec <= audioSendLimitMsec;
+}
+
+juce::String ContentionHarness::SendLatencyResult::toText() const
+{
+    juce::String text;
+    text << "Sender       " << (isConnected ? "connected" : "not connected") << ", " << numVideoFramesSent << " 4K frames sent\n"
+         << "Convert      " << juce::String(maxConvertMsec, 1) << " ms max, " << juce::String(meanConvertMsec, 2) << " ms mean\n"
+         << "Audio send   " << numAudioSent << "/" << numBlocks << " blocks, " << juce::String(maxAudioSendMsec, 2) << " ms max, "
+         << juce::String(medianAudioSendMsec, 2) << " ms median\n";
+    return text;
+}
+
+//==============================================================================
+ContentionHarness::ExecutorResult ContentionHarness::runExecutor(int numBusyQueues, double seconds)
+{
+    ExecutorResult result;
+    result.numBusyQueues = numBusyQueues;
+
+    juce::SharedResourcePointer<NdiExecutor> executor;
+    result.numWorkers = executor->getNumThreads();
+
+    // Every normal worker is taken up, there are more jobs waiting than workers.
+    std::atomic<int> num_busy_jobs{ 0 };
+    juce::OwnedArray<NdiExecutor::Queue> busy_queues;
+    for (int queue_idx = 0; queue_idx < numBusyQueues; ++queue_idx)
+    {
+        busy_queues.add(new NdiExecutor::Queue("Harness Busy " + juce::String(queue_idx + 1)));
+        busy_queues.getLast()->submitRepeating([&num_busy_jobs]()
+        {
+            spinFor(busyJobMsec);
+            ++num_busy_jobs;
+            return 0;
+        });
+    }
+
+    // Queued behind the busy jobs, their order has to hold anyway.
+    std::vector<int> run_order;
+    run_order.reserve(numOrderedTasks);
+    std::atomic<int> num_ordered_runs{ 0 };
+    NdiExecutor::Queue ordered_queue("Harness Ordered");
+    for (int task_idx = 0; task_idx < numOrderedTasks; ++task_idx)
+    {
+        ordered_queue.submit([&run_order, &num_ordered_runs, task_idx]()
+        {
+            run_order.push_back(task_idx);
+            ++num_ordered_runs;
+        });
+    }
+
+    AudioTiming timing;
+    std::atomic<int> num_audio_runs{ 0 };
+    auto audio_queue = std::make_unique<NdiExecutor::Queue>("Harness Audio");
+
+    const auto start_msec = juce::Time::getMillisecondCounterHiRes();
+    timing.dueMsec = start_msec;
+    audio_queue->submitRepeating([&timing, &num_audio_runs]()
+    {
+        const auto now_msec = juce::Time::getMillisecondCounterHiRes();
+        const double late_msec = juce::jmax(0.0, now_msec - timing.dueMsec);
+        timing.maxLateMsec = juce::jmax(timing.maxLateMsec, late_msec);
+        timing.totalLateMsec += late_msec;
+        ++timing.numRuns;
+        ++num_audio_runs;
+
+        timing.dueMsec = juce::Time::getMillisecondCounterHiRes() + audioIntervalMsec;
+        return audioIntervalMsec;
+    }, NdiExecutor::Lane::audio);
+
+    juce::Thread::sleep((int)(seconds * 1000.0));
+
+    audio_queue->cancelAndWait();
+    const double elapsed_msec = juce::Time::getMillisecondCounterHiRes() - start_msec;
+    const int num_runs_at_cancel = num_audio_runs.load();
+
+    // Long enough for a run that should not happen.
+    juce::Thread::sleep(audioIntervalMsec * 10);
+    result.numRunsAfterCancel = num_audio_runs.load() - num_runs_at_cancel;
+
+    result.numAudioRuns = timing.numRuns;
+    result.numExpectedAudioRuns = (int)(elapsed_msec / audioIntervalMsec);
+    result.maxLateMsec = timing.maxLateMsec;
+    result.meanLateMsec = timing.numRuns > 0 ? timing.totalLateMsec / timing.numRuns : 0.0;
+
+    busy_queues.clear();
+    result.numBusyJobs = num_busy_jobs.load();
+
+    // The busy queues are gone, so whatever is left of the ordered tasks gets through now.
+    const auto ordered_end_msec = juce::Time::getMillisecondCounter() + 2000;
+    while (num_ordered_runs.load() < numOrderedTasks && juce::Time::getMillisecondCounter() < ordered_end_msec)
+        juce::Thread::sleep(1);
+
+    ordered_queue.cancelAndWait();
+    result.numOrderedRuns = num_ordered_runs.load();
+    for (size_t run_idx = 0; run_idx < run_order.size(); ++run_idx)
+    {
+        if (run_order[run_idx] != (int)run_idx)
+            ++result.numOutOfOrder;
+    }
+
+    return result;
+}
+
+ContentionHarness::SendLatencyResult ContentionHarness::runSendLatency(double seconds)
+{
+    SendLatencyResult result;
+
+    auto loopback = std::make_shared<NdiLoopbackBackend>();
+    NdiBackend::setDefault(loopback);
+
+    {
+        auto sender = SenderUnderTest::create();
+        sender->setRateAndBufferSizeDetails(sampleRate, blockSize);
+        sender->prepareToPlay(sampleRate, blockSize);
+
+        auto receiver = ReceiverUnderTest::create();
+        receiver->setRateAndBufferSizeDetails(sampleRate, blockSize);
+        receiver->prepareToPlay(sampleRate, blockSize);
+
+        result.isConnected = ReceiverUnderTest::connectToFirstSource(*receiver, connectTimeOutMsec);
+
+        auto& stats = SenderUnderTest::getPipelineStats(*sender);
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::MidiBuffer midi_messages;
+
+        // Until the sender has seen the receiver and sends audio at all.
+        const auto warm_up_end_msec = juce::Time::getMillisecondCounter() + (juce::uint32)sendWarmUpMsec;
+        while (stats.audioFramesSent.get() == 0 && juce::Time::getMillisecondCounter() < warm_up_end_msec)
+        {
+            buffer.clear();
+            sender->processBlock(buffer, midi_messages);
+            receiver->processBlock(buffer, midi_messages);
+            juce::Thread::sleep(10);
+        }
+
+        CameraThread camera(*sender);
+        camera.startThread();
+
+        // Measured once the video is converting.
+        while (stats.videoFramesSent.get() == 0 && juce::Time::getMillisecondCounter() < warm_up_end_msec + (juce::uint32)sendWarmUpMsec)
+            juce::Thread::sleep(10);
+        stats.reset();
+
+        const double block_msec = blockSize * 1000.0 / sampleRate;
+        const auto end_msec = juce::Time::getMillisecondCounterHiRes() + seconds * 1000.0;
+        std::vector<double> audio_send_msecs;
+
+        while (juce::Time::getMillisecondCounterHiRes() < end_msec)
+        {
+            const auto block_start_msec = juce::Time::getMillisecondCounterHiRes();
+            const auto num_sent = stats.audioFramesSent.get();
+
+            buffer.clear();
+            sender->processBlock(buffer, midi_messages);
+            ++result.numBlocks;
+
+            // The send task picks the block up on its own, this only watches for it.
+            const auto queued_msec = juce::Time::getMillisecondCounterHiRes();
+            double send_msec = 0.0;
+            while (stats.audioFramesSent.get() == num_sent && send_msec < audioSendTimeOutMsec)
+            {
+                juce::Thread::yield();
+                send_msec = juce::Time::getMillisecondCounterHiRes() - queued_msec;
+            }
+
+            if (stats.audioFramesSent.get() != num_sent)
+            {
+                ++result.numAudioSent;
+                audio_send_msecs.push_back(send_msec);
+            }
+
+            receiver->processBlock(buffer, midi_messages);
+
+            // At the pace of a host, whatever the sender does.
+            const int rest_msec = (int)(block_start_msec + block_msec - juce::Time::getMillisecondCounterHiRes());
+            if (rest_msec > 0)
+                juce::Thread::sleep(rest_msec);
+        }
+
+        camera.stopThread(1000);
+
+        if (!audio_send_msecs.empty())
+        {
+            std::sort(audio_send_msecs.begin(), audio_send_msecs.end());
+            result.maxAudioSendMsec = audio_send_msecs.back();
+            result.medianAudioSendMsec = audio_send_msecs[audio_send_msecs.size() / 2];
+        }
+
+        result.numVideoFramesSent = (int)stats.videoFramesSent.get();
+        result.maxConvertMsec = stats.convertTime.getMaxMicroseconds() * 0.001;
+        result.meanConvertMsec = stats.convertTime.getMeanMicroseconds() * 0.001;
+
+        receiver->releaseResources();
+        sender->releaseResources();
+    }
+
+    NdiBackend::setDefault(nullptr);
+    return result;
+}
@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+
+    ContentionHarness.h
+    Created: 20 Oct 2026 12:06:33pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Loads the shared NdiExecutor with long jobs and checks that audio work
+    still runs on time.
+
+    runExecutor() keeps every normal worker busy with jobs far longer than an
+    audio block, as many editor jobs or conversions would. Meanwhile a task on
+    the audio lane asks to run every few milliseconds, and each run is timed
+    against when it was due. It also checks that the tasks of one queue run in
+    the order submitted, and that nothing runs after cancelAndWait().
+
+    runSendLatency() connects a sender to a receiver over an in-memory NDI and
+    keeps it busy converting 4K video frames while the host sends audio. Each
+    audio block has to be sent within a few milliseconds, however long a video
+    frame takes to convert.
+*/
+class ContentionHarness
+{
+public:
+    //==============================================================================
+    struct ExecutorResult
+    {
+        int numWorkers{ 0 };
+        int numBusyQueues{ 0 };
+
+        int numAudioRuns{ 0 };
+        int numExpectedAudioRuns{ 0 };
+        // How much later than asked for the audio task ran.
+        double maxLateMsec{ 0.0 };
+        double meanLateMsec{ 0.0 };
+        int numBusyJobs{ 0 };
+        int numOrderedRuns{ 0 };
+        int numOutOfOrder{ 0 };
+        int numRunsAfterCancel{ 0 };
+
+        bool hasPassed(double lateLimitMsec) const;
+        juce::String toText() const;
+    };
+
+    struct SendLatencyResult
+    {
+        bool isConnected{ false };
+        int numBlocks{ 0 };
+        int numAudioSent{ 0 };
+        int numVideoFramesSent{ 0 };
+        // From the block being queued until the send task has sent it.
+        double maxAudioSendMsec{ 0.0 };
+        double medianAudioSendMsec{ 0.0 };
+        // Mostly video, audio converts are far shorter.
+        double maxConvertMsec{ 0.0 };
+        double meanConvertMsec{ 0.0 };
+
+        bool hasPassed(double audioSendLimitMsec) const;
+        juce::String toText() const;
+    };
+
+    //==============================================================================
+    static ExecutorResult runExecutor(int numBusyQueues, double seconds);
+    static SendLatencyResult runSendLatency(double seconds);
+};
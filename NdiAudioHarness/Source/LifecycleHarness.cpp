@@ -0,0 +1,289 @@
+/*
+  ==============================================================================
+
+    LifecycleHarness.cpp
+    Created: 20 Oct 2026 9:41:08am
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include "LifecycleHarness.h"
+#include "PluginsUnderTest.h"
+#include "NdiLoopbackBackend.h"
+#include "NdiRuntime.h"
+#include <algorithm>
+
+//==============================================================================
+namespace
+{
+    const double sampleRate = 48000.0;
+    const int blockSize = 512;
+    const int numBlocksPerLifecycle = 8;
+    const int connectTimeOutMsec = 2000;
+    // Longer than the sender's check for receivers, so every pair has audio flowing.
+    const int teardownTrafficMsec = 1500;
+
+    //==============================================================================
+    /** Counters shared by every lifecycle thread of a run. */
+    struct SharedCounters
+    {
+        std::atomic<int> numLifecycles{ 0 };
+        std::atomic<int> numConnected{ 0 };
+        std::atomic<int> numRuntimeMismatches{ 0 };
+        // -1 until the first holder has looked, then whether the runtime loaded.
+        std::atomic<int> runtimeAvailability{ -1 };
+    };
+
+    //==============================================================================
+    /** Goes through one sender and receiver after the other, as a host would when sessions are opened and closed. */
+    class LifecycleThread : public juce::Thread
+    {
+    public:
+        //==============================================================================
+        LifecycleThread(int index, int numIterations_, SharedCounters& counters_)
+            : juce::Thread("Harness Lifecycle " + juce::String(index + 1))
+            , numIterations(numIterations_)
+            , counters(counters_)
+            , random(index + 1)
+        {
+        }
+
+        ~LifecycleThread() override
+        {
+            stopThread(connectTimeOutMsec + 1000);
+        }
+
+        //==============================================================================
+        void run() override
+        {
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            juce::MidiBuffer midi_messages;
+
+            for (int iteration = 0; iteration < numIterations && !threadShouldExit(); ++iteration)
+            {
+                // Held like every NdiLibBackend holds it, other threads let go of theirs meanwhile.
+                juce::SharedResourcePointer<NdiRuntime> ndi_runtime;
+                const auto* p_ndi_lib = ndi_runtime->getLib();
+
+                const int is_available = p_ndi_lib != nullptr ? 1 : 0;
+                int expected = -1;
+                if (!counters.runtimeAvailability.compare_exchange_strong(expected, is_available) && expected != is_available)
+                    ++counters.numRuntimeMismatches;
+
+                auto sender = SenderUnderTest::create();
+                sender->setRateAndBufferSizeDetails(sampleRate, blockSize);
+                sender->prepareToPlay(sampleRate, blockSize);
+
+                auto receiver = ReceiverUnderTest::create();
+                receiver->setRateAndBufferSizeDetails(sampleRate, blockSize);
+                receiver->prepareToPlay(sampleRate, blockSize);
+
+                // Any source will do, it may belong to another thread and go away at any moment.
+                if (ReceiverUnderTest::connectToFirstSource(*receiver, connectTimeOutMsec))
+                    ++counters.numConnected;
+
+                // A few blocks through both, so their threads and tasks are busy when they are torn down.
+                for (int block_idx = 0; block_idx < numBlocksPerLifecycle; ++block_idx)
+                {
+                    buffer.clear();
+                    sender->processBlock(buffer, midi_messages);
+                    receiver->processBlock(buffer, midi_messages);
+                    juce::Thread::sleep(1 + random.nextInt(4));
+                }
+
+                receiver->releaseResources();
+                sender->releaseResources();
+
+                // Either order, like a host closing plugins in whatever order it likes.
+                if (random.nextBool())
+                {
+                    sender.reset();
+                    receiver.reset();
+                }
+                else
+                {
+                    receiver.reset();
+                    sender.reset();
+                }
+
+                if (ndi_runtime->getLib() != p_ndi_lib)
+                    ++counters.numRuntimeMismatches;
+
+                ++counters.numLifecycles;
+            }
+        }
+
+    private:
+        //==============================================================================
+        const int numIterations;
+        SharedCounters& counters;
+        juce::Random random;
+
+        //==============================================================================
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LifecycleThread)
+    };
+
+    //==============================================================================
+    template <typename Function>
+    double measureMsec(Function&& function)
+    {
+        const auto start_msec = juce::Time::getMillisecondCounterHiRes();
+        function();
+        return juce::Time::getMillisecondCounterHiRes() - start_msec;
+    }
+}
+
+//==============================================================================
+bool LifecycleHarness::ConcurrentResult::hasPassed() const
+{
+    return hasFinished && numLifecycles == numThreads * numIterations
+        && numConnected == numLifecycles && numLeakedHandles == 0 && numRuntimeMismatches == 0;
+}
+
+juce::String LifecycleHarness::ConcurrentResult::toText() const
+{
+    juce::String text;
+    text << "Lifecycles   " << numLifecycles << "/" << numThreads * numIterations << " on " << numThreads << " threads in "
+         << juce::String(seconds, 2) << " s" << (hasFinished ? "" : ", timed out") << "\n"
+         << "Connected    " << numConnected << "\n"
+         << "Leaked       " << numLeakedHandles << " loopback handles\n"
+         << "Runtime      " << (isRuntimeAvailable ? "loaded" : "not installed") << ", " << numRuntimeMismatches << " mismatches\n";
+    return text;
+}
+
+bool LifecycleHarness::TeardownResult::hasPassed(double stopLimitMsec) const
+{
+    return numConnected == numInstances && maxStopMsec <= stopLimitMsec && numLeakedHandles == 0;
+}
+
+juce::String LifecycleHarness::TeardownResult::toText() const
+{
+    juce::String text;
+    text << "Instances    " << numInstances << " senders and receivers, " << numConnected << " connected\n"
+         << "Stop         " << juce::String(maxStopMsec, 1) << " ms max, " << juce::String(medianStopMsec, 1) << " ms median\n"
+         << "Destroy      " << juce::String(maxDestroyMsec, 1) << " ms max, " << juce::String(totalDestroyMsec, 1) << " ms total\n"
+         << "Leaked       " << numLeakedHandles << " loopback handles\n";
+    return text;
+}
+
+//==============================================================================
+LifecycleHarness::ConcurrentResult LifecycleHarness::runConcurrent(int numThreads, int numIterations)
+{
+    ConcurrentResult result;
+    result.numThreads = numThreads;
+    result.numIterations = numIterations;
+
+    auto loopback = std::make_shared<NdiLoopbackBackend>();
+    NdiBackend::setDefault(loopback);
+
+    SharedCounters counters;
+    const auto start_ticks = juce::Time::getHighResolutionTicks();
+
+    {
+        juce::OwnedArray<LifecycleThread> threads;
+        for (int thread_idx = 0; thread_idx < numThreads; ++thread_idx)
+            threads.add(new LifecycleThread(thread_idx, numIterations, counters));
+
+        for (auto* thread : threads)
+            thread->startThread();
+
+        // Far more than a run needs, only a hang gets anywhere near it.
+        const int time_out_msec = 10000 + numIterations * connectTimeOutMsec;
+        result.hasFinished = true;
+        for (auto* thread : threads)
+            result.hasFinished = thread->waitForThreadToExit(time_out_msec) && result.hasFinished;
+    }
+
+    result.seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start_ticks);
+    result.numLifecycles = counters.numLifecycles;
+    result.numConnected = counters.numConnected;
+    result.numRuntimeMismatches = counters.numRuntimeMismatches;
+    result.isRuntimeAvailable = counters.runtimeAvailability.load() == 1;
+
+    // Every instance is gone, so are the shared discovery finder and everything else they held.
+    result.numLeakedHandles = loopback->getNumHandles();
+
+    NdiBackend::setDefault(nullptr);
+    return result;
+}
+
+LifecycleHarness::TeardownResult LifecycleHarness::runTeardown(int numInstances)
+{
+    TeardownResult result;
+    result.numInstances = numInstances;
+
+    auto loopback = std::make_shared<NdiLoopbackBackend>();
+    NdiBackend::setDefault(loopback);
+
+    {
+        std::vector<std::unique_ptr<juce::AudioProcessor>> senders;
+        std::vector<std::unique_ptr<juce::AudioProcessor>> receivers;
+        for (int instance_idx = 0; instance_idx < numInstances; ++instance_idx)
+        {
+            senders.push_back(SenderUnderTest::create());
+            senders.back()->setRateAndBufferSizeDetails(sampleRate, blockSize);
+            senders.back()->prepareToPlay(sampleRate, blockSize);
+
+            receivers.push_back(ReceiverUnderTest::create());
+            receivers.back()->setRateAndBufferSizeDetails(sampleRate, blockSize);
+            receivers.back()->prepareToPlay(sampleRate, blockSize);
+        }
+
+        // Every sender gets a receiver of its own, so every capture task is busy.
+        for (int instance_idx = 0; instance_idx < numInstances; ++instance_idx)
+        {
+            if (ReceiverUnderTest::connectToSource(*receivers[(size_t)instance_idx], instance_idx, connectTimeOutMsec))
+                ++result.numConnected;
+        }
+
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::MidiBuffer midi_messages;
+        const auto traffic_end_msec = juce::Time::getMillisecondCounter() + (juce::uint32)teardownTrafficMsec;
+        while (juce::Time::getMillisecondCounter() < traffic_end_msec)
+        {
+            for (int instance_idx = 0; instance_idx < numInstances; ++instance_idx)
+            {
+                buffer.clear();
+                senders[(size_t)instance_idx]->processBlock(buffer, midi_messages);
+                receivers[(size_t)instance_idx]->processBlock(buffer, midi_messages);
+            }
+            juce::Thread::sleep(1);
+        }
+
+        std::vector<double> stop_msecs;
+
+        // Half the receivers while their senders still send, then the senders, then the rest whose senders are gone.
+        for (int instance_idx = 0; instance_idx < numInstances; instance_idx += 2)
+            stop_msecs.push_back(measureMsec([&] { ReceiverUnderTest::stopReceiving(*receivers[(size_t)instance_idx]); }));
+
+        for (auto& sender : senders)
+            stop_msecs.push_back(measureMsec([&] { SenderUnderTest::stopSending(*sender); }));
+
+        for (int instance_idx = 1; instance_idx < numInstances; instance_idx += 2)
+            stop_msecs.push_back(measureMsec([&] { ReceiverUnderTest::stopReceiving(*receivers[(size_t)instance_idx]); }));
+
+        if (!stop_msecs.empty())
+        {
+            std::sort(stop_msecs.begin(), stop_msecs.end());
+            result.maxStopMsec = stop_msecs.back();
+            result.medianStopMsec = stop_msecs[stop_msecs.size() / 2];
+        }
+
+        for (auto* processors : { &receivers, &senders })
+        {
+            for (auto& processor : *processors)
+            {
+                processor->releaseResources();
+                const double destroy_msec = measureMsec([&] { processor.reset(); });
+                result.maxDestroyMsec = juce::jmax(result.maxDestroyMsec, destroy_msec);
+                result.totalDestroyMsec += destroy_msec;
+            }
+        }
+    }
+
+    result.numLeakedHandles = loopback->getNumHandles();
+
+    NdiBackend::setDefault(nullptr);
+    return result;
+}
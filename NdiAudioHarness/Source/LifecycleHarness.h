@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+    LifecycleHarness.h
+    Created: 20 Oct 2026 9:41:08am
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Creates and destroys plugin instances over an in-memory NDI, to check what
+    they share across the process.
+
+    runConcurrent() has several threads create, connect, run and destroy a
+    sender and a receiver over and over at the same time. Each instance holds
+    the shared NdiRuntime while it lives. At the end every loopback handle has
+    to be gone, and the runtime has to have stayed the same for each holder.
+
+    runTeardown() connects many senders and receivers in pairs and stops them
+    while audio flows, timing each stop. A stop has to be over within one
+    capture slice, or a host closing a large session hangs for their sum.
+*/
+class LifecycleHarness
+{
+public:
+    //==============================================================================
+    struct ConcurrentResult
+    {
+        int numThreads{ 0 };
+        int numIterations{ 0 };
+
+        int numLifecycles{ 0 };
+        int numConnected{ 0 };
+        bool hasFinished{ false };
+        // Finders, receivers and senders left in the loopback once every instance is gone.
+        int numLeakedHandles{ 0 };
+        // Whether the NDI runtime is installed, the refcounting is exercised either way.
+        bool isRuntimeAvailable{ false };
+        // A holder saw the function table change, or another holder saw a different availability.
+        int numRuntimeMismatches{ 0 };
+        double seconds{ 0.0 };
+
+        bool hasPassed() const;
+        juce::String toText() const;
+    };
+
+    struct TeardownResult
+    {
+        int numInstances{ 0 };
+
+        int numConnected{ 0 };
+        // Stopping a receiver or a sender, what the host waits for when closing it.
+        double maxStopMsec{ 0.0 };
+        double medianStopMsec{ 0.0 };
+        // Destroying the processors afterwards, including what they share.
+        double maxDestroyMsec{ 0.0 };
+        double totalDestroyMsec{ 0.0 };
+        int numLeakedHandles{ 0 };
+
+        bool hasPassed(double stopLimitMsec) const;
+        juce::String toText() const;
+    };
+
+    //==============================================================================
+    static ConcurrentResult runConcurrent(int numThreads, int numIterations);
+    static TeardownResult runTeardown(int numInstances);
+};
@@ -0,0 +1,282 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 19 Oct 2026 11:03:26pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <iostream>
+#include "AudioPipelineHarness.h"
+#include "ContentionHarness.h"
+#include "LifecycleHarness.h"
+#include "NdiTrace.h"
+
+//==============================================================================
+namespace
+{
+    void printUsage()
+    {
+        std::cout << "Usage: NdiAudioHarness [options]\n"
+                  << "  --block-sizes=32,64,...,4096    Host block sizes of the block size sweep\n"
+                  << "  --filter=<text>                 Only run scenarios whose name contains the text\n"
+                  << "  --seconds=<seconds>             Measured time per scenario (default 3)\n"
+                  << "  --seed=<number>                 Seed for the simulated jitter (default 1)\n"
+                  << "  --label=<text>                  Label stored in the results, e.g. a commit id\n"
+                  << "  --json=<file>                   Write the results as JSON, '-' for stdout\n"
+                  << "  --csv=<file>                    Write the results as CSV, '-' for stdout\n"
+                  << "  --trace=<file>                  Write the last zones of each thread as Chrome trace JSON\n"
+                  << "                                  (needs a build with NDI_TRACE_ENABLED=1)\n"
+                  << "  --replay=<file>                 Play a recording made by the receiver into it instead of the\n"
+                  << "                                  scenarios, once per block size given with --block-sizes\n"
+                  << "  --replay-fast                   Replay the recording as fast as the receiver takes it\n"
+                  << "  --max-underrun-fades=<count>    Fail if a scenario has more underrun fades\n"
+                  << "  --max-latency-ms=<msec>         Fail if a scenario has a higher latency\n"
+                  << "  --lifecycles[=<threads>]        Create, connect and destroy senders and receivers on several\n"
+                  << "                                  threads at once instead of the scenarios (default 8 threads)\n"
+                  << "  --iterations=<count>            Instances each --lifecycles thread goes through (default 25)\n"
+                  << "  --teardown[=<count>]            Connect that many senders and receivers in pairs and time\n"
+                  << "                                  stopping each one instead of the scenarios (default 50)\n"
+                  << "  --max-stop-ms=<msec>            Fail if stopping any --teardown instance takes longer (default 50)\n"
+                  << "  --contention[=<queues>]         Keep that many executor queues busy with long jobs and time an\n"
+                  << "                                  audio lane task, then time audio sends while a sender converts\n"
+                  << "                                  4K video, instead of the scenarios (default 2 queues per CPU)\n"
+                  << "  --max-late-ms=<msec>            Fail if the --contention audio task runs later than that (default 5)\n"
+                  << "  --max-audio-send-ms=<msec>      Fail if sending a --contention audio block takes longer (default 5)\n";
+    }
+
+    std::vector<AudioPipelineHarness::Scenario> createScenarios(const juce::StringArray& blockSizes)
+    {
+        std::vector<AudioPipelineHarness::Scenario> scenarios;
+
+        // Host block sizes, at the same rate on both sides.
+        for (const auto& block_size : blockSizes)
+        {
+            AudioPipelineHarness::Scenario scenario;
+            scenario.blockSize = block_size.getIntValue();
+            scenarios.push_back(scenario);
+        }
+
+        // Sample rate conversion in the receiver.
+        const double rate_pairs[][2] = {
+            { 44100.0, 48000.0 }, { 48000.0, 44100.0 },
+            { 48000.0, 96000.0 }, { 96000.0, 48000.0 },
+            { 44100.0, 96000.0 }, { 96000.0, 44100.0 },
+        };
+        for (const auto& rate_pair : rate_pairs)
+        {
+            AudioPipelineHarness::Scenario scenario;
+            scenario.senderSampleRate = rate_pair[0];
+            scenario.receiverSampleRate = rate_pair[1];
+            scenarios.push_back(scenario);
+        }
+
+        // Network jitter and clock drift between the two machines.
+        for (const int jitter_msec : { 5, 20 })
+        {
+            AudioPipelineHarness::Scenario scenario;
+            scenario.jitterMsec = jitter_msec;
+            scenarios.push_back(scenario);
+        }
+        for (const double drift_ppm : { 200.0, -200.0 })
+        {
+            AudioPipelineHarness::Scenario scenario;
+            scenario.clockDriftPpm = drift_ppm;
+            scenarios.push_back(scenario);
+        }
+
+        return scenarios;
+    }
+
+    bool writeOutput(const juce::String& path, const juce::String& text)
+    {
+        if (path == "-")
+        {
+            std::cout << text << std::endl;
+            return true;
+        }
+
+        return juce::File::getCurrentWorkingDirectory().getChildFile(path).replaceWithText(text);
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    // Checks the instances share the process safely, there is no audio to measure.
+    if (args.containsOption("--lifecycles"))
+    {
+        const auto thread_count = args.getValueForOption("--lifecycles");
+        const int num_threads = thread_count.isNotEmpty() ? juce::jmax(1, thread_count.getIntValue()) : 8;
+        const int num_iterations = args.containsOption("--iterations") ? juce::jmax(1, args.getValueForOption("--iterations").getIntValue()) : 25;
+
+        const auto result = LifecycleHarness::runConcurrent(num_threads, num_iterations);
+        std::cout << result.toText();
+
+        if (!result.hasPassed())
+        {
+            std::cerr << "FAILED: lifecycles" << std::endl;
+            return 2;
+        }
+        return 0;
+    }
+
+    // Checks closing a large session does not hang the host.
+    if (args.containsOption("--teardown"))
+    {
+        const auto instance_count = args.getValueForOption("--teardown");
+        const int num_instances = instance_count.isNotEmpty() ? juce::jmax(1, instance_count.getIntValue()) : 50;
+        const double max_stop_msec = args.containsOption("--max-stop-ms") ? args.getValueForOption("--max-stop-ms").getDoubleValue() : 50.0;
+
+        const auto result = LifecycleHarness::runTeardown(num_instances);
+        std::cout << result.toText();
+
+        if (!result.hasPassed(max_stop_msec))
+        {
+            std::cerr << "FAILED: teardown" << std::endl;
+            return 2;
+        }
+        return 0;
+    }
+
+    // Checks long jobs on the shared executor do not hold up audio work.
+    if (args.containsOption("--contention"))
+    {
+        const auto queue_count = args.getValueForOption("--contention");
+        const int num_busy_queues = queue_count.isNotEmpty() ? juce::jmax(1, queue_count.getIntValue()) : 2 * juce::SystemStats::getNumCpus();
+        const double seconds = args.containsOption("--seconds") ? juce::jmax(1.0, args.getValueForOption("--seconds").getDoubleValue()) : 3.0;
+        const double max_late_msec = args.containsOption("--max-late-ms") ? args.getValueForOption("--max-late-ms").getDoubleValue() : 5.0;
+        const double max_audio_send_msec = args.containsOption("--max-audio-send-ms") ? args.getValueForOption("--max-audio-send-ms").getDoubleValue() : 5.0;
+
+        const auto executor_result = ContentionHarness::runExecutor(num_busy_queues, seconds);
+        std::cout << executor_result.toText();
+
+        const auto send_result = ContentionHarness::runSendLatency(seconds);
+        std::cout << send_result.toText();
+
+        if (!executor_result.hasPassed(max_late_msec) || !send_result.hasPassed(max_audio_send_msec))
+        {
+            std::cerr << "FAILED: contention" << std::endl;
+            return 2;
+        }
+        return 0;
+    }
+
+    AudioPipelineHarness::Options options;
+    if (args.containsOption("--seconds"))
+        options.measureSeconds = juce::jmax(1.0, args.getValueForOption("--seconds").getDoubleValue());
+    if (args.containsOption("--seed"))
+        options.randomSeed = args.getValueForOption("--seed").getLargeIntValue();
+
+    juce::StringArray block_sizes;
+    block_sizes.addTokens(args.containsOption("--block-sizes") ? args.getValueForOption("--block-sizes") : "32,64,128,256,512,1024,2048,4096", ",", "");
+    block_sizes.trim();
+    block_sizes.removeEmptyStrings();
+
+    const auto filter = args.getValueForOption("--filter");
+    const auto json_path = args.getValueForOption("--json");
+    const auto csv_path = args.getValueForOption("--csv");
+    const bool is_quiet = json_path == "-" || csv_path == "-";
+
+    AudioPipelineHarness harness(options);
+    std::vector<AudioPipelineHarness::Result> results;
+
+    if (args.containsOption("--replay"))
+    {
+        const auto replay_file = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--replay"));
+        if (!args.containsOption("--block-sizes"))
+            block_sizes = juce::StringArray("512");
+
+        for (const auto& block_size : block_sizes)
+        {
+            AudioPipelineHarness::Scenario scenario;
+            scenario.blockSize = block_size.getIntValue();
+            if (scenario.blockSize < 32 || scenario.blockSize > 4096)
+                continue;
+
+            if (!is_quiet)
+                std::cout << "Replaying " << replay_file.getFileName() << " at " << scenario.blockSize << "..." << std::endl;
+
+            results.push_back(harness.runReplay(replay_file, scenario, args.containsOption("--replay-fast")));
+        }
+    }
+    else
+    {
+        for (const auto& scenario : createScenarios(block_sizes))
+        {
+            if (scenario.blockSize < 32 || scenario.blockSize > 4096)
+                continue;
+            if (filter.isNotEmpty() && !scenario.getName().containsIgnoreCase(filter))
+                continue;
+
+            if (!is_quiet)
+                std::cout << "Running " << scenario.getName() << "..." << std::endl;
+
+            results.push_back(harness.run(scenario));
+        }
+    }
+
+    if (results.empty())
+    {
+        std::cerr << "Nothing to run, see --help" << std::endl;
+        return 1;
+    }
+
+    if (!is_quiet)
+    {
+        std::cout << std::endl << AudioPipelineHarness::toTable(results);
+
+        // A replay has no latency to show, what the pipeline did is the result.
+        if (args.containsOption("--replay"))
+        {
+            for (const auto& result : results)
+                std::cout << std::endl << result.scenario.getName() << std::endl << result.pipelineStats.joinIntoString("\n") << std::endl;
+        }
+    }
+
+    bool is_written = true;
+    if (json_path.isNotEmpty())
+        is_written = writeOutput(json_path, harness.toJson(results, args.getValueForOption("--label"))) && is_written;
+    if (csv_path.isNotEmpty())
+        is_written = writeOutput(csv_path, AudioPipelineHarness::toCsv(results)) && is_written;
+
+    if (args.containsOption("--trace"))
+    {
+        if (!NdiTrace::isEnabled())
+            std::cerr << "Tracing is compiled out, rebuild with NDI_TRACE_ENABLED=1 for --trace" << std::endl;
+        else
+            is_written = NdiTrace::writeChromeTrace(juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--trace"))) && is_written;
+    }
+
+    if (!is_written)
+        return 1;
+
+    // Release gates, any scenario over a limit fails the run.
+    bool has_passed = true;
+    for (const auto& result : results)
+    {
+        const bool is_over_fades = args.containsOption("--max-underrun-fades")
+            && result.numUnderrunFades > args.getValueForOption("--max-underrun-fades").getIntValue();
+        const bool is_over_latency = args.containsOption("--max-latency-ms")
+            && result.maxLatencyMsec > args.getValueForOption("--max-latency-ms").getDoubleValue();
+
+        if (!result.isConnected || result.numPulsesFound < result.numPulsesSent || is_over_fades || is_over_latency)
+        {
+            std::cerr << "FAILED: " << result.scenario.getName() << std::endl;
+            has_passed = false;
+        }
+    }
+
+    return has_passed ? 0 : 2;
+}
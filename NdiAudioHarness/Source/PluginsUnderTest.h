@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    PluginsUnderTest.h
+    Created: 19 Oct 2026 11:03:26pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "NdiPipelineStats.h"
+
+//==============================================================================
+/**
+    The plugin processors exactly as they ship, built into the harness.
+
+    Both plugins have classes with the same names, so each one is compiled in
+    its own translation unit and namespace, and only reached through these.
+    They use NdiBackend::getDefault(), install the backend before creating them.
+*/
+class SenderUnderTest
+{
+public:
+    static std::unique_ptr<juce::AudioProcessor> create();
+
+    /** Stops sending the way the plugin does when it goes away. */
+    static void stopSending(juce::AudioProcessor& sender);
+
+    /** Queues a frame the way the editor does with a camera image. Returns false if the queue is full. */
+    static bool pushVideoFrame(juce::AudioProcessor& sender, const juce::Image& image);
+
+    static NdiPipelineStats& getPipelineStats(juce::AudioProcessor& sender);
+};
+
+class ReceiverUnderTest
+{
+public:
+    static std::unique_ptr<juce::AudioProcessor> create();
+
+    /** Connects to the first source found through NDI, never through a local transport.
+        Returns false if no source shows up within the time out.
+    */
+    static bool connectToFirstSource(juce::AudioProcessor& receiver, int timeOutMsec);
+
+    /** Like connectToFirstSource(), to the source at the index once that many have been found. */
+    static bool connectToSource(juce::AudioProcessor& receiver, int sourceIndex, int timeOutMsec);
+
+    /** Stops receiving and disconnects the way the plugin does when it goes away. */
+    static void stopReceiving(juce::AudioProcessor& receiver);
+
+    static int getNumUnderrunFades(juce::AudioProcessor& receiver);
+
+    /** The latency the receiver reports to the host, to compare with the measured one. */
+    static int getReportedLatencySamples(juce::AudioProcessor& receiver);
+
+    /** The receiver's pipeline counters, one line each, see NdiPipelineStats. */
+    static juce::StringArray getPipelineStats(juce::AudioProcessor& receiver);
+};
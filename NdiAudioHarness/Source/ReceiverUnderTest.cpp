@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+    ReceiverUnderTest.cpp
+    Created: 19 Oct 2026 11:03:26pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <Processing.NDI.Lib.h>
+#include "NdiBackend.h"
+#include "NdiSharedMemoryTransport.h"
+#include "NdiInProcessRouter.h"
+#include "NdiPipelineStats.h"
+#include "NdiRecordingFormat.h"
+#include "NdiStatsOverlay.h"
+#include "NdiThreadPolicy.h"
+#include "NdiExecutor.h"
+#include "NdiChannelRouter.h"
+#include "NdiTrace.h"
+#include "NdiUnderrunConcealer.h"
+#include "NdiDriftCorrector.h"
+#include "RingBuffer.h"
+#include "NdiVideoHelper.h"
+#include "NdiAudioHelper.h"
+#include "PluginsUnderTest.h"
+
+#define JucePlugin_Name "NdiReceiver"
+
+// See SenderUnderTest.cpp, the receiver gets its own namespace.
+namespace receiver
+{
+    #include "../../NdiReceiver/Source/NdiRecorder.cpp"
+    #include "../../NdiReceiver/Source/NdiWrapper.cpp"
+    #include "../../NdiReceiver/Source/NdiDiscoveryService.cpp"
+    #include "../../NdiReceiver/Source/NdiMosaic.cpp"
+    #include "../../NdiReceiver/Source/NdiMultiReceiver.cpp"
+    #include "../../NdiReceiver/Source/PluginProcessor.cpp"
+    #include "../../NdiReceiver/Source/PluginEditor.cpp"
+}
+
+//==============================================================================
+std::unique_ptr<juce::AudioProcessor> ReceiverUnderTest::create()
+{
+    return std::make_unique<receiver::NdiReceiverAudioProcessor>();
+}
+
+bool ReceiverUnderTest::connectToFirstSource(juce::AudioProcessor& processor, int timeOutMsec)
+{
+    return connectToSource(processor, 0, timeOutMsec);
+}
+
+bool ReceiverUnderTest::connectToSource(juce::AudioProcessor& processor, int sourceIndex, int timeOutMsec)
+{
+    auto& ndi_engine = dynamic_cast<receiver::NdiReceiverAudioProcessor&>(processor).getNdiEngine();
+    ndi_engine.setPreferLocalTransport(false);
+
+    const auto deadline_msec = juce::Time::getMillisecondCounter() + (juce::uint32)timeOutMsec;
+    while (juce::Time::getMillisecondCounter() < deadline_msec)
+    {
+        const auto sources = ndi_engine.find();
+        if (sourceIndex < sources.size())
+        {
+            ndi_engine.connect(sources.getReference(sourceIndex));
+            ndi_engine.startReceive();
+            return true;
+        }
+
+        juce::Thread::sleep(10);
+    }
+
+    return false;
+}
+
+void ReceiverUnderTest::stopReceiving(juce::AudioProcessor& processor)
+{
+    auto& ndi_engine = dynamic_cast<receiver::NdiReceiverAudioProcessor&>(processor).getNdiEngine();
+    ndi_engine.stopReceive();
+    ndi_engine.disconnect();
+}
+
+int ReceiverUnderTest::getNumUnderrunFades(juce::AudioProcessor& processor)
+{
+    return dynamic_cast<receiver::NdiReceiverAudioProcessor&>(processor).getNumUnderrunFades();
+}
+
+int ReceiverUnderTest::getReportedLatencySamples(juce::AudioProcessor& processor)
+{
+    return dynamic_cast<receiver::NdiReceiverAudioProcessor&>(processor).getReportedLatencySamples();
+}
+
+juce::StringArray ReceiverUnderTest::getPipelineStats(juce::AudioProcessor& processor)
+{
+    return dynamic_cast<receiver::NdiReceiverAudioProcessor&>(processor).getNdiEngine().stats.toText();
+}
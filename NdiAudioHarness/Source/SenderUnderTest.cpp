@@ -0,0 +1,58 @@
+/*
+  ==============================================================================
+
+    SenderUnderTest.cpp
+    Created: 19 Oct 2026 11:03:26pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <Processing.NDI.Lib.h>
+#include "NdiBackend.h"
+#include "NdiSharedMemoryTransport.h"
+#include "NdiInProcessRouter.h"
+#include "NdiPipelineStats.h"
+#include "NdiStatsOverlay.h"
+#include "NdiThreadPolicy.h"
+#include "NdiExecutor.h"
+#include "NdiTrace.h"
+#include "RingBuffer.h"
+#include "NdiVideoHelper.h"
+#include "NdiAudioHelper.h"
+#include "PluginsUnderTest.h"
+
+#define JucePlugin_Name "NdiSender"
+
+// The shared headers above stay global, everything of the sender goes into its own namespace.
+namespace sender
+{
+    #include "../../NdiSender/Source/NdiSendWrapper.cpp"
+    #include "../../NdiSender/Source/PluginProcessor.cpp"
+    #include "../../NdiSender/Source/PluginEditor.cpp"
+}
+
+//==============================================================================
+std::unique_ptr<juce::AudioProcessor> SenderUnderTest::create()
+{
+    return std::make_unique<sender::NdiSenderAudioProcessor>();
+}
+
+void SenderUnderTest::stopSending(juce::AudioProcessor& processor)
+{
+    dynamic_cast<sender::NdiSenderAudioProcessor&>(processor).getNdiEngine().stopSend();
+}
+
+bool SenderUnderTest::pushVideoFrame(juce::AudioProcessor& processor, const juce::Image& image)
+{
+    auto& engine = dynamic_cast<sender::NdiSenderAudioProcessor&>(processor).getNdiEngine();
+    const bool is_queued = engine.videoCache.push(image) != 0;
+    engine.notifyVideoQueued();
+    return is_queued;
+}
+
+NdiPipelineStats& SenderUnderTest::getPipelineStats(juce::AudioProcessor& processor)
+{
+    return dynamic_cast<sender::NdiSenderAudioProcessor&>(processor).getNdiEngine().stats;
+}
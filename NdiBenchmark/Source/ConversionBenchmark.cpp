@@ -0,0 +1,137 @@
+/*
+  ==============================================================================
+
+    ConversionBenchmark.cpp
+    Created: 19 Oct 2026 10:12:48pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include "ConversionBenchmark.h"
+#include <algorithm>
+
+//==============================================================================
+ConversionBenchmark::ConversionBenchmark(const Options& options_)
+    : options(options_)
+{
+}
+
+ConversionBenchmark::Result ConversionBenchmark::run(const ConversionCase& conversionCase) const
+{
+    conversionCase.convertOneFrame();
+
+    std::vector<double> frame_times_msec;
+    frame_times_msec.reserve((size_t)options.maxFrames);
+
+    double total_msec = 0.0;
+    while ((int)frame_times_msec.size() < options.maxFrames
+        && ((int)frame_times_msec.size() < options.minFrames || total_msec < options.minTimeMsec))
+    {
+        const auto start_ticks = juce::Time::getHighResolutionTicks();
+        conversionCase.convertOneFrame();
+        const auto end_ticks = juce::Time::getHighResolutionTicks();
+
+        const double frame_msec = juce::Time::highResolutionTicksToSeconds(end_ticks - start_ticks) * 1000.0;
+        frame_times_msec.push_back(frame_msec);
+        total_msec += frame_msec;
+    }
+
+    std::sort(frame_times_msec.begin(), frame_times_msec.end());
+
+    Result result;
+    result.direction = conversionCase.direction;
+    result.fourCC = conversionCase.fourCC;
+    result.width = conversionCase.width;
+    result.height = conversionCase.height;
+    result.numFrames = (int)frame_times_msec.size();
+    result.medianFrameMsec = frame_times_msec[frame_times_msec.size() / 2];
+    result.minFrameMsec = frame_times_msec.front();
+
+    const double frame_seconds = juce::jmax(result.medianFrameMsec / 1000.0, 1.0e-9);
+    const double num_pixels = (double)conversionCase.width * (double)conversionCase.height;
+    const double num_bytes = (double)(conversionCase.inputBytesPerFrame + conversionCase.outputBytesPerFrame);
+
+    result.nanosecondsPerPixel = frame_seconds * 1.0e9 / num_pixels;
+    result.gigabytesPerSecond = num_bytes / frame_seconds / 1.0e9;
+    result.framesPerSecond = 1.0 / frame_seconds;
+    result.budgetUsage = frame_seconds * options.targetFramesPerSecond;
+
+    return result;
+}
+
+//==============================================================================
+juce::String ConversionBenchmark::toJson(const std::vector<Result>& results, const juce::String& label) const
+{
+    juce::Array<juce::var> result_list;
+    for (const auto& result : results)
+    {
+        auto* entry = new juce::DynamicObject();
+        entry->setProperty("direction", result.direction);
+        entry->setProperty("fourcc", result.fourCC);
+        entry->setProperty("width", result.width);
+        entry->setProperty("height", result.height);
+        entry->setProperty("frames", result.numFrames);
+        entry->setProperty("median_frame_ms", result.medianFrameMsec);
+        entry->setProperty("min_frame_ms", result.minFrameMsec);
+        entry->setProperty("ns_per_pixel", result.nanosecondsPerPixel);
+        entry->setProperty("gb_per_second", result.gigabytesPerSecond);
+        entry->setProperty("fps", result.framesPerSecond);
+        entry->setProperty("budget_usage", result.budgetUsage);
+        entry->setProperty("realtime", result.budgetUsage <= 1.0);
+        result_list.add(juce::var(entry));
+    }
+
+    auto* machine = new juce::DynamicObject();
+    machine->setProperty("os", juce::SystemStats::getOperatingSystemName());
+    machine->setProperty("cpu_vendor", juce::SystemStats::getCpuVendor());
+    machine->setProperty("cpu_mhz", juce::SystemStats::getCpuSpeedInMegahertz());
+    machine->setProperty("num_cpus", juce::SystemStats::getNumCpus());
+
+    auto* root = new juce::DynamicObject();
+    root->setProperty("benchmark", "video-conversion");
+    root->setProperty("label", label);
+    root->setProperty("time", juce::Time::getCurrentTime().toISO8601(true));
+    root->setProperty("target_fps", options.targetFramesPerSecond);
+    root->setProperty("min_time_ms", options.minTimeMsec);
+    root->setProperty("machine", juce::var(machine));
+    root->setProperty("results", result_list);
+
+    return juce::JSON::toString(juce::var(root));
+}
+
+juce::String ConversionBenchmark::toCsv(const std::vector<Result>& results)
+{
+    juce::String csv("direction,fourcc,width,height,frames,median_frame_ms,min_frame_ms,ns_per_pixel,gb_per_second,fps,budget_usage\n");
+    for (const auto& result : results)
+    {
+        csv << result.direction << "," << result.fourCC << ","
+            << result.width << "," << result.height << "," << result.numFrames << ","
+            << juce::String(result.medianFrameMsec, 4) << "," << juce::String(result.minFrameMsec, 4) << ","
+            << juce::String(result.nanosecondsPerPixel, 4) << "," << juce::String(result.gigabytesPerSecond, 4) << ","
+            << juce::String(result.framesPerSecond, 2) << "," << juce::String(result.budgetUsage, 4) << "\n";
+    }
+    return csv;
+}
+
+juce::String ConversionBenchmark::toTable(const std::vector<Result>& results)
+{
+    juce::String table;
+    table << juce::String("direction").paddedRight(' ', 10) << juce::String("fourcc").paddedRight(' ', 8)
+          << juce::String("size").paddedRight(' ', 11)
+          << juce::String("ns/px").paddedLeft(' ', 9) << juce::String("GB/s").paddedLeft(' ', 9)
+          << juce::String("fps").paddedLeft(' ', 10) << juce::String("budget").paddedLeft(' ', 9) << "\n";
+
+    for (const auto& result : results)
+    {
+        const juce::String size = juce::String(result.width) + "x" + juce::String(result.height);
+        const juce::String budget = juce::String(result.budgetUsage * 100.0, 1) + "%" + (result.budgetUsage > 1.0 ? "!" : " ");
+
+        table << result.direction.paddedRight(' ', 10) << result.fourCC.paddedRight(' ', 8) << size.paddedRight(' ', 11)
+              << juce::String(result.nanosecondsPerPixel, 2).paddedLeft(' ', 9)
+              << juce::String(result.gigabytesPerSecond, 3).paddedLeft(' ', 9)
+              << juce::String(result.framesPerSecond, 1).paddedLeft(' ', 10)
+              << budget.paddedLeft(' ', 9) << "\n";
+    }
+    return table;
+}
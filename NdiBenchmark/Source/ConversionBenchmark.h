@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    ConversionBenchmark.h
+    Created: 19 Oct 2026 10:12:48pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <functional>
+#include <vector>
+
+//==============================================================================
+/**
+    One video conversion to time, e.g. a receive FourCC at 1080p.
+
+    The case owns its source frame and converts it once per call, so the
+    timing covers exactly what the plugins do for every frame.
+*/
+struct ConversionCase
+{
+    juce::String direction;     // "receive" or "send"
+    juce::String fourCC;
+    int width{ 0 };
+    int height{ 0 };
+
+    size_t inputBytesPerFrame{ 0 };
+    size_t outputBytesPerFrame{ 0 };
+
+    std::function<void()> convertOneFrame;
+};
+
+/** The fields of the plugins' video frames that NdiVideoHelper reads and writes. */
+struct BenchmarkVideoFrame
+{
+    int xres{ 0 }, yres{ 0 };
+    int frame_rate_N{ 0 }, frame_rate_D{ 1 };
+    const char* p_metadata{ nullptr };
+    juce::int64 timecode{ 0 };
+    juce::int64 timestamp{ 0 };
+
+    juce::Image image;
+};
+
+//==============================================================================
+/** Adds a case for every FourCC the receiver converts from NDI into an image. */
+class ReceiveConversions
+{
+public:
+    static void addCases(std::vector<ConversionCase>& cases, int width, int height);
+};
+
+/** Adds a case for every format the sender converts an image into for NDI. */
+class SendConversions
+{
+public:
+    static void addCases(std::vector<ConversionCase>& cases, int width, int height);
+};
+
+//==============================================================================
+/**
+    Times conversion cases and reports them against a real-time frame budget.
+
+    Every case is converted once to warm up, then repeatedly until both the
+    minimum time and the minimum number of frames are reached. The median frame
+    time is reported, the fastest one is kept alongside it.
+*/
+class ConversionBenchmark
+{
+public:
+    //==============================================================================
+    struct Options
+    {
+        double minTimeMsec{ 1000.0 };
+        int minFrames{ 5 };
+        int maxFrames{ 1000 };
+        double targetFramesPerSecond{ 60.0 };
+    };
+
+    struct Result
+    {
+        juce::String direction;
+        juce::String fourCC;
+        int width{ 0 };
+        int height{ 0 };
+        int numFrames{ 0 };
+
+        double medianFrameMsec{ 0.0 };
+        double minFrameMsec{ 0.0 };
+        double nanosecondsPerPixel{ 0.0 };
+        double gigabytesPerSecond{ 0.0 };     // input plus output bytes
+        double framesPerSecond{ 0.0 };
+        double budgetUsage{ 0.0 };            // median frame time over the frame budget, 1.0 is the limit
+    };
+
+    //==============================================================================
+    explicit ConversionBenchmark(const Options& options);
+
+    Result run(const ConversionCase& conversionCase) const;
+
+    //==============================================================================
+    juce::String toJson(const std::vector<Result>& results, const juce::String& label) const;
+    static juce::String toCsv(const std::vector<Result>& results);
+    static juce::String toTable(const std::vector<Result>& results);
+
+private:
+    //==============================================================================
+    const Options options;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ConversionBenchmark)
+};
@@ -0,0 +1,128 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 19 Oct 2026 10:12:48pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <iostream>
+#include "ConversionBenchmark.h"
+
+//==============================================================================
+namespace
+{
+    struct Resolution
+    {
+        const char* name;
+        int width;
+        int height;
+    };
+
+    const Resolution resolutions[] =
+    {
+        { "720p", 1280, 720 },
+        { "1080p", 1920, 1080 },
+        { "2160p", 3840, 2160 },
+    };
+
+    void printUsage()
+    {
+        std::cout << "Usage: NdiBenchmark [options]\n"
+                  << "  --resolutions=720p,1080p,2160p  Resolutions to run\n"
+                  << "  --filter=<text>                 Only run cases whose \"direction fourcc\" contains the text\n"
+                  << "  --fps=<rate>                    Real-time budget in frames per second (default 60)\n"
+                  << "  --min-time=<msec>               Minimum time per case (default 1000)\n"
+                  << "  --min-frames=<count>            Minimum frames per case (default 5)\n"
+                  << "  --label=<text>                  Label stored in the results, e.g. a commit id\n"
+                  << "  --json=<file>                   Write the results as JSON, '-' for stdout\n"
+                  << "  --csv=<file>                    Write the results as CSV, '-' for stdout\n";
+    }
+
+    bool writeOutput(const juce::String& path, const juce::String& text)
+    {
+        if (path == "-")
+        {
+            std::cout << text << std::endl;
+            return true;
+        }
+
+        return juce::File::getCurrentWorkingDirectory().getChildFile(path).replaceWithText(text);
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    ConversionBenchmark::Options options;
+    if (args.containsOption("--fps"))
+        options.targetFramesPerSecond = juce::jmax(1.0, args.getValueForOption("--fps").getDoubleValue());
+    if (args.containsOption("--min-time"))
+        options.minTimeMsec = juce::jmax(0.0, args.getValueForOption("--min-time").getDoubleValue());
+    if (args.containsOption("--min-frames"))
+        options.minFrames = juce::jlimit(1, options.maxFrames, args.getValueForOption("--min-frames").getIntValue());
+
+    juce::StringArray resolution_names;
+    resolution_names.addTokens(args.containsOption("--resolutions") ? args.getValueForOption("--resolutions") : "720p,1080p,2160p", ",", "");
+    resolution_names.trim();
+    resolution_names.removeEmptyStrings();
+
+    const auto filter = args.getValueForOption("--filter");
+    const auto json_path = args.getValueForOption("--json");
+    const auto csv_path = args.getValueForOption("--csv");
+    const bool is_quiet = json_path == "-" || csv_path == "-";
+
+    ConversionBenchmark benchmark(options);
+    std::vector<ConversionBenchmark::Result> results;
+
+    for (const auto& resolution : resolutions)
+    {
+        if (!resolution_names.contains(resolution.name, true))
+            continue;
+
+        // The cases own their frames, so only one resolution is allocated at a time.
+        std::vector<ConversionCase> cases;
+        ReceiveConversions::addCases(cases, resolution.width, resolution.height);
+        SendConversions::addCases(cases, resolution.width, resolution.height);
+
+        for (const auto& conversion_case : cases)
+        {
+            if (filter.isNotEmpty() && !(conversion_case.direction + " " + conversion_case.fourCC).containsIgnoreCase(filter))
+                continue;
+
+            if (!is_quiet)
+                std::cout << "Running " << conversion_case.direction << " " << conversion_case.fourCC << " "
+                          << resolution.name << "..." << std::endl;
+
+            results.push_back(benchmark.run(conversion_case));
+        }
+    }
+
+    if (results.empty())
+    {
+        std::cerr << "Nothing to run, see --help" << std::endl;
+        return 1;
+    }
+
+    if (!is_quiet)
+        std::cout << std::endl << ConversionBenchmark::toTable(results);
+
+    bool is_written = true;
+    if (json_path.isNotEmpty())
+        is_written = writeOutput(json_path, benchmark.toJson(results, args.getValueForOption("--label"))) && is_written;
+    if (csv_path.isNotEmpty())
+        is_written = writeOutput(csv_path, ConversionBenchmark::toCsv(results)) && is_written;
+
+    return is_written ? 0 : 1;
+}
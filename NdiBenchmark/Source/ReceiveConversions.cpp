@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    ReceiveConversions.cpp
+    Created: 19 Oct 2026 10:12:48pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <Processing.NDI.Lib.h>
+#include <atomic>
+#include <memory>
+#include "ConversionBenchmark.h"
+#include "NdiVideoHelper.h"
+
+//==============================================================================
+namespace
+{
+    struct ReceiveFormat
+    {
+        const char* name;
+        NDIlib_FourCC_video_type_e fourCC;
+        int bytesPerPixelTimesTwo;
+    };
+
+    // Sizes as NDI delivers them, UYVA is a UYVY plane followed by an alpha plane.
+    const ReceiveFormat receiveFormats[] =
+    {
+        { "RGBA", NDIlib_FourCC_type_RGBA, 8 },
+        { "RGBX", NDIlib_FourCC_type_RGBX, 8 },
+        { "BGRA", NDIlib_FourCC_type_BGRA, 8 },
+        { "BGRX", NDIlib_FourCC_type_BGRX, 8 },
+        { "UYVY", NDIlib_FourCC_type_UYVY, 4 },
+        { "UYVA", NDIlib_FourCC_video_type_UYVA, 6 },
+    };
+
+    struct ReceiveState
+    {
+        juce::HeapBlock<uint8_t> data;
+        NDIlib_video_frame_v2_t srcFrame;
+        BenchmarkVideoFrame videoFrame;
+    };
+}
+
+//==============================================================================
+void ReceiveConversions::addCases(std::vector<ConversionCase>& cases, int width, int height)
+{
+    for (const auto& format : receiveFormats)
+    {
+        const size_t data_size = (size_t)width * (size_t)height * (size_t)format.bytesPerPixelTimesTwo / 2;
+
+        auto state = std::make_shared<ReceiveState>();
+        state->data.malloc(data_size);
+
+        juce::Random random(0x4e4449);
+        for (size_t i = 0; i < data_size; ++i)
+            state->data[i] = (uint8_t)random.nextInt(256);
+
+        state->srcFrame.xres = width;
+        state->srcFrame.yres = height;
+        state->srcFrame.FourCC = format.fourCC;
+        state->srcFrame.frame_rate_N = 60000;
+        state->srcFrame.frame_rate_D = 1001;
+        state->srcFrame.picture_aspect_ratio = (float)width / (float)height;
+        state->srcFrame.frame_format_type = NDIlib_frame_format_type_progressive;
+        state->srcFrame.line_stride_in_bytes = width * (format.fourCC == NDIlib_FourCC_type_UYVY || format.fourCC == NDIlib_FourCC_video_type_UYVA ? 2 : 4);
+        state->srcFrame.p_data = state->data.get();
+
+        ConversionCase conversion_case;
+        conversion_case.direction = "receive";
+        conversion_case.fourCC = format.name;
+        conversion_case.width = width;
+        conversion_case.height = height;
+        conversion_case.inputBytesPerFrame = data_size;
+        conversion_case.outputBytesPerFrame = (size_t)width * (size_t)height * 4;
+        conversion_case.convertOneFrame = [state]()
+        {
+            NdiVideoHelper::convertVideoFrame(state->videoFrame, state->srcFrame);
+        };
+        cases.push_back(conversion_case);
+    }
+}
@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+    SendConversions.cpp
+    Created: 19 Oct 2026 10:12:48pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <Processing.NDI.Lib.h>
+#include <atomic>
+#include <memory>
+#include "ConversionBenchmark.h"
+#include "NdiVideoHelper.h"
+
+//==============================================================================
+namespace
+{
+    struct SendState
+    {
+        BenchmarkVideoFrame videoFrame;
+    };
+}
+
+//==============================================================================
+void SendConversions::addCases(std::vector<ConversionCase>& cases, int width, int height)
+{
+    // NdiSendWrapper always sends UYVY, so that is the only send path there is.
+    auto state = std::make_shared<SendState>();
+    state->videoFrame.xres = width;
+    state->videoFrame.yres = height;
+    state->videoFrame.frame_rate_N = 60000;
+    state->videoFrame.frame_rate_D = 1001;
+    state->videoFrame.p_metadata = nullptr;
+    state->videoFrame.timecode = 0;
+    state->videoFrame.timestamp = 0;
+    state->videoFrame.image = juce::Image(juce::Image::PixelFormat::ARGB, width, height, false);
+
+    {
+        juce::Random random(0x4e4449);
+        juce::Image::BitmapData bitmap(state->videoFrame.image, juce::Image::BitmapData::writeOnly);
+        for (int y_idx = 0; y_idx < height; ++y_idx)
+        {
+            auto* line = bitmap.getLinePointer(y_idx);
+            for (int i = 0; i < width * bitmap.pixelStride; ++i)
+                line[i] = (juce::uint8)random.nextInt(256);
+        }
+    }
+
+    ConversionCase conversion_case;
+    conversion_case.direction = "send";
+    conversion_case.fourCC = "UYVY";
+    conversion_case.width = width;
+    conversion_case.height = height;
+    conversion_case.inputBytesPerFrame = (size_t)width * (size_t)height * 4;
+    conversion_case.outputBytesPerFrame = (size_t)width * (size_t)height * 2;
+    conversion_case.convertOneFrame = [state]()
+    {
+        NDIlib_video_frame_v2_t dest_frame;
+        NdiVideoHelper::convertVideoFrame(dest_frame, state->videoFrame);
+        free(dest_frame.p_data);
+    };
+    cases.push_back(conversion_case);
+}
@@ -12,12 +12,15 @@
 
 #include <JuceHeader.h>
 #include <Processing.NDI.Lib.h>
-#include "NdiSendWrapper.h"
 
+/** Copies audio between NDI frames and the wrappers' frames, which differ per plugin
+    but share the fields used here.
+*/
 class NdiAudioHelper
 {
 public:
-    static void convertAudioFrame(NdiSendWrapper::NdiAudioFrame& audioFrame, const NDIlib_audio_frame_v2_t& srcFrame)
+    template <typename AudioFrame>
+    static void convertAudioFrame(AudioFrame& audioFrame, const NDIlib_audio_frame_v2_t& srcFrame)
     {
         audioFrame.sample_rate = srcFrame.sample_rate;
         audioFrame.no_channels = srcFrame.no_channels;
@@ -26,16 +29,20 @@ public:
         audioFrame.timestamp = srcFrame.timestamp;
         audioFrame.channel_stride_in_bytes = srcFrame.channel_stride_in_bytes;
 
+        // Planar, a stride of 0 means the channels follow each other directly.
+        const int channel_stride = srcFrame.channel_stride_in_bytes > 0 ? srcFrame.channel_stride_in_bytes : audioFrame.no_samples * (int)sizeof(float);
+
         audioFrame.samples.setSize(audioFrame.no_channels, audioFrame.no_samples);
         for (int ch_idx = 0; ch_idx < audioFrame.samples.getNumChannels(); ++ch_idx)
         {
             juce::FloatVectorOperations::copy(audioFrame.samples.getWritePointer(ch_idx)
-                , (float*)(srcFrame.p_data) + ch_idx * audioFrame.no_samples
+                , reinterpret_cast<const float*>(reinterpret_cast<const char*>(srcFrame.p_data) + ch_idx * channel_stride)
                 , audioFrame.samples.getNumSamples());
         }
     }
 
-    static void convertAudioFrame(NDIlib_audio_frame_v2_t& destFrame, const NdiSendWrapper::NdiAudioFrame& audioFrame)
+    template <typename AudioFrame>
+    static void convertAudioFrame(NDIlib_audio_frame_v2_t& destFrame, const AudioFrame& audioFrame)
     {
         destFrame.sample_rate = audioFrame.sample_rate;
         destFrame.no_channels = audioFrame.no_channels;
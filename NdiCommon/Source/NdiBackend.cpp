@@ -0,0 +1,46 @@
+/*
+  ==============================================================================
+
+    NdiBackend.cpp
+    Created: 19 Oct 2026 4:48:02pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include "NdiBackend.h"
+#include "NdiLibBackend.h"
+
+//==============================================================================
+namespace
+{
+    juce::SpinLock defaultBackendLock;
+    std::shared_ptr<NdiBackend> overrideBackend;
+
+    // Held weakly, so the NDI runtime still goes away with its last user.
+    std::weak_ptr<NdiBackend> ndiLibBackend;
+}
+
+std::shared_ptr<NdiBackend> NdiBackend::getDefault()
+{
+    const juce::SpinLock::ScopedLockType sl(defaultBackendLock);
+
+    if (overrideBackend)
+        return overrideBackend;
+
+    // Cheap to create, the runtime itself is only loaded on first use.
+    auto backend = ndiLibBackend.lock();
+    if (!backend)
+    {
+        backend = std::make_shared<NdiLibBackend>();
+        ndiLibBackend = backend;
+    }
+
+    return backend;
+}
+
+void NdiBackend::setDefault(std::shared_ptr<NdiBackend> newDefault)
+{
+    const juce::SpinLock::ScopedLockType sl(defaultBackendLock);
+    overrideBackend = std::move(newDefault);
+}
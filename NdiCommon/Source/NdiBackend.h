@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    NdiBackend.h
+    Created: 19 Oct 2026 4:48:02pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <Processing.NDI.Lib.h>
+
+//==============================================================================
+/**
+    The transport the wrappers talk to.
+
+    It mirrors the parts of the NDI API the plugins use, with the NDI frame
+    descriptors and instance handles, so the real runtime is a thin pass
+    through. NdiLibBackend is the real NDI implementation and
+    NdiLoopbackBackend connects senders to receivers in memory.
+
+    Wrappers created without an explicit backend use getDefault(), which is
+    the real NDI runtime unless something else was installed with setDefault().
+*/
+class NdiBackend
+{
+public:
+    //==============================================================================
+    virtual ~NdiBackend() = default;
+
+    //==============================================================================
+    /** Returns false when the transport cannot be used, e.g. the runtime is missing. */
+    virtual bool isAvailable() = 0;
+
+    //==============================================================================
+    virtual NDIlib_find_instance_t findCreate() = 0;
+    virtual void findDestroy(NDIlib_find_instance_t finder) = 0;
+    /** Returns true if the sources changed within the time out. */
+    virtual bool findWaitForSources(NDIlib_find_instance_t finder, uint32_t timeOutMsec) = 0;
+    /** The returned array stays valid until the next call for the same finder. */
+    virtual const NDIlib_source_t* findGetCurrentSources(NDIlib_find_instance_t finder, uint32_t* numSources) = 0;
+
+    //==============================================================================
+    virtual NDIlib_recv_instance_t recvCreate() = 0;
+    virtual void recvDestroy(NDIlib_recv_instance_t receiver) = 0;
+    /** Connects to a source, or disconnects with nullptr. */
+    virtual void recvConnect(NDIlib_recv_instance_t receiver, const NDIlib_source_t* source) = 0;
+    virtual NDIlib_frame_type_e recvCapture(NDIlib_recv_instance_t receiver, NDIlib_video_frame_v2_t* videoFrame, NDIlib_audio_frame_v2_t* audioFrame, uint32_t timeOutMsec) = 0;
+    virtual void recvFreeVideo(NDIlib_recv_instance_t receiver, const NDIlib_video_frame_v2_t* videoFrame) = 0;
+    virtual void recvFreeAudio(NDIlib_recv_instance_t receiver, const NDIlib_audio_frame_v2_t* audioFrame) = 0;
+    /** Frames received and dropped by the receiver since it was created, either pointer may be null. */
+    virtual void recvGetPerformance(NDIlib_recv_instance_t receiver, NDIlib_recv_performance_t* totalFrames, NDIlib_recv_performance_t* droppedFrames) = 0;
+    /** Frames waiting to be captured. */
+    virtual void recvGetQueue(NDIlib_recv_instance_t receiver, NDIlib_recv_queue_t* queue) = 0;
+
+    //==============================================================================
+    virtual NDIlib_send_instance_t sendCreate(const NDIlib_send_create_t* description) = 0;
+    virtual void sendDestroy(NDIlib_send_instance_t sender) = 0;
+    virtual void sendVideo(NDIlib_send_instance_t sender, const NDIlib_video_frame_v2_t* videoFrame) = 0;
+    virtual void sendAudio(NDIlib_send_instance_t sender, const NDIlib_audio_frame_v2_t* audioFrame) = 0;
+    virtual int sendGetNoConnections(NDIlib_send_instance_t sender, uint32_t timeOutMsec) = 0;
+    virtual bool sendGetTally(NDIlib_send_instance_t sender, NDIlib_tally_t* tally, uint32_t timeOutMsec) = 0;
+
+    //==============================================================================
+    /** The backend used by wrappers created without one. */
+    static std::shared_ptr<NdiBackend> getDefault();
+
+    /** Replaces the default backend, e.g. with a loopback for headless tests.
+        Only affects wrappers created afterwards. Pass nullptr to go back to NDI.
+    */
+    static void setDefault(std::shared_ptr<NdiBackend> newDefault);
+};
@@ -0,0 +1,139 @@
+/*
+  ==============================================================================
+
+    NdiChannelRouter.cpp
+    Created: 20 Oct 2026 12:31:05am
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include "NdiChannelRouter.h"
+
+//==============================================================================
+NdiChannelRouter::NdiChannelRouter()
+    : gains((size_t)(maxChannels * maxChannels), 0.0f)
+    , taps((size_t)(maxChannels * maxChannels))
+    , firstTaps((size_t)maxChannels + 1, 0)
+{
+}
+
+//==============================================================================
+void NdiChannelRouter::setDefaultRouting(int inputs, int outputs)
+{
+    clear(inputs, outputs);
+    if (numInputs == 0 || numOutputs == 0)
+        return;
+
+    if (numInputs == 1)
+    {
+        for (int out_idx = 0; out_idx < numOutputs; ++out_idx)
+            gains[(size_t)(out_idx * maxChannels)] = 1.0f;
+    }
+    else
+    {
+        // Input n goes to output n modulo the outputs, which averages what lands on each.
+        for (int out_idx = 0; out_idx < numOutputs; ++out_idx)
+        {
+            const int num_folded = (numInputs - 1 - out_idx) / numOutputs + 1;
+            for (int in_idx = out_idx; in_idx < numInputs; in_idx += numOutputs)
+                gains[(size_t)(out_idx * maxChannels + in_idx)] = 1.0f / (float)num_folded;
+        }
+    }
+
+    updateTaps();
+}
+
+void NdiChannelRouter::clear(int inputs, int outputs)
+{
+    numInputs = juce::jlimit(0, maxChannels, inputs);
+    numOutputs = juce::jlimit(0, maxChannels, outputs);
+
+    std::fill(gains.begin(), gains.end(), 0.0f);
+    updateTaps();
+}
+
+void NdiChannelRouter::setGain(int outputChannel, int inputChannel, float gain)
+{
+    if (!juce::isPositiveAndBelow(outputChannel, numOutputs) || !juce::isPositiveAndBelow(inputChannel, numInputs))
+        return;
+
+    gains[(size_t)(outputChannel * maxChannels + inputChannel)] = gain;
+    updateTaps();
+}
+
+float NdiChannelRouter::getGain(int outputChannel, int inputChannel) const
+{
+    if (!juce::isPositiveAndBelow(outputChannel, numOutputs) || !juce::isPositiveAndBelow(inputChannel, numInputs))
+        return 0.0f;
+
+    return gains[(size_t)(outputChannel * maxChannels + inputChannel)];
+}
+
+void NdiChannelRouter::updateTaps()
+{
+    int num_taps = 0;
+    for (int out_idx = 0; out_idx < numOutputs; ++out_idx)
+    {
+        firstTaps[(size_t)out_idx] = num_taps;
+        for (int in_idx = 0; in_idx < numInputs; ++in_idx)
+        {
+            const float gain = gains[(size_t)(out_idx * maxChannels + in_idx)];
+            if (gain != 0.0f)
+                taps[(size_t)num_taps++] = { in_idx, gain };
+        }
+    }
+    firstTaps[(size_t)numOutputs] = num_taps;
+}
+
+//==============================================================================
+void NdiChannelRouter::process(const juce::AudioBuffer<float>& input, juce::AudioBuffer<float>& output, int numSamples, float gain) const
+{
+    const int num_outputs = juce::jmin(numOutputs, output.getNumChannels());
+
+    for (int out_idx = 0; out_idx < num_outputs; ++out_idx)
+    {
+        float* dest = output.getWritePointer(out_idx);
+        bool is_written = false;
+
+        for (int tap_idx = firstTaps[(size_t)out_idx]; tap_idx < firstTaps[(size_t)out_idx + 1]; ++tap_idx)
+        {
+            const auto& tap = taps[(size_t)tap_idx];
+            if (tap.inputChannel >= input.getNumChannels())
+                continue;
+
+            const float* src = input.getReadPointer(tap.inputChannel);
+            const float tap_gain = tap.gain * gain;
+
+            if (is_written)
+                juce::FloatVectorOperations::addWithMultiply(dest, src, tap_gain, numSamples);
+            else if (tap_gain == 1.0f)
+                juce::FloatVectorOperations::copy(dest, src, numSamples);
+            else
+                juce::FloatVectorOperations::copyWithMultiply(dest, src, tap_gain, numSamples);
+
+            is_written = true;
+        }
+
+        if (!is_written)
+            juce::FloatVectorOperations::clear(dest, numSamples);
+    }
+
+    for (int out_idx = num_outputs; out_idx < output.getNumChannels(); ++out_idx)
+        output.clear(out_idx, 0, numSamples);
+}
+
+void NdiChannelRouter::addTo(const juce::AudioBuffer<float>& input, juce::AudioBuffer<float>& output, int numSamples, float gain) const
+{
+    const int num_outputs = juce::jmin(numOutputs, output.getNumChannels());
+
+    for (int out_idx = 0; out_idx < num_outputs; ++out_idx)
+    {
+        for (int tap_idx = firstTaps[(size_t)out_idx]; tap_idx < firstTaps[(size_t)out_idx + 1]; ++tap_idx)
+        {
+            const auto& tap = taps[(size_t)tap_idx];
+            if (tap.inputChannel < input.getNumChannels())
+                juce::FloatVectorOperations::addWithMultiply(output.getWritePointer(out_idx), input.getReadPointer(tap.inputChannel), tap.gain * gain, numSamples);
+        }
+    }
+}
@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+
+    NdiChannelRouter.h
+    Created: 20 Oct 2026 12:31:05am
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+
+//==============================================================================
+/**
+    Maps the channels of an NDI source onto a bus with a gain matrix, in one pass.
+
+    Only the non-zero gains are kept, as a list of taps per output channel, so
+    a remap costs a copy per channel and a downmix one multiply-add per tap.
+    The copies and multiply-adds use juce::FloatVectorOperations, which are
+    vectorised. Everything is allocated up front for maxChannels each way,
+    so the routing can be changed on the audio thread.
+*/
+class NdiChannelRouter
+{
+public:
+    //==============================================================================
+    static constexpr int maxChannels = 64;
+
+    NdiChannelRouter();
+
+    /** A mono source goes to every output and otherwise channel to channel. Sources with more
+        channels than the bus are folded onto it in turn, each output the average of its inputs.
+    */
+    void setDefaultRouting(int numInputs, int numOutputs);
+
+    /** Starts from silence for a matrix made with setGain(). */
+    void clear(int numInputs, int numOutputs);
+    void setGain(int outputChannel, int inputChannel, float gain);
+    float getGain(int outputChannel, int inputChannel) const;
+
+    int getNumInputs() const { return numInputs; }
+    int getNumOutputs() const { return numOutputs; }
+    bool matches(int inputs, int outputs) const { return inputs == numInputs && outputs == numOutputs; }
+
+    //==============================================================================
+    /** Writes every output channel, silent ones included. The buffers must not be the same. */
+    void process(const juce::AudioBuffer<float>& input, juce::AudioBuffer<float>& output, int numSamples, float gain = 1.0f) const;
+
+    /** Mixes into the outputs instead of replacing them. */
+    void addTo(const juce::AudioBuffer<float>& input, juce::AudioBuffer<float>& output, int numSamples, float gain = 1.0f) const;
+
+private:
+    //==============================================================================
+    struct Tap
+    {
+        int inputChannel;
+        float gain;
+    };
+
+    void updateTaps();
+
+    //==============================================================================
+    int numInputs{ 0 };
+    int numOutputs{ 0 };
+
+    // Row per output channel, maxChannels wide.
+    std::vector<float> gains;
+    std::vector<Tap> taps;
+    // The taps of output channel n are taps[firstTaps[n]] up to taps[firstTaps[n + 1]].
+    std::vector<int> firstTaps;
+
+    //==============================================================================
+    JUCE_LEAK_DETECTOR(NdiChannelRouter)
+};
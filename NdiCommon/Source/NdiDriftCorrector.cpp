@@ -0,0 +1,47 @@
+/*
+  ==============================================================================
+
+    NdiDriftCorrector.cpp
+    Created: 20 Oct 2026 11:27:45am
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include "NdiDriftCorrector.h"
+#include <cmath>
+
+//==============================================================================
+// Passed by reference to jlimit, so it needs a definition before C++17.
+constexpr double NdiDriftCorrector::maxRateCorrection;
+
+//==============================================================================
+void NdiDriftCorrector::reset(int ringFill)
+{
+    smoothedRingFill = ringFill;
+    remainder = 0.0;
+}
+
+int NdiDriftCorrector::getNumExcessSamples(int ringFill, double targetFill, int sourceSampleRate)
+{
+    if (ringFill <= targetFill + maxExcessLatencyMsec * 0.001 * sourceSampleRate)
+        return 0;
+
+    return ringFill - juce::roundToInt(targetFill);
+}
+
+int NdiDriftCorrector::getNumToRetrieve(int numDeviceSamples, double deviceSampleRate, int sourceSampleRate, int ringFill, double targetFill)
+{
+    const double block_seconds = numDeviceSamples / deviceSampleRate;
+    smoothedRingFill += (ringFill - smoothedRingFill) * juce::jmin(1.0, block_seconds / ringFillSmoothingSeconds);
+
+    const double fill_error = (smoothedRingFill - targetFill) / juce::jmax(1.0, targetFill);
+    ratio = sourceSampleRate / deviceSampleRate
+        * (1.0 + juce::jlimit(-maxRateCorrection, maxRateCorrection, fill_error * rateCorrectionGain));
+
+    // The fraction left over is carried, so that on average exactly the ratio is read.
+    const double num_to_retrieve = numDeviceSamples * ratio + remainder;
+    remainder = num_to_retrieve - std::floor(num_to_retrieve);
+
+    return (int)num_to_retrieve;
+}
@@ -0,0 +1,56 @@
+/*
+  ==============================================================================
+
+    NdiDriftCorrector.h
+    Created: 20 Oct 2026 11:27:45am
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Works out how many samples to read from a receive ring per device block.
+
+    The sender's clock and the device's never quite agree, so the rate is bent
+    slightly to hold the ring at a target fill. The fill is averaged over about
+    a second, so NDI's frame sized steps do not wobble the rate, and the
+    fraction of a sample left over each block is carried to the next. On
+    average exactly the corrected ratio is read, and the ring neither grows
+    nor runs dry.
+
+    Real-time safe, one per ring.
+*/
+class NdiDriftCorrector
+{
+public:
+    //==============================================================================
+    /** Call when playing starts again, with the fill of the ring at that point. */
+    void reset(int ringFill);
+
+    /** The samples to drop at once when a burst or a stalled host left far more than the target. */
+    static int getNumExcessSamples(int ringFill, double targetFill, int sourceSampleRate);
+
+    /** The source samples to read for a device block, which moves the averaged fill along. */
+    int getNumToRetrieve(int numDeviceSamples, double deviceSampleRate, int sourceSampleRate, int ringFill, double targetFill);
+
+    /** Source samples per device sample, as last worked out. */
+    double getRatio() const { return ratio; }
+
+private:
+    //==============================================================================
+    double smoothedRingFill{ 0.0 };
+    double remainder{ 0.0 };
+    double ratio{ 1.0 };
+
+    // The two clocks drift by a few hundred ppm at most, the rate is never bent further than this.
+    static constexpr double maxRateCorrection = 0.002;
+    // Rate correction per unit of fill error relative to the target.
+    static constexpr double rateCorrectionGain = 0.01;
+    static constexpr double ringFillSmoothingSeconds = 1.0;
+    // More than this much above the target is dropped at once rather than slowly played away.
+    static constexpr double maxExcessLatencyMsec = 250.0;
+};
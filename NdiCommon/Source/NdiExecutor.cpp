@@ -0,0 +1,428 @@
+/*
+  ==============================================================================
+
+    NdiExecutor.cpp
+    Created: 20 Oct 2026 2:04:16am
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include "NdiExecutor.h"
+#include <cmath>
+#include <limits>
+
+//==============================================================================
+struct NdiExecutor::Queue::State
+{
+    State(const juce::String& name_, bool hasRole_, NdiThreadPolicy::Role role_, NdiPipelineStats* stats_)
+        : name(name_)
+        , hasRole(hasRole_)
+        , role(role_)
+        , stats(stats_)
+    {
+    }
+
+    const juce::String name;
+    const bool hasRole;
+    const NdiThreadPolicy::Role role;
+    NdiPipelineStats* const stats;
+
+    // One list of tasks per lane, the one at the front runs next.
+    juce::CriticalSection lock;
+    std::deque<RepeatingTask> tasks[2];
+    bool isScheduled[2] = {};
+    // Set by wake(), cleared when the lane's task starts.
+    std::atomic<bool> isWakeRequested[2] = { { false }, { false } };
+    int numRunning{ 0 };
+    bool isClosed{ false };
+    juce::WaitableEvent taskFinished;
+};
+
+//==============================================================================
+namespace
+{
+    // Set on the worker threads only.
+    thread_local const NdiExecutor* currentExecutor = nullptr;
+    thread_local int currentWorkerIndex = -1;
+    thread_local const NdiExecutor::Queue::State* runningQueue = nullptr;
+}
+
+//==============================================================================
+class NdiExecutor::Worker : public juce::Thread
+{
+public:
+    Worker(NdiExecutor& owner_, int index_)
+        : juce::Thread("NDI Worker " + juce::String(index_ + 1))
+        , owner(owner_)
+        , index(index_)
+    {
+    }
+
+    void run() override
+    {
+        currentExecutor = &owner;
+        currentWorkerIndex = index;
+
+        while (!threadShouldExit())
+        {
+            const int due_msec = owner.releaseDueTickets(index);
+
+            Ticket ticket;
+            if (owner.takeTicket(index, ticket))
+            {
+                owner.runTicket(std::move(ticket));
+                continue;
+            }
+
+            // The audio worker sleeps only until the next delayed ticket is due, audio ones are released on time however busy the rest are.
+            if (index == audioWorkerIndex)
+            {
+                owner.audioAvailable.wait(due_msec);
+                continue;
+            }
+
+            // One idle worker keeps time for the delayed tickets, the others sleep until there is work.
+            const bool is_timekeeper = !owner.hasTimekeeper.exchange(true);
+            int wait_msec = idleWaitMsec;
+            if (is_timekeeper)
+                wait_msec = due_msec;
+
+            const bool was_woken = owner.workAvailable.wait(wait_msec);
+            if (is_timekeeper)
+            {
+                owner.hasTimekeeper = false;
+
+                // Off to work, another idle worker takes over the time keeping.
+                if (was_woken && owner.numQueuedTickets.load() > 0)
+                    owner.workAvailable.signal();
+            }
+        }
+
+        // Each signal wakes one waiter, so every worker leaving wakes the next one.
+        owner.workAvailable.signal();
+    }
+
+    // Queues with work waiting, one list per lane. Taken from the front by every worker.
+    juce::CriticalSection lock;
+    std::deque<Ticket> tickets[2];
+
+private:
+    NdiExecutor& owner;
+    const int index;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Worker)
+};
+
+//==============================================================================
+NdiExecutor::NdiExecutor()
+    : nextDueTicks(std::numeric_limits<juce::int64>::max())
+{
+    // One of them is the audio worker, which takes nothing else.
+    const int num_threads = juce::jmax(minNumThreads, juce::SystemStats::getNumCpus());
+    for (int worker_idx = 0; worker_idx < num_threads; ++worker_idx)
+        workers.add(new Worker(*this, worker_idx));
+
+    for (auto* worker : workers)
+        worker->startThread(10);
+}
+
+NdiExecutor::~NdiExecutor()
+{
+    // Every queue is gone by now, they hold the executor.
+    for (auto* worker : workers)
+        worker->signalThreadShouldExit();
+
+    audioAvailable.signal();
+    workAvailable.signal();
+
+    for (auto* worker : workers)
+        worker->stopThread(idleWaitMsec + 1000);
+
+    workers.clear();
+}
+
+//==============================================================================
+void NdiExecutor::schedule(Ticket ticket)
+{
+    // A worker keeps the queues it ran to itself, the rest are spread over all of them.
+    const int worker_idx = currentExecutor == this ? currentWorkerIndex : (nextWorker++ & 0x7fffffff) % workers.size();
+    const int lane = ticket.lane;
+    auto& worker = *workers.getUnchecked(worker_idx);
+    {
+        const juce::ScopedLock worker_lock(worker.lock);
+        worker.tickets[lane].push_back(std::move(ticket));
+    }
+
+    const bool is_audio = lane == (int)Lane::audio;
+    ++numQueuedTickets;
+
+    // A worker between two tasks takes it itself right after, nobody has to wake up for it.
+    const bool is_taken_next = currentExecutor == this && runningQueue == nullptr
+        && (is_audio || worker_idx != audioWorkerIndex);
+    if (is_taken_next)
+        return;
+
+    // The audio worker is always free for the audio lane, an idle normal worker may be quicker still.
+    if (is_audio)
+        audioAvailable.signal();
+    workAvailable.signal();
+}
+
+void NdiExecutor::scheduleAfter(Ticket ticket, int delayMsec)
+{
+    const auto now_ticks = juce::Time::getHighResolutionTicks();
+    auto due_ticks = now_ticks + juce::Time::secondsToHighResolutionTicks(delayMsec * 0.001);
+
+    bool is_earliest = false;
+    {
+        const juce::ScopedLock delayed_lock(delayedLock);
+
+        // Woken while it ran, checked under the lock so a wake is never missed by both this and releaseDueTickets().
+        if (ticket.queue->isWakeRequested[ticket.lane].load())
+            due_ticks = now_ticks;
+
+        delayedTickets.push_back({ due_ticks, std::move(ticket) });
+
+        if (due_ticks < nextDueTicks.load())
+        {
+            nextDueTicks = due_ticks;
+            is_earliest = true;
+        }
+    }
+
+    // The time keeper and the audio worker may be sleeping for longer than this.
+    if (is_earliest)
+    {
+        audioAvailable.signal();
+        workAvailable.signal();
+    }
+}
+
+void NdiExecutor::wakeDelayedTickets()
+{
+    hasWakeRequests = true;
+    audioAvailable.signal();
+    workAvailable.signal();
+}
+
+int NdiExecutor::releaseDueTickets(int workerIndex)
+{
+    const auto now_ticks = juce::Time::getHighResolutionTicks();
+    auto next_due_ticks = nextDueTicks.load();
+    const bool has_wake_requests = hasWakeRequests.load() && hasWakeRequests.exchange(false);
+
+    if (now_ticks >= next_due_ticks || has_wake_requests)
+    {
+        auto& worker = *workers.getUnchecked(workerIndex);
+        int num_released = 0;
+        int num_released_normal = 0;
+
+        const juce::ScopedLock delayed_lock(delayedLock);
+        next_due_ticks = std::numeric_limits<juce::int64>::max();
+
+        for (size_t ticket_idx = 0; ticket_idx < delayedTickets.size();)
+        {
+            auto& delayed = delayedTickets[ticket_idx];
+            const bool is_woken = has_wake_requests && delayed.ticket.queue->isWakeRequested[delayed.ticket.lane].load();
+            if (delayed.dueTicks > now_ticks && !is_woken)
+            {
+                next_due_ticks = juce::jmin(next_due_ticks, delayed.dueTicks);
+                ++ticket_idx;
+                continue;
+            }
+
+            const int lane = delayed.ticket.lane;
+            {
+                const juce::ScopedLock worker_lock(worker.lock);
+                worker.tickets[lane].push_back(std::move(delayed.ticket));
+            }
+            ++num_released;
+            if (lane != (int)Lane::audio)
+                ++num_released_normal;
+
+            // The order of the rest does not matter, the last one takes its place.
+            if (ticket_idx + 1 < delayedTickets.size())
+                delayed = std::move(delayedTickets.back());
+            delayedTickets.pop_back();
+        }
+
+        nextDueTicks = next_due_ticks;
+        numQueuedTickets += num_released;
+
+        // The audio worker cannot run these itself.
+        if (workerIndex == audioWorkerIndex && num_released_normal > 0)
+            workAvailable.signal();
+    }
+
+    if (next_due_ticks == std::numeric_limits<juce::int64>::max())
+        return idleWaitMsec;
+
+    const double msec_to_due = juce::Time::highResolutionTicksToSeconds(next_due_ticks - now_ticks) * 1000.0;
+    return juce::jlimit(1, idleWaitMsec, (int)std::ceil(msec_to_due));
+}
+
+bool NdiExecutor::takeTicket(int workerIndex, Ticket& ticket)
+{
+    if (numQueuedTickets.load() <= 0)
+        return false;
+
+    // The audio lane of every worker before the normal lane of any, the worker's own list first.
+    // The audio worker only ever looks at the audio lane.
+    const int num_lanes = workerIndex == audioWorkerIndex ? 1 : 2;
+    for (int lane = 0; lane < num_lanes; ++lane)
+    {
+        for (int offset = 0; offset < workers.size(); ++offset)
+        {
+            auto& worker = *workers.getUnchecked((workerIndex + offset) % workers.size());
+            const juce::ScopedLock worker_lock(worker.lock);
+
+            auto& tickets = worker.tickets[lane];
+            if (tickets.empty())
+                continue;
+
+            ticket = std::move(tickets.front());
+            tickets.pop_front();
+
+            // More is waiting, another worker is woken for it.
+            if (--numQueuedTickets > 0)
+                workAvailable.signal();
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void NdiExecutor::runTicket(Ticket ticket)
+{
+    auto& queue = *ticket.queue;
+    auto& tasks = queue.tasks[ticket.lane];
+
+    RepeatingTask task;
+    {
+        const juce::ScopedLock queue_lock(queue.lock);
+        if (queue.isClosed || tasks.empty())
+        {
+            queue.isScheduled[ticket.lane] = false;
+            return;
+        }
+
+        task = std::move(tasks.front());
+        tasks.pop_front();
+        ++queue.numRunning;
+    }
+
+    // Whatever woke it is seen by this run, a wake from now on runs it once more.
+    queue.isWakeRequested[ticket.lane] = false;
+
+    if (queue.hasRole)
+        NdiThreadPolicy::switchCurrentThreadTo(queue.role, *queue.stats);
+
+    runningQueue = &queue;
+    const int delay_msec = task();
+    runningQueue = nullptr;
+
+    bool has_more_tasks = false;
+    {
+        const juce::ScopedLock queue_lock(queue.lock);
+        --queue.numRunning;
+
+        // A repeating task stays at the front, ahead of anything submitted since.
+        if (delay_msec >= 0 && !queue.isClosed)
+            tasks.push_front(std::move(task));
+
+        has_more_tasks = !queue.isClosed && !tasks.empty();
+        queue.isScheduled[ticket.lane] = has_more_tasks;
+    }
+    queue.taskFinished.signal();
+
+    // To the back of the list, so every other queue has its turn first.
+    if (has_more_tasks)
+    {
+        if (delay_msec > 0)
+            scheduleAfter(std::move(ticket), delay_msec);
+        else
+            schedule(std::move(ticket));
+    }
+}
+
+//==============================================================================
+NdiExecutor::Queue::Queue(const juce::String& name)
+    : state(std::make_shared<State>(name, false, NdiThreadPolicy::Role::conversion, nullptr))
+{
+}
+
+NdiExecutor::Queue::Queue(const juce::String& name, NdiThreadPolicy::Role role, NdiPipelineStats& stats)
+    : state(std::make_shared<State>(name, true, role, &stats))
+{
+}
+
+NdiExecutor::Queue::~Queue()
+{
+    cancelAndWait();
+}
+
+void NdiExecutor::Queue::submit(std::function<void()> task, Lane lane)
+{
+    submitRepeating([task]()
+    {
+        task();
+        return -1;
+    }, lane);
+}
+
+void NdiExecutor::Queue::submitRepeating(RepeatingTask task, Lane lane)
+{
+    const int lane_idx = (int)lane;
+    bool should_schedule = false;
+    {
+        const juce::ScopedLock queue_lock(state->lock);
+        if (state->isClosed)
+            return;
+
+        state->tasks[lane_idx].push_back(std::move(task));
+        should_schedule = !state->isScheduled[lane_idx];
+        state->isScheduled[lane_idx] = true;
+    }
+
+    if (should_schedule)
+        executor->schedule({ state, lane_idx });
+}
+
+void NdiExecutor::Queue::cancelAndWait()
+{
+    // Destroyed outside the lock, they may hold on to anything.
+    std::deque<RepeatingTask> dropped_tasks[2];
+    {
+        const juce::ScopedLock queue_lock(state->lock);
+        state->isClosed = true;
+        for (int lane_idx = 0; lane_idx < 2; ++lane_idx)
+            std::swap(dropped_tasks[lane_idx], state->tasks[lane_idx]);
+    }
+
+    // A task that cancels its own queue cannot wait for itself.
+    const int num_own_tasks = runningQueue == state.get() ? 1 : 0;
+    for (;;)
+    {
+        {
+            const juce::ScopedLock queue_lock(state->lock);
+            if (state->numRunning <= num_own_tasks)
+                break;
+        }
+        state->taskFinished.wait(10);
+    }
+}
+
+void NdiExecutor::Queue::wake(Lane lane)
+{
+    // Once until the task starts, so the audio thread signals at most once for each run.
+    if (!state->isWakeRequested[(int)lane].exchange(true))
+        executor->wakeDelayedTickets();
+}
+
+const juce::String& NdiExecutor::Queue::getName() const
+{
+    return state->name;
+}
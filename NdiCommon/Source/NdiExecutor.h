@@ -0,0 +1,140 @@
+/*
+  ==============================================================================
+
+    NdiExecutor.h
+    Created: 20 Oct 2026 2:04:16am
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "NdiPipelineStats.h"
+#include "NdiThreadPolicy.h"
+
+//==============================================================================
+/**
+    The worker threads shared by every NDI plugin instance in the process.
+
+    Owners submit work through their own Queue rather than running threads of
+    their own, so the number of threads stays at the number of CPUs however
+    many instances are loaded. Each worker keeps its own list of queues with
+    work waiting and takes one task from the queue at its front, then puts the
+    queue at the back again, so a busy instance cannot starve the others.
+    A worker whose list is empty steals from the others'.
+
+    Audio lane work is always taken before anything on the normal lane, on
+    any worker. One worker takes audio lane work only, so it keeps its
+    deadline even while long jobs occupy every other worker. Tasks of one
+    queue and lane run one at a time, in order.
+
+    Hold it through a juce::SharedResourcePointer<NdiExecutor>, the Queue does.
+*/
+class NdiExecutor
+{
+public:
+    //==============================================================================
+    enum class Lane
+    {
+        audio,
+        normal
+    };
+
+    /** Returns the delay in milliseconds before running it again: 0 for as soon as the others had a turn, negative when done. */
+    using RepeatingTask = std::function<int()>;
+
+    //==============================================================================
+    class Queue
+    {
+    public:
+        /** The tasks run on whatever policy the worker has, e.g. for jobs of an editor. */
+        explicit Queue(const juce::String& name);
+        /** Workers take on the role's NdiThreadPolicy for these tasks and report it in the stats. */
+        Queue(const juce::String& name, NdiThreadPolicy::Role role, NdiPipelineStats& stats);
+        /** Calls cancelAndWait(). */
+        ~Queue();
+
+        /** Runs the task once. Allocates, not for the audio thread. */
+        void submit(std::function<void()> task, Lane lane = Lane::normal);
+        void submitRepeating(RepeatingTask task, Lane lane = Lane::normal);
+
+        /** Runs the lane's repeating task now instead of when its delay is up, or once more right after it if it is running.
+            Does not allocate, it sets a flag and signals the workers, so the audio thread can call it when it queued data.
+        */
+        void wake(Lane lane);
+
+        /** Drops the tasks not started yet and waits for the ones running, except one calling this. */
+        void cancelAndWait();
+
+        const juce::String& getName() const;
+
+        struct State;
+
+    private:
+        //==============================================================================
+        juce::SharedResourcePointer<NdiExecutor> executor;
+        std::shared_ptr<State> state;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Queue)
+    };
+
+    //==============================================================================
+    NdiExecutor();
+    ~NdiExecutor();
+
+    int getNumThreads() const { return workers.size(); }
+
+private:
+    //==============================================================================
+    class Worker;
+
+    /** One lane of one queue with work waiting, in a worker's list or waiting for its delay. */
+    struct Ticket
+    {
+        std::shared_ptr<Queue::State> queue;
+        int lane;
+    };
+
+    struct DelayedTicket
+    {
+        juce::int64 dueTicks;
+        Ticket ticket;
+    };
+
+    //==============================================================================
+    void schedule(Ticket ticket);
+    void scheduleAfter(Ticket ticket, int delayMsec);
+    void wakeDelayedTickets();
+    bool takeTicket(int workerIndex, Ticket& ticket);
+    void runTicket(Ticket ticket);
+
+    /** Moves the delayed tickets that are due to the worker, returns the msec until the next one. */
+    int releaseDueTickets(int workerIndex);
+
+    //==============================================================================
+    juce::OwnedArray<Worker> workers;
+    std::atomic<int> nextWorker{ 0 };
+    std::atomic<int> numQueuedTickets{ 0 };
+    juce::WaitableEvent workAvailable;
+    juce::WaitableEvent audioAvailable;
+    std::atomic<bool> hasTimekeeper{ false };
+    std::atomic<bool> hasWakeRequests{ false };
+
+    juce::CriticalSection delayedLock;
+    std::vector<DelayedTicket> delayedTickets;
+    std::atomic<juce::int64> nextDueTicks;
+
+    // However few CPUs there are, the audio worker and one for everything else.
+    static constexpr int minNumThreads = 2;
+    static constexpr int audioWorkerIndex = 0;
+    // How long an idle worker sleeps at most, it is woken for new work anyway.
+    static constexpr int idleWaitMsec = 100;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NdiExecutor)
+};
@@ -0,0 +1,744 @@
+/*
+  ==============================================================================
+
+    NdiInProcessRouter.cpp
+    Created: 19 Oct 2026 9:02:37pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include "NdiInProcessRouter.h"
+#include <thread>
+
+#if JUCE_WINDOWS
+ #include <windows.h>
+#else
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <fcntl.h>
+ #include <unistd.h>
+#endif
+
+#if JUCE_MAC
+ #include <sys/sysctl.h>
+#endif
+
+//==============================================================================
+namespace
+{
+    constexpr uint32_t routerMagic = 0x4e444952; // "NDIR"
+    constexpr uint32_t routerVersion = 1;
+
+    constexpr int maxEndpoints = 32;
+    constexpr int maxSubscriptions = 8;
+    constexpr uint32_t queueSize = 16;
+    constexpr size_t maxNameLength = 128;
+
+    // Receivers keep at most this many audio blocks queued, beyond it the oldest are dropped.
+    constexpr uint32_t maxQueuedAudioFrames = 2;
+
+    // Set on frames nobody pools, whoever drops the last reference then frees them.
+    constexpr int32_t orphanedFlag = 1 << 30;
+
+    enum EndpointState : uint32_t
+    {
+        kFree = 0,
+        kOpen,
+        kClosed
+    };
+
+    // Frames may be freed by another plugin binary than the one that allocated them,
+    // so they come from the process heap rather than from either runtime library.
+    void* allocateProcessWide(size_t size)
+    {
+       #if JUCE_WINDOWS
+        return HeapAlloc(GetProcessHeap(), 0, size);
+       #else
+        return std::malloc(size);
+       #endif
+    }
+
+    void freeProcessWide(void* memory)
+    {
+       #if JUCE_WINDOWS
+        HeapFree(GetProcessHeap(), 0, memory);
+       #else
+        std::free(memory);
+       #endif
+    }
+}
+
+//==============================================================================
+struct alignas(16) NdiInProcessFrame
+{
+    std::atomic<int32_t> refCount{ 0 };
+    size_t capacity{ 0 };
+
+    int32_t width{ 0 }, height{ 0 };
+    int32_t sampleRate{ 0 }, numChannels{ 0 }, numSamples{ 0 };
+
+    uint8_t* getData() { return reinterpret_cast<uint8_t*>(this + 1); }
+};
+
+struct NdiInProcessFrameQueue
+{
+    std::atomic<uint32_t> readIndex{ 0 };
+    std::atomic<uint32_t> writeIndex{ 0 };
+    std::atomic<NdiInProcessFrame*> slots[queueSize] = {};
+
+    // Single producer, single consumer.
+    bool push(NdiInProcessFrame* frame)
+    {
+        const uint32_t write_index = writeIndex.load(std::memory_order_relaxed);
+        if (write_index - readIndex.load(std::memory_order_acquire) >= queueSize) return false;
+
+        slots[write_index % queueSize].store(frame, std::memory_order_relaxed);
+        writeIndex.store(write_index + 1, std::memory_order_release);
+        return true;
+    }
+
+    NdiInProcessFrame* pop()
+    {
+        const uint32_t read_index = readIndex.load(std::memory_order_relaxed);
+        if (read_index == writeIndex.load(std::memory_order_acquire)) return nullptr;
+
+        auto* frame = slots[read_index % queueSize].load(std::memory_order_relaxed);
+        readIndex.store(read_index + 1, std::memory_order_release);
+        return frame;
+    }
+
+    uint32_t getNumReady() const
+    {
+        return writeIndex.load(std::memory_order_acquire) - readIndex.load(std::memory_order_relaxed);
+    }
+};
+
+struct NdiInProcessSubscription
+{
+    std::atomic<uint32_t> isUsed{ 0 };
+    std::atomic<uint32_t> isActive{ 0 };
+    NdiInProcessFrameQueue audio;
+    NdiInProcessFrameQueue video;
+};
+
+struct NdiInProcessEndpoint
+{
+    std::atomic<uint32_t> state{ kFree };
+    std::atomic<uint32_t> numBusy{ 0 };
+    std::atomic<uint32_t> numSubscribers{ 0 };
+    char name[maxNameLength] = {};
+    NdiInProcessSubscription subscriptions[maxSubscriptions];
+};
+
+//==============================================================================
+namespace
+{
+    struct RouterState
+    {
+        uint32_t magic{ routerMagic };
+        uint32_t version{ routerVersion };
+        std::atomic<uint32_t> lock{ 0 };
+        NdiInProcessEndpoint endpoints[maxEndpoints];
+    };
+
+    static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_POINTER_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2,
+                  "Atomics shared between plugin binaries have to be lock free");
+
+    // Guards endpoint and subscription slots, never taken on the audio thread.
+    class RegistryLock
+    {
+    public:
+        explicit RegistryLock(RouterState& state_)
+            : state(state_)
+        {
+            while (state.lock.exchange(1, std::memory_order_acquire) != 0)
+                std::this_thread::yield();
+        }
+
+        ~RegistryLock()
+        {
+            state.lock.store(0, std::memory_order_release);
+        }
+
+    private:
+        RouterState& state;
+    };
+
+    //==============================================================================
+    RouterState* createRouterState()
+    {
+        void* memory = allocateProcessWide(sizeof(RouterState));
+        return memory != nullptr ? new (memory) RouterState() : nullptr;
+    }
+
+   #if JUCE_WINDOWS
+    void destroyRouterState(RouterState* state)
+    {
+        state->~RouterState();
+        freeProcessWide(state);
+    }
+   #else
+    // What the named mapping holds, the address is only valid for the process that stored it.
+    struct RouterAnchor
+    {
+        std::atomic<juce::uint64> claimedBy;
+        std::atomic<juce::uint64> stateOwner;
+        std::atomic<juce::uint64> stateAddress;
+        // Plugin binaries holding it, or anchorReleased once the last one let go and is removing its name.
+        std::atomic<juce::uint32> numUsers;
+    };
+
+    constexpr juce::uint32 anchorReleased = 0xffffffff;
+
+    juce::String getAnchorName()
+    {
+        return "/ndijuce-router-" + juce::String((int)getpid());
+    }
+
+    /** Held by each plugin binary while it is loaded, the last one to go removes the anchor's name. */
+    struct AnchorReference
+    {
+        constexpr AnchorReference() = default;
+
+        ~AnchorReference()
+        {
+            if (anchor == nullptr) return;
+
+            // Openers that see it released look again, by then the name is gone or belongs to a new anchor.
+            juce::uint32 num_users = 0;
+            if (anchor->numUsers.fetch_sub(1, std::memory_order_acq_rel) == 1
+                && anchor->numUsers.compare_exchange_strong(num_users, anchorReleased, std::memory_order_acq_rel))
+                shm_unlink(getAnchorName().toRawUTF8());
+
+            // The state stays, a plugin still running at exit may use it. A new anchor starts a new one.
+            munmap(anchor, sizeof(RouterAnchor));
+        }
+
+        RouterAnchor* anchor{ nullptr };
+    };
+
+    AnchorReference anchorReference;
+
+    // Tells this process apart from an earlier one with the same pid, whose mapping may have been left behind.
+    juce::uint64 getProcessStartTime()
+    {
+       #if JUCE_LINUX
+        // Field 22 of /proc/self/stat, the fields after the command name in parentheses start at 3.
+        const auto fields = juce::StringArray::fromTokens(juce::File("/proc/self/stat").loadFileAsString().fromLastOccurrenceOf(")", false, false), true);
+        return fields.size() > 19 ? (juce::uint64)fields[19].getLargeIntValue() : 0;
+       #elif JUCE_MAC
+        int mib[] = { CTL_KERN, KERN_PROC, KERN_PROC_PID, (int)getpid() };
+        kinfo_proc info;
+        size_t size = sizeof(info);
+        if (sysctl(mib, 4, &info, &size, nullptr, 0) != 0 || size == 0) return 0;
+        return (juce::uint64)info.kp_proc.p_starttime.tv_sec * 1000000 + (juce::uint64)info.kp_proc.p_starttime.tv_usec;
+       #else
+        return 0;
+       #endif
+    }
+   #endif
+
+    RouterState* findOrCreateRouterState()
+    {
+        RouterState* state = nullptr;
+
+       #if JUCE_WINDOWS
+        // A named mapping scoped to this process holds the address, it is never closed.
+        const auto mapping_name = "Local\\ndijuce-inprocess-router-" + juce::String((int)GetCurrentProcessId());
+        HANDLE mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, sizeof(void*), mapping_name.toWideCharPointer());
+        if (mapping == nullptr) return nullptr;
+
+        auto* slot = static_cast<void* volatile*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(void*)));
+        if (slot == nullptr) return nullptr;
+
+        state = static_cast<RouterState*>(*slot);
+        if (state == nullptr)
+        {
+            auto* candidate = createRouterState();
+            if (candidate == nullptr) return nullptr;
+
+            void* previous = InterlockedCompareExchangePointer(reinterpret_cast<PVOID volatile*>(slot), candidate, nullptr);
+            if (previous != nullptr)
+                destroyRouterState(candidate);
+
+            state = previous != nullptr ? static_cast<RouterState*>(previous) : candidate;
+        }
+       #else
+        // The same on POSIX, the mapping is named after the process id and holds the address.
+        // A crashed process may leave it behind, so it also names the process it belongs to,
+        // and the address is only read once this process has stored it.
+        const auto start_time = getProcessStartTime();
+        if (start_time == 0) return nullptr;
+
+        for (int attempt = 0; state == nullptr; ++attempt)
+        {
+            if (attempt >= 1000) return nullptr;
+            if (attempt > 0) std::this_thread::yield();
+
+            const int fd = shm_open(getAnchorName().toRawUTF8(), O_CREAT | O_RDWR, 0600);
+            if (fd < 0) return nullptr;
+
+            // Zero filled when it is new, left as it is otherwise.
+            struct stat st;
+            const bool is_sized = fstat(fd, &st) == 0 && ((juce::uint64)st.st_size >= sizeof(RouterAnchor) || ftruncate(fd, sizeof(RouterAnchor)) == 0);
+            void* mapped = is_sized ? mmap(nullptr, sizeof(RouterAnchor), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+            ::close(fd);
+            if (mapped == MAP_FAILED) return nullptr;
+
+            auto* anchor = static_cast<RouterAnchor*>(mapped);
+
+            // The first plugin of this process claims it, replacing whatever an earlier process left.
+            auto claimed_by = anchor->claimedBy.load(std::memory_order_acquire);
+            if (claimed_by != start_time && anchor->claimedBy.compare_exchange_strong(claimed_by, start_time, std::memory_order_acq_rel))
+            {
+                auto* candidate = createRouterState();
+                if (candidate == nullptr)
+                {
+                    munmap(anchor, sizeof(RouterAnchor));
+                    return nullptr;
+                }
+
+                anchor->numUsers.store(0, std::memory_order_relaxed);
+                anchor->stateAddress.store((juce::uint64)(juce::pointer_sized_int)candidate, std::memory_order_relaxed);
+                anchor->stateOwner.store(start_time, std::memory_order_release);
+            }
+
+            // Another plugin claimed it first and is about to store the address.
+            for (int wait_count = 0; anchor->stateOwner.load(std::memory_order_acquire) != start_time && wait_count < 1000; ++wait_count)
+                std::this_thread::yield();
+
+            // Not one the last user is removing right now, that one is looked for again.
+            auto num_users = anchor->numUsers.load(std::memory_order_acquire);
+            bool is_held = false;
+            while (anchor->stateOwner.load(std::memory_order_acquire) == start_time && num_users != anchorReleased
+                   && !(is_held = anchor->numUsers.compare_exchange_weak(num_users, num_users + 1, std::memory_order_acq_rel)))
+            {
+            }
+
+            if (!is_held)
+            {
+                munmap(anchor, sizeof(RouterAnchor));
+                continue;
+            }
+
+            // Kept mapped until this plugin binary goes, which then lets go of it.
+            anchorReference.anchor = anchor;
+            state = reinterpret_cast<RouterState*>((juce::pointer_sized_int)anchor->stateAddress.load(std::memory_order_relaxed));
+        }
+       #endif
+
+        // A plugin built from another version of this file keeps its frames to itself.
+        if (state == nullptr || state->magic != routerMagic || state->version != routerVersion)
+            return nullptr;
+
+        return state;
+    }
+
+    RouterState* getRouterState()
+    {
+        static RouterState* const state = findOrCreateRouterState();
+        return state;
+    }
+
+    //==============================================================================
+    NdiInProcessFrame* createFrame(size_t capacity, int32_t initialRefCount)
+    {
+        void* memory = allocateProcessWide(sizeof(NdiInProcessFrame) + capacity);
+        if (memory == nullptr) return nullptr;
+
+        auto* frame = new (memory) NdiInProcessFrame();
+        frame->refCount.store(initialRefCount, std::memory_order_relaxed);
+        frame->capacity = capacity;
+        return frame;
+    }
+
+    void destroyFrame(NdiInProcessFrame* frame)
+    {
+        frame->~NdiInProcessFrame();
+        freeProcessWide(frame);
+    }
+
+    void orphanFrame(NdiInProcessFrame* frame)
+    {
+        // Frames still queued at subscribers are freed by the last one to let go.
+        if (frame->refCount.fetch_add(orphanedFlag, std::memory_order_acq_rel) == 0)
+            destroyFrame(frame);
+    }
+
+    void releaseFrame(NdiInProcessFrame* frame)
+    {
+        // Pooled frames simply become free again, orphaned ones are freed with their last reference.
+        if (frame->refCount.fetch_sub(1, std::memory_order_acq_rel) - 1 == orphanedFlag)
+            destroyFrame(frame);
+    }
+
+    uint32_t getActiveSubscriptions(NdiInProcessEndpoint& endpoint, int& numActive)
+    {
+        uint32_t active_mask = 0;
+        numActive = 0;
+
+        for (int i = 0; i < maxSubscriptions; ++i)
+        {
+            if (endpoint.subscriptions[i].isActive.load(std::memory_order_seq_cst) != 0)
+            {
+                active_mask |= 1U << i;
+                ++numActive;
+            }
+        }
+
+        return active_mask;
+    }
+}
+
+//==============================================================================
+NdiInProcessPublisher::NdiInProcessPublisher(const juce::String& ndiName)
+{
+    auto* state = getRouterState();
+    if (state == nullptr) return;
+
+    const std::string name = ndiName.toStdString();
+    if (name.empty() || name.size() >= maxNameLength) return;
+
+    RegistryLock registry_lock(*state);
+
+    for (auto& candidate : state->endpoints)
+    {
+        if (candidate.state.load(std::memory_order_relaxed) != kFree) continue;
+
+        std::strncpy(candidate.name, name.c_str(), maxNameLength - 1);
+        candidate.numBusy.store(0);
+        candidate.numSubscribers.store(0);
+        candidate.state.store(kOpen);
+
+        endpoint = &candidate;
+        break;
+    }
+}
+
+NdiInProcessPublisher::~NdiInProcessPublisher()
+{
+    if (endpoint == nullptr) return;
+
+    {
+        RegistryLock registry_lock(*getRouterState());
+
+        // Subscribers still attached free the slot when they detach.
+        endpoint->state.store(endpoint->numSubscribers.load() == 0 ? kFree : kClosed);
+    }
+
+    for (auto* frame : audioPool)
+    {
+        if (frame != nullptr)
+            orphanFrame(frame);
+    }
+}
+
+bool NdiInProcessPublisher::isOpen() const
+{
+    return endpoint != nullptr;
+}
+
+bool NdiInProcessPublisher::hasSubscribers() const
+{
+    return endpoint != nullptr && endpoint->numSubscribers.load(std::memory_order_relaxed) > 0;
+}
+
+void NdiInProcessPublisher::prepareAudio(int maxNumChannels, int maxNumSamples)
+{
+    if (endpoint == nullptr) return;
+
+    const size_t data_size = sizeof(float) * (size_t)juce::jmax(1, maxNumChannels) * (size_t)juce::jmax(1, maxNumSamples);
+
+    // Blocks big enough already are kept, they may still be queued at a subscriber.
+    for (auto*& frame : audioPool)
+    {
+        if (frame != nullptr && frame->capacity >= data_size) continue;
+
+        if (frame != nullptr) orphanFrame(frame);
+        frame = createFrame(data_size, 0);
+    }
+}
+
+void NdiInProcessPublisher::publishAudio(const juce::AudioBuffer<float>& buffer, int sampleRate)
+{
+    if (endpoint == nullptr) return;
+
+    const int num_channels = buffer.getNumChannels();
+    const int num_samples = buffer.getNumSamples();
+    if (num_channels <= 0 || num_samples <= 0) return;
+
+    // Detaching subscribers wait for this to drop to zero before draining their queues.
+    endpoint->numBusy.fetch_add(1, std::memory_order_seq_cst);
+
+    int num_targets = 0;
+    const uint32_t targets = getActiveSubscriptions(*endpoint, num_targets);
+
+    if (num_targets > 0)
+    {
+        const size_t data_size = sizeof(float) * (size_t)num_channels * (size_t)num_samples;
+
+        if (auto* frame = acquireAudioFrame(data_size))
+        {
+            frame->sampleRate = sampleRate;
+            frame->numChannels = num_channels;
+            frame->numSamples = num_samples;
+
+            auto* data = reinterpret_cast<float*>(frame->getData());
+            for (int ch_idx = 0; ch_idx < num_channels; ++ch_idx)
+                juce::FloatVectorOperations::copy(data + ch_idx * num_samples, buffer.getReadPointer(ch_idx), num_samples);
+
+            // One reference per subscriber, all of them share the same block.
+            frame->refCount.store(num_targets, std::memory_order_relaxed);
+
+            for (int i = 0; i < maxSubscriptions; ++i)
+            {
+                if ((targets & (1U << i)) != 0 && !endpoint->subscriptions[i].audio.push(frame))
+                    releaseFrame(frame);
+            }
+        }
+    }
+
+    endpoint->numBusy.fetch_sub(1, std::memory_order_seq_cst);
+}
+
+void NdiInProcessPublisher::publishVideo(const juce::Image& image)
+{
+    if (endpoint == nullptr || !image.isValid()) return;
+
+    endpoint->numBusy.fetch_add(1, std::memory_order_seq_cst);
+
+    int num_targets = 0;
+    const uint32_t targets = getActiveSubscriptions(*endpoint, num_targets);
+
+    if (num_targets > 0)
+    {
+        const juce::Image argb_image = image.convertedToFormat(juce::Image::ARGB);
+        const juce::Image::BitmapData source(argb_image, juce::Image::BitmapData::readOnly);
+
+        const int width = argb_image.getWidth();
+        const int height = argb_image.getHeight();
+        const size_t line_size = (size_t)width * 4;
+
+        // Video frames are not pooled, the rate is low and the size may change at any time.
+        if (auto* frame = createFrame(line_size * (size_t)height, orphanedFlag + num_targets))
+        {
+            frame->width = width;
+            frame->height = height;
+
+            for (int y = 0; y < height; ++y)
+                std::memcpy(frame->getData() + line_size * (size_t)y, source.getLinePointer(y), line_size);
+
+            for (int i = 0; i < maxSubscriptions; ++i)
+            {
+                if ((targets & (1U << i)) != 0 && !endpoint->subscriptions[i].video.push(frame))
+                    releaseFrame(frame);
+            }
+        }
+    }
+
+    endpoint->numBusy.fetch_sub(1, std::memory_order_seq_cst);
+}
+
+NdiInProcessFrame* NdiInProcessPublisher::acquireAudioFrame(size_t dataSize)
+{
+    for (int n = 0; n < audioPoolSize; ++n)
+    {
+        auto* frame = audioPool[nextAudioPoolIndex];
+        nextAudioPoolIndex = (nextAudioPoolIndex + 1) % audioPoolSize;
+
+        // Not prepared for, or still held by a subscriber.
+        if (frame == nullptr || frame->capacity < dataSize || frame->refCount.load(std::memory_order_acquire) != 0) continue;
+
+        return frame;
+    }
+
+    // Every block is still held and the subscribers are not keeping up, or the host sent a larger block
+    // than it prepared for. Either way this one is dropped.
+    return nullptr;
+}
+
+//==============================================================================
+NdiInProcessSubscriber::NdiInProcessSubscriber()
+{
+}
+
+NdiInProcessSubscriber::~NdiInProcessSubscriber()
+{
+    detach();
+}
+
+bool NdiInProcessSubscriber::attach(const juce::String& ndiName)
+{
+    detach();
+
+    auto* state = getRouterState();
+    if (state == nullptr) return false;
+
+    const std::string name = ndiName.toStdString();
+
+    const juce::SpinLock::ScopedLockType sl(attachLock);
+    const juce::SpinLock::ScopedLockType video_read_lock(videoReadLock);
+    const juce::SpinLock::ScopedLockType audio_read_lock(audioReadLock);
+    RegistryLock registry_lock(*state);
+
+    for (auto& candidate : state->endpoints)
+    {
+        if (candidate.state.load(std::memory_order_relaxed) != kOpen || name != candidate.name) continue;
+
+        for (int i = 0; i < maxSubscriptions; ++i)
+        {
+            auto& subscription = candidate.subscriptions[i];
+            if (subscription.isUsed.load(std::memory_order_relaxed) != 0) continue;
+
+            subscription.isUsed.store(1);
+            candidate.numSubscribers.fetch_add(1);
+            subscription.isActive.store(1, std::memory_order_seq_cst);
+
+            subscriptionIndex = i;
+            endpoint.store(&candidate, std::memory_order_release);
+            return true;
+        }
+
+        // Every subscription of this sender is taken.
+        return false;
+    }
+
+    return false;
+}
+
+void NdiInProcessSubscriber::detach()
+{
+    const juce::SpinLock::ScopedLockType sl(attachLock);
+    const juce::SpinLock::ScopedLockType video_read_lock(videoReadLock);
+    const juce::SpinLock::ScopedLockType audio_read_lock(audioReadLock);
+
+    auto* p_endpoint = endpoint.load(std::memory_order_relaxed);
+    if (p_endpoint == nullptr) return;
+
+    auto& subscription = p_endpoint->subscriptions[subscriptionIndex];
+    subscription.isActive.store(0, std::memory_order_seq_cst);
+
+    // A publish that saw us active may still be pushing, the queues are only ours again after it.
+    while (p_endpoint->numBusy.load(std::memory_order_seq_cst) != 0)
+        std::this_thread::yield();
+
+    while (auto* frame = subscription.audio.pop()) releaseFrame(frame);
+    while (auto* frame = subscription.video.pop()) releaseFrame(frame);
+
+    if (heldAudioFrame != nullptr)
+    {
+        releaseFrame(heldAudioFrame);
+        heldAudioFrame = nullptr;
+    }
+
+    {
+        RegistryLock registry_lock(*getRouterState());
+
+        subscription.isUsed.store(0);
+
+        // The last subscriber of a sender that went away frees its slot.
+        if (p_endpoint->numSubscribers.fetch_sub(1) == 1 && p_endpoint->state.load() == kClosed)
+            p_endpoint->state.store(kFree);
+    }
+
+    endpoint.store(nullptr, std::memory_order_release);
+    subscriptionIndex = -1;
+}
+
+bool NdiInProcessSubscriber::isAttached() const
+{
+    return endpoint.load(std::memory_order_acquire) != nullptr;
+}
+
+bool NdiInProcessSubscriber::isPublisherGone() const
+{
+    // Asked again on the next frame if attach() or detach() is running right now.
+    const juce::SpinLock::ScopedTryLockType sl(attachLock);
+    if (!sl.isLocked()) return false;
+
+    const auto* p_endpoint = endpoint.load(std::memory_order_relaxed);
+    return p_endpoint != nullptr && p_endpoint->state.load(std::memory_order_acquire) == kClosed;
+}
+
+int NdiInProcessSubscriber::readAudio(juce::AudioBuffer<float>& buffer)
+{
+    const juce::SpinLock::ScopedTryLockType audio_read_lock(audioReadLock);
+    auto* p_endpoint = endpoint.load(std::memory_order_relaxed);
+    if (!audio_read_lock.isLocked() || p_endpoint == nullptr) return 0;
+
+    auto& queue = p_endpoint->subscriptions[subscriptionIndex].audio;
+
+    // Keep the latency at most a block when the sender got ahead, e.g. after the host skipped this track.
+    while (queue.getNumReady() > maxQueuedAudioFrames)
+        releaseFrame(queue.pop());
+
+    const int num_wanted = buffer.getNumSamples();
+    int num_written = 0;
+
+    while (num_written < num_wanted)
+    {
+        if (heldAudioFrame == nullptr)
+        {
+            heldAudioFrame = queue.pop();
+            heldAudioOffset = 0;
+
+            if (heldAudioFrame == nullptr) break;
+            sampleRate = heldAudioFrame->sampleRate;
+        }
+
+        auto* frame = heldAudioFrame;
+        const int num_samples = juce::jmin(frame->numSamples - heldAudioOffset, num_wanted - num_written);
+        const auto* data = reinterpret_cast<const float*>(frame->getData());
+
+        for (int ch_idx = 0; ch_idx < buffer.getNumChannels(); ++ch_idx)
+        {
+            if (ch_idx < frame->numChannels)
+                juce::FloatVectorOperations::copy(buffer.getWritePointer(ch_idx, num_written), data + ch_idx * frame->numSamples + heldAudioOffset, num_samples);
+            else
+                buffer.clear(ch_idx, num_written, num_samples);
+        }
+
+        num_written += num_samples;
+        heldAudioOffset += num_samples;
+
+        if (heldAudioOffset >= frame->numSamples)
+        {
+            releaseFrame(frame);
+            heldAudioFrame = nullptr;
+        }
+    }
+
+    return num_written;
+}
+
+bool NdiInProcessSubscriber::readVideo(juce::Image& image)
+{
+    // Held through the copy, only attach() and detach() wait for it.
+    const juce::SpinLock::ScopedLockType video_read_lock(videoReadLock);
+    auto* p_endpoint = endpoint.load(std::memory_order_relaxed);
+    if (p_endpoint == nullptr) return false;
+
+    auto& queue = p_endpoint->subscriptions[subscriptionIndex].video;
+
+    // Only the newest frame matters.
+    NdiInProcessFrame* frame = nullptr;
+    while (auto* next = queue.pop())
+    {
+        if (frame != nullptr) releaseFrame(frame);
+        frame = next;
+    }
+
+    if (frame == nullptr) return false;
+
+    // A new image every time, earlier ones may still be queued for painting.
+    image = juce::Image(juce::Image::ARGB, frame->width, frame->height, false);
+    juce::Image::BitmapData dest(image, juce::Image::BitmapData::writeOnly);
+
+    const size_t line_size = (size_t)frame->width * 4;
+    for (int y = 0; y < frame->height; ++y)
+        std::memcpy(dest.getLinePointer(y), frame->getData() + line_size * (size_t)y, line_size);
+
+    releaseFrame(frame);
+    return true;
+}
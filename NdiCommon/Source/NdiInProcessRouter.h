@@ -0,0 +1,123 @@
+/*
+  ==============================================================================
+
+    NdiInProcessRouter.h
+    Created: 19 Oct 2026 9:02:37pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+struct NdiInProcessEndpoint;
+struct NdiInProcessFrame;
+
+//==============================================================================
+/**
+    Hands the frames of one sender directly to receivers in the same process.
+
+    Senders register under their NDI name in a process-global registry, and
+    every frame is published once as a reference-counted block that all the
+    attached receivers share, with no encode, network or per-receiver copies.
+
+    The registry is plain data found through a named mapping keyed on the
+    process id, so it is shared by plugins living in different binaries.
+    Nothing in it refers to code, so either plugin can be unloaded first.
+*/
+class NdiInProcessPublisher
+{
+public:
+    //==============================================================================
+    explicit NdiInProcessPublisher(const juce::String& ndiName);
+    ~NdiInProcessPublisher();
+
+    //==============================================================================
+    bool isOpen() const;
+    bool hasSubscribers() const;
+
+    //==============================================================================
+    /** Allocates the pool publishAudio() takes its blocks from, e.g. from prepareToPlay().
+        Never call it while publishAudio() may run.
+    */
+    void prepareAudio(int maxNumChannels, int maxNumSamples);
+
+    /** Lock free and never allocates, call it from the audio thread.
+        A block larger than prepareAudio() was told about is dropped.
+    */
+    void publishAudio(const juce::AudioBuffer<float>& buffer, int sampleRate);
+
+    /** Call it from one thread only, e.g. the message thread. */
+    void publishVideo(const juce::Image& image);
+
+private:
+    //==============================================================================
+    NdiInProcessFrame* acquireAudioFrame(size_t dataSize);
+
+    //==============================================================================
+    NdiInProcessEndpoint* endpoint{ nullptr };
+
+    static constexpr int audioPoolSize = 16;
+    NdiInProcessFrame* audioPool[audioPoolSize] = {};
+    int nextAudioPoolIndex{ 0 };
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NdiInProcessPublisher)
+};
+
+//==============================================================================
+/**
+    Receives the frames of an NdiInProcessPublisher in the same process.
+
+    Audio is read from the audio thread, video from one other thread, and
+    attach() and detach() may be called from a third one.
+*/
+class NdiInProcessSubscriber
+{
+public:
+    //==============================================================================
+    NdiInProcessSubscriber();
+    ~NdiInProcessSubscriber();
+
+    //==============================================================================
+    /** Attaches to the publisher with this NDI name (without the host part). */
+    bool attach(const juce::String& ndiName);
+    void detach();
+    bool isAttached() const;
+
+    /** True once the publisher has gone away, the caller should detach. */
+    bool isPublisherGone() const;
+
+    //==============================================================================
+    /** Copies the published audio into the buffer and returns the number of samples written.
+        Never blocks, it returns 0 while attach() or detach() is running.
+    */
+    int readAudio(juce::AudioBuffer<float>& buffer);
+
+    /** Returns the sample rate of the last block read. */
+    int getSampleRate() const { return sampleRate; }
+
+    /** Replaces the image with the newest published frame, if there is one.
+        Waits for attach() or detach(), never for readAudio().
+    */
+    bool readVideo(juce::Image& image);
+
+private:
+    //==============================================================================
+    // Written under attachLock, read without it by isAttached() on the audio thread.
+    std::atomic<NdiInProcessEndpoint*> endpoint{ nullptr };
+    int subscriptionIndex{ -1 };
+
+    NdiInProcessFrame* heldAudioFrame{ nullptr };
+    int heldAudioOffset{ 0 };
+    int sampleRate{ 0 };
+
+    // attach() and detach() take all three, each reader only its own, so a video copy never fails an audio read.
+    mutable juce::SpinLock attachLock;
+    juce::SpinLock audioReadLock;
+    juce::SpinLock videoReadLock;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NdiInProcessSubscriber)
+};
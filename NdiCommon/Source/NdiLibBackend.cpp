@@ -0,0 +1,116 @@
+/*
+  ==============================================================================
+
+    NdiLibBackend.cpp
+    Created: 19 Oct 2026 4:48:02pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include "NdiLibBackend.h"
+
+//==============================================================================
+// Handles are only ever created once the runtime is loaded, so every call taking
+// a handle can use the function table directly.
+
+bool NdiLibBackend::isAvailable()
+{
+    return ndiRuntime->isAvailable();
+}
+
+//==============================================================================
+NDIlib_find_instance_t NdiLibBackend::findCreate()
+{
+    auto* p_ndi_lib = ndiRuntime->getLib();
+    return p_ndi_lib ? p_ndi_lib->NDIlib_find_create_v2(NULL) : nullptr;
+}
+
+void NdiLibBackend::findDestroy(NDIlib_find_instance_t finder)
+{
+    ndiRuntime->getLib()->NDIlib_find_destroy(finder);
+}
+
+bool NdiLibBackend::findWaitForSources(NDIlib_find_instance_t finder, uint32_t timeOutMsec)
+{
+    return ndiRuntime->getLib()->NDIlib_find_wait_for_sources(finder, timeOutMsec);
+}
+
+const NDIlib_source_t* NdiLibBackend::findGetCurrentSources(NDIlib_find_instance_t finder, uint32_t* numSources)
+{
+    return ndiRuntime->getLib()->NDIlib_find_get_current_sources(finder, numSources);
+}
+
+//==============================================================================
+NDIlib_recv_instance_t NdiLibBackend::recvCreate()
+{
+    auto* p_ndi_lib = ndiRuntime->getLib();
+    return p_ndi_lib ? p_ndi_lib->NDIlib_recv_create_v3(NULL) : nullptr;
+}
+
+void NdiLibBackend::recvDestroy(NDIlib_recv_instance_t receiver)
+{
+    ndiRuntime->getLib()->NDIlib_recv_destroy(receiver);
+}
+
+void NdiLibBackend::recvConnect(NDIlib_recv_instance_t receiver, const NDIlib_source_t* source)
+{
+    ndiRuntime->getLib()->NDIlib_recv_connect(receiver, source);
+}
+
+NDIlib_frame_type_e NdiLibBackend::recvCapture(NDIlib_recv_instance_t receiver, NDIlib_video_frame_v2_t* videoFrame, NDIlib_audio_frame_v2_t* audioFrame, uint32_t timeOutMsec)
+{
+    return ndiRuntime->getLib()->NDIlib_recv_capture_v2(receiver, videoFrame, audioFrame, nullptr, timeOutMsec);
+}
+
+void NdiLibBackend::recvFreeVideo(NDIlib_recv_instance_t receiver, const NDIlib_video_frame_v2_t* videoFrame)
+{
+    ndiRuntime->getLib()->NDIlib_recv_free_video_v2(receiver, videoFrame);
+}
+
+void NdiLibBackend::recvFreeAudio(NDIlib_recv_instance_t receiver, const NDIlib_audio_frame_v2_t* audioFrame)
+{
+    ndiRuntime->getLib()->NDIlib_recv_free_audio_v2(receiver, audioFrame);
+}
+
+void NdiLibBackend::recvGetPerformance(NDIlib_recv_instance_t receiver, NDIlib_recv_performance_t* totalFrames, NDIlib_recv_performance_t* droppedFrames)
+{
+    ndiRuntime->getLib()->NDIlib_recv_get_performance(receiver, totalFrames, droppedFrames);
+}
+
+void NdiLibBackend::recvGetQueue(NDIlib_recv_instance_t receiver, NDIlib_recv_queue_t* queue)
+{
+    ndiRuntime->getLib()->NDIlib_recv_get_queue(receiver, queue);
+}
+
+//==============================================================================
+NDIlib_send_instance_t NdiLibBackend::sendCreate(const NDIlib_send_create_t* description)
+{
+    auto* p_ndi_lib = ndiRuntime->getLib();
+    return p_ndi_lib ? p_ndi_lib->NDIlib_send_create(description) : nullptr;
+}
+
+void NdiLibBackend::sendDestroy(NDIlib_send_instance_t sender)
+{
+    ndiRuntime->getLib()->NDIlib_send_destroy(sender);
+}
+
+void NdiLibBackend::sendVideo(NDIlib_send_instance_t sender, const NDIlib_video_frame_v2_t* videoFrame)
+{
+    ndiRuntime->getLib()->NDIlib_send_send_video_v2(sender, videoFrame);
+}
+
+void NdiLibBackend::sendAudio(NDIlib_send_instance_t sender, const NDIlib_audio_frame_v2_t* audioFrame)
+{
+    ndiRuntime->getLib()->NDIlib_send_send_audio_v2(sender, audioFrame);
+}
+
+int NdiLibBackend::sendGetNoConnections(NDIlib_send_instance_t sender, uint32_t timeOutMsec)
+{
+    return ndiRuntime->getLib()->NDIlib_send_get_no_connections(sender, timeOutMsec);
+}
+
+bool NdiLibBackend::sendGetTally(NDIlib_send_instance_t sender, NDIlib_tally_t* tally, uint32_t timeOutMsec)
+{
+    return ndiRuntime->getLib()->NDIlib_send_get_tally(sender, tally, timeOutMsec);
+}
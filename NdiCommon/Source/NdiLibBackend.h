@@ -0,0 +1,56 @@
+/*
+  ==============================================================================
+
+    NdiLibBackend.h
+    Created: 19 Oct 2026 4:48:02pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "NdiBackend.h"
+#include "NdiRuntime.h"
+
+//==============================================================================
+/**
+    The real NDI transport, calling through the shared NdiRuntime function table.
+*/
+class NdiLibBackend : public NdiBackend
+{
+public:
+    //==============================================================================
+    NdiLibBackend() = default;
+    ~NdiLibBackend() override = default;
+
+    //==============================================================================
+    bool isAvailable() override;
+
+    NDIlib_find_instance_t findCreate() override;
+    void findDestroy(NDIlib_find_instance_t finder) override;
+    bool findWaitForSources(NDIlib_find_instance_t finder, uint32_t timeOutMsec) override;
+    const NDIlib_source_t* findGetCurrentSources(NDIlib_find_instance_t finder, uint32_t* numSources) override;
+
+    NDIlib_recv_instance_t recvCreate() override;
+    void recvDestroy(NDIlib_recv_instance_t receiver) override;
+    void recvConnect(NDIlib_recv_instance_t receiver, const NDIlib_source_t* source) override;
+    NDIlib_frame_type_e recvCapture(NDIlib_recv_instance_t receiver, NDIlib_video_frame_v2_t* videoFrame, NDIlib_audio_frame_v2_t* audioFrame, uint32_t timeOutMsec) override;
+    void recvFreeVideo(NDIlib_recv_instance_t receiver, const NDIlib_video_frame_v2_t* videoFrame) override;
+    void recvFreeAudio(NDIlib_recv_instance_t receiver, const NDIlib_audio_frame_v2_t* audioFrame) override;
+    void recvGetPerformance(NDIlib_recv_instance_t receiver, NDIlib_recv_performance_t* totalFrames, NDIlib_recv_performance_t* droppedFrames) override;
+    void recvGetQueue(NDIlib_recv_instance_t receiver, NDIlib_recv_queue_t* queue) override;
+
+    NDIlib_send_instance_t sendCreate(const NDIlib_send_create_t* description) override;
+    void sendDestroy(NDIlib_send_instance_t sender) override;
+    void sendVideo(NDIlib_send_instance_t sender, const NDIlib_video_frame_v2_t* videoFrame) override;
+    void sendAudio(NDIlib_send_instance_t sender, const NDIlib_audio_frame_v2_t* audioFrame) override;
+    int sendGetNoConnections(NDIlib_send_instance_t sender, uint32_t timeOutMsec) override;
+    bool sendGetTally(NDIlib_send_instance_t sender, NDIlib_tally_t* tally, uint32_t timeOutMsec) override;
+
+private:
+    //==============================================================================
+    juce::SharedResourcePointer<NdiRuntime> ndiRuntime;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NdiLibBackend)
+};
@@ -0,0 +1,477 @@
+/*
+  ==============================================================================
+
+    NdiLoopbackBackend.cpp
+    Created: 19 Oct 2026 4:48:02pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include "NdiLoopbackBackend.h"
+#include "NdiRecordingFormat.h"
+#include <deque>
+#include <map>
+
+//==============================================================================
+struct NdiLoopbackBackend::Frame
+{
+    NDIlib_frame_type_e type{ NDIlib_frame_type_none };
+    NDIlib_video_frame_v2_t video;
+    NDIlib_audio_frame_v2_t audio;
+    juce::HeapBlock<uint8_t> data;
+    double dueMsec{ 0.0 };
+};
+
+struct NdiLoopbackBackend::Sender
+{
+    std::string ndiName;
+    std::string urlAddress;
+    juce::Array<Receiver*> receivers;
+
+    // Fractional sample position carried between audio frames while simulating drift.
+    double driftRemainder{ 0.0 };
+};
+
+struct NdiLoopbackBackend::Receiver
+{
+    std::string wantedNdiName;
+    Sender* connected{ nullptr };
+
+    std::deque<std::unique_ptr<Frame>> queue;
+    std::map<const void*, std::unique_ptr<Frame>> outstanding;
+    juce::WaitableEvent frameArrived;
+
+    // Counted like NDI does: every frame sent to this receiver, and the ones lost or pushed out of the queue.
+    NDIlib_recv_performance_t totalFrames{ 0, 0, 0 };
+    NDIlib_recv_performance_t droppedFrames{ 0, 0, 0 };
+
+    void countFrame(NDIlib_frame_type_e type, NDIlib_recv_performance_t& performance)
+    {
+        if (type == NDIlib_frame_type_video) ++performance.video_frames;
+        else if (type == NDIlib_frame_type_audio) ++performance.audio_frames;
+    }
+};
+
+struct NdiLoopbackBackend::Finder
+{
+    std::vector<std::string> names;
+    std::vector<std::string> urls;
+    std::vector<NDIlib_source_t> sources;
+    bool hasChanged{ true };
+    juce::WaitableEvent sourcesChanged;
+};
+
+//==============================================================================
+NdiLoopbackBackend::NdiLoopbackBackend()
+    : NdiLoopbackBackend(Settings())
+{
+}
+
+NdiLoopbackBackend::NdiLoopbackBackend(const Settings& settings_)
+    : settings(settings_)
+    , random(settings_.randomSeed)
+{
+}
+
+NdiLoopbackBackend::~NdiLoopbackBackend()
+{
+    // Every handle has to be destroyed by its owner before the backend goes away.
+    jassert(senders.isEmpty() && receivers.isEmpty() && finders.isEmpty());
+}
+
+void NdiLoopbackBackend::setSettings(const Settings& newSettings)
+{
+    const juce::ScopedLock sl(lock);
+    settings = newSettings;
+    random.setSeed(settings.randomSeed);
+}
+
+NdiLoopbackBackend::Settings NdiLoopbackBackend::getSettings() const
+{
+    const juce::ScopedLock sl(lock);
+    return settings;
+}
+
+int NdiLoopbackBackend::getNumHandles() const
+{
+    const juce::ScopedLock sl(lock);
+    return finders.size() + receivers.size() + senders.size();
+}
+
+//==============================================================================
+NDIlib_find_instance_t NdiLoopbackBackend::findCreate()
+{
+    const juce::ScopedLock sl(lock);
+    return finders.add(new Finder());
+}
+
+void NdiLoopbackBackend::findDestroy(NDIlib_find_instance_t finder)
+{
+    const juce::ScopedLock sl(lock);
+    finders.removeObject(static_cast<Finder*>(finder));
+}
+
+bool NdiLoopbackBackend::findWaitForSources(NDIlib_find_instance_t finder, uint32_t timeOutMsec)
+{
+    auto* p_finder = static_cast<Finder*>(finder);
+
+    {
+        const juce::ScopedLock sl(lock);
+        if (p_finder->hasChanged)
+            return true;
+    }
+
+    p_finder->sourcesChanged.wait((int)timeOutMsec);
+
+    const juce::ScopedLock sl(lock);
+    return p_finder->hasChanged;
+}
+
+const NDIlib_source_t* NdiLoopbackBackend::findGetCurrentSources(NDIlib_find_instance_t finder, uint32_t* numSources)
+{
+    const juce::ScopedLock sl(lock);
+
+    auto* p_finder = static_cast<Finder*>(finder);
+    p_finder->hasChanged = false;
+
+    // Copy the strings first, the source array points into them.
+    p_finder->names.clear();
+    p_finder->urls.clear();
+    for (auto* sender : senders)
+    {
+        p_finder->names.push_back(sender->ndiName);
+        p_finder->urls.push_back(sender->urlAddress);
+    }
+
+    p_finder->sources.resize(p_finder->names.size());
+    for (size_t idx = 0; idx < p_finder->sources.size(); ++idx)
+    {
+        p_finder->sources[idx].p_ndi_name = p_finder->names[idx].c_str();
+        p_finder->sources[idx].p_url_address = p_finder->urls[idx].c_str();
+    }
+
+    *numSources = (uint32_t)p_finder->sources.size();
+    return p_finder->sources.data();
+}
+
+//==============================================================================
+NDIlib_recv_instance_t NdiLoopbackBackend::recvCreate()
+{
+    const juce::ScopedLock sl(lock);
+    return receivers.add(new Receiver());
+}
+
+void NdiLoopbackBackend::recvDestroy(NDIlib_recv_instance_t receiver)
+{
+    const juce::ScopedLock sl(lock);
+
+    auto* p_receiver = static_cast<Receiver*>(receiver);
+    if (p_receiver->connected)
+        p_receiver->connected->receivers.removeFirstMatchingValue(p_receiver);
+
+    receivers.removeObject(p_receiver);
+}
+
+void NdiLoopbackBackend::recvConnect(NDIlib_recv_instance_t receiver, const NDIlib_source_t* source)
+{
+    const juce::ScopedLock sl(lock);
+
+    auto* p_receiver = static_cast<Receiver*>(receiver);
+    if (p_receiver->connected)
+        p_receiver->connected->receivers.removeFirstMatchingValue(p_receiver);
+
+    p_receiver->connected = nullptr;
+    p_receiver->wantedNdiName = (source && source->p_ndi_name) ? source->p_ndi_name : "";
+    p_receiver->queue.clear();
+
+    // Like NDI, connecting to a source which does not exist yet waits for it to appear.
+    for (auto* sender : senders)
+    {
+        if (sender->ndiName == p_receiver->wantedNdiName)
+        {
+            p_receiver->connected = sender;
+            sender->receivers.add(p_receiver);
+            break;
+        }
+    }
+}
+
+NDIlib_frame_type_e NdiLoopbackBackend::recvCapture(NDIlib_recv_instance_t receiver, NDIlib_video_frame_v2_t* videoFrame, NDIlib_audio_frame_v2_t* audioFrame, uint32_t timeOutMsec)
+{
+    auto* p_receiver = static_cast<Receiver*>(receiver);
+    const double deadline_msec = juce::Time::getMillisecondCounterHiRes() + timeOutMsec;
+
+    for (;;)
+    {
+        const double now_msec = juce::Time::getMillisecondCounterHiRes();
+        double wait_msec = deadline_msec - now_msec;
+
+        {
+            const juce::ScopedLock sl(lock);
+
+            auto& queue = p_receiver->queue;
+            while (!queue.empty())
+            {
+                auto& head = queue.front();
+
+                // Frames arrive in order, a late head holds back everything behind it.
+                if (head->dueMsec > now_msec)
+                {
+                    wait_msec = juce::jmin(wait_msec, head->dueMsec - now_msec);
+                    break;
+                }
+
+                // Only hand out the kinds of frame the caller asked for.
+                const bool is_wanted = (head->type == NDIlib_frame_type_video && videoFrame)
+                                    || (head->type == NDIlib_frame_type_audio && audioFrame);
+                if (!is_wanted)
+                {
+                    queue.pop_front();
+                    continue;
+                }
+
+                std::unique_ptr<Frame> frame = std::move(head);
+                queue.pop_front();
+
+                const NDIlib_frame_type_e type = frame->type;
+                if (type == NDIlib_frame_type_video)
+                    *videoFrame = frame->video;
+                else
+                    *audioFrame = frame->audio;
+
+                const void* key = frame->data.get();
+                p_receiver->outstanding[key] = std::move(frame);
+                return type;
+            }
+        }
+
+        if (wait_msec <= 0.0)
+            return NDIlib_frame_type_none;
+
+        p_receiver->frameArrived.wait(juce::jmax(1, (int)std::ceil(wait_msec)));
+    }
+}
+
+void NdiLoopbackBackend::recvFreeVideo(NDIlib_recv_instance_t receiver, const NDIlib_video_frame_v2_t* videoFrame)
+{
+    const juce::ScopedLock sl(lock);
+    static_cast<Receiver*>(receiver)->outstanding.erase(videoFrame->p_data);
+}
+
+void NdiLoopbackBackend::recvFreeAudio(NDIlib_recv_instance_t receiver, const NDIlib_audio_frame_v2_t* audioFrame)
+{
+    const juce::ScopedLock sl(lock);
+    static_cast<Receiver*>(receiver)->outstanding.erase(audioFrame->p_data);
+}
+
+void NdiLoopbackBackend::recvGetPerformance(NDIlib_recv_instance_t receiver, NDIlib_recv_performance_t* totalFrames, NDIlib_recv_performance_t* droppedFrames)
+{
+    const juce::ScopedLock sl(lock);
+
+    auto* p_receiver = static_cast<Receiver*>(receiver);
+    if (totalFrames) *totalFrames = p_receiver->totalFrames;
+    if (droppedFrames) *droppedFrames = p_receiver->droppedFrames;
+}
+
+void NdiLoopbackBackend::recvGetQueue(NDIlib_recv_instance_t receiver, NDIlib_recv_queue_t* queue)
+{
+    const juce::ScopedLock sl(lock);
+
+    queue->video_frames = 0;
+    queue->audio_frames = 0;
+    queue->metadata_frames = 0;
+
+    for (const auto& frame : static_cast<Receiver*>(receiver)->queue)
+    {
+        if (frame->type == NDIlib_frame_type_video) ++queue->video_frames;
+        else if (frame->type == NDIlib_frame_type_audio) ++queue->audio_frames;
+    }
+}
+
+//==============================================================================
+NDIlib_send_instance_t NdiLoopbackBackend::sendCreate(const NDIlib_send_create_t* description)
+{
+    const juce::ScopedLock sl(lock);
+
+    auto* sender = senders.add(new Sender());
+    const int sender_id = nextSenderId++;
+
+    sender->ndiName = (description && description->p_ndi_name) ? description->p_ndi_name
+                                                               : ("Loopback " + juce::String(sender_id)).toStdString();
+    sender->urlAddress = ("loopback://" + juce::String(sender_id)).toStdString();
+
+    // Pick up receivers which were waiting for this name.
+    for (auto* receiver : receivers)
+    {
+        if (receiver->connected == nullptr && receiver->wantedNdiName == sender->ndiName)
+        {
+            receiver->connected = sender;
+            sender->receivers.add(receiver);
+        }
+    }
+
+    notifyFinders();
+    return sender;
+}
+
+void NdiLoopbackBackend::sendDestroy(NDIlib_send_instance_t sender)
+{
+    const juce::ScopedLock sl(lock);
+
+    auto* p_sender = static_cast<Sender*>(sender);
+    for (auto* receiver : p_sender->receivers)
+        receiver->connected = nullptr;
+
+    senders.removeObject(p_sender);
+    notifyFinders();
+}
+
+void NdiLoopbackBackend::sendVideo(NDIlib_send_instance_t sender, const NDIlib_video_frame_v2_t* videoFrame)
+{
+    // Like NDI, a FourCC it does not know is never delivered.
+    const size_t data_size = NdiRecordingFormat::getVideoDataBytes(*videoFrame);
+    if (data_size == 0) return;
+
+    auto frame = std::make_unique<Frame>();
+    frame->type = NDIlib_frame_type_video;
+    frame->video = *videoFrame;
+    frame->video.p_metadata = NULL;
+
+    frame->data.malloc(data_size);
+    if (videoFrame->p_data)
+        std::memcpy(frame->data.get(), videoFrame->p_data, data_size);
+    frame->video.p_data = frame->data.get();
+
+    const juce::ScopedLock sl(lock);
+    deliver(*static_cast<Sender*>(sender), std::move(frame));
+}
+
+void NdiLoopbackBackend::sendAudio(NDIlib_send_instance_t sender, const NDIlib_audio_frame_v2_t* audioFrame)
+{
+    const juce::ScopedLock sl(lock);
+
+    auto* p_sender = static_cast<Sender*>(sender);
+
+    // A sender clock running fast produces more samples per receiver second, and the other way round.
+    const double drift_ratio = 1.0 + settings.clockDriftPpm * 1.0e-6;
+    const double exact_num_samples = audioFrame->no_samples * drift_ratio + p_sender->driftRemainder;
+    const int num_samples = juce::jmax(0, (int)exact_num_samples);
+    p_sender->driftRemainder = exact_num_samples - num_samples;
+
+    auto frame = std::make_unique<Frame>();
+    frame->type = NDIlib_frame_type_audio;
+    frame->audio = *audioFrame;
+    frame->audio.p_metadata = NULL;
+    frame->audio.no_samples = num_samples;
+    frame->audio.channel_stride_in_bytes = num_samples * (int)sizeof(float);
+
+    frame->data.malloc(juce::jmax((size_t)1, (size_t)frame->audio.channel_stride_in_bytes * (size_t)audioFrame->no_channels));
+    auto* dest = reinterpret_cast<float*>(frame->data.get());
+
+    for (int ch_idx = 0; ch_idx < audioFrame->no_channels; ++ch_idx)
+    {
+        const float* src_ch = reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(audioFrame->p_data) + (size_t)ch_idx * audioFrame->channel_stride_in_bytes);
+        float* dest_ch = dest + (size_t)ch_idx * num_samples;
+
+        if (num_samples == audioFrame->no_samples)
+        {
+            juce::FloatVectorOperations::copy(dest_ch, src_ch, num_samples);
+            continue;
+        }
+
+        // Linear resampling is plenty to simulate a few hundred ppm.
+        const double step = num_samples > 1 ? (double)(audioFrame->no_samples - 1) / (double)(num_samples - 1) : 0.0;
+        for (int smp_idx = 0; smp_idx < num_samples; ++smp_idx)
+        {
+            const double pos = smp_idx * step;
+            const int pos_int = (int)pos;
+            const int next_int = juce::jmin(pos_int + 1, audioFrame->no_samples - 1);
+            const float frac = (float)(pos - pos_int);
+            dest_ch[smp_idx] = src_ch[pos_int] + (src_ch[next_int] - src_ch[pos_int]) * frac;
+        }
+    }
+
+    frame->audio.p_data = dest;
+    deliver(*p_sender, std::move(frame));
+}
+
+int NdiLoopbackBackend::sendGetNoConnections(NDIlib_send_instance_t sender, uint32_t timeOutMsec)
+{
+    juce::ignoreUnused(timeOutMsec);
+
+    const juce::ScopedLock sl(lock);
+    return static_cast<Sender*>(sender)->receivers.size();
+}
+
+bool NdiLoopbackBackend::sendGetTally(NDIlib_send_instance_t sender, NDIlib_tally_t* tally, uint32_t timeOutMsec)
+{
+    juce::ignoreUnused(sender, timeOutMsec);
+
+    // Loopback receivers never set tally.
+    tally->on_program = false;
+    tally->on_preview = false;
+    return false;
+}
+
+//==============================================================================
+void NdiLoopbackBackend::deliver(Sender& sender, std::unique_ptr<Frame> frame)
+{
+    // Called with the lock held.
+    const double now_msec = juce::Time::getMillisecondCounterHiRes();
+
+    for (int idx = 0; idx < sender.receivers.size(); ++idx)
+    {
+        auto* receiver = sender.receivers.getUnchecked(idx);
+        receiver->countFrame(frame->type, receiver->totalFrames);
+
+        if (settings.lossProbability > 0.0 && random.nextDouble() < settings.lossProbability)
+        {
+            receiver->countFrame(frame->type, receiver->droppedFrames);
+            continue;
+        }
+
+        // The last receiver can take the frame itself, the others get copies.
+        std::unique_ptr<Frame> copy;
+        if (idx == sender.receivers.size() - 1)
+        {
+            copy = std::move(frame);
+        }
+        else
+        {
+            const size_t data_size = frame->type == NDIlib_frame_type_video
+                ? NdiRecordingFormat::getVideoDataBytes(frame->video)
+                : (size_t)frame->audio.channel_stride_in_bytes * (size_t)frame->audio.no_channels;
+
+            copy = std::make_unique<Frame>();
+            copy->type = frame->type;
+            copy->video = frame->video;
+            copy->audio = frame->audio;
+            copy->data.malloc(juce::jmax((size_t)1, data_size));
+            std::memcpy(copy->data.get(), frame->data.get(), data_size);
+            copy->video.p_data = copy->data.get();
+            copy->audio.p_data = reinterpret_cast<float*>(copy->data.get());
+        }
+
+        copy->dueMsec = now_msec + (settings.jitterMsec > 0 ? random.nextInt(settings.jitterMsec + 1) : 0);
+
+        receiver->queue.push_back(std::move(copy));
+        while ((int)receiver->queue.size() > settings.maxQueuedFrames)
+        {
+            receiver->countFrame(receiver->queue.front()->type, receiver->droppedFrames);
+            receiver->queue.pop_front();
+        }
+
+        receiver->frameArrived.signal();
+    }
+}
+
+void NdiLoopbackBackend::notifyFinders()
+{
+    // Called with the lock held.
+    for (auto* finder : finders)
+    {
+        finder->hasChanged = true;
+        finder->sourcesChanged.signal();
+    }
+}
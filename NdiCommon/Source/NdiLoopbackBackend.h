@@ -0,0 +1,106 @@
+/*
+  ==============================================================================
+
+    NdiLoopbackBackend.h
+    Created: 19 Oct 2026 4:48:02pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "NdiBackend.h"
+
+//==============================================================================
+/**
+    An in-process transport connecting senders to receivers through memory.
+
+    Every sender created on the same loopback instance shows up as a source, and
+    every frame sent is copied into the queues of the receivers connected to it.
+    Network effects can be simulated deterministically from a random seed, so
+    the plugin pipelines can run headless on machines without NDI or a network.
+*/
+class NdiLoopbackBackend : public NdiBackend
+{
+public:
+    //==============================================================================
+    struct Settings
+    {
+        /** Each frame is delivered after a random delay between 0 and this. */
+        int jitterMsec{ 0 };
+
+        /** The probability for each frame of being dropped, from 0 to 1. */
+        double lossProbability{ 0.0 };
+
+        /** How much faster the sender clock runs than the receiver clock.
+            Audio is resampled in flight, so receivers get more or fewer samples than they expect.
+        */
+        double clockDriftPpm{ 0.0 };
+
+        /** The seed for jitter and loss, the same seed reproduces the same run. */
+        juce::int64 randomSeed{ 1 };
+
+        /** Per receiver, the oldest frames are dropped beyond this. */
+        int maxQueuedFrames{ 64 };
+    };
+
+    //==============================================================================
+    NdiLoopbackBackend();
+    explicit NdiLoopbackBackend(const Settings& settings);
+    ~NdiLoopbackBackend() override;
+
+    //==============================================================================
+    void setSettings(const Settings& newSettings);
+    Settings getSettings() const;
+
+    /** The finders, receivers and senders not destroyed yet, 0 once every owner is gone. */
+    int getNumHandles() const;
+
+    //==============================================================================
+    bool isAvailable() override { return true; }
+
+    NDIlib_find_instance_t findCreate() override;
+    void findDestroy(NDIlib_find_instance_t finder) override;
+    bool findWaitForSources(NDIlib_find_instance_t finder, uint32_t timeOutMsec) override;
+    const NDIlib_source_t* findGetCurrentSources(NDIlib_find_instance_t finder, uint32_t* numSources) override;
+
+    NDIlib_recv_instance_t recvCreate() override;
+    void recvDestroy(NDIlib_recv_instance_t receiver) override;
+    void recvConnect(NDIlib_recv_instance_t receiver, const NDIlib_source_t* source) override;
+    NDIlib_frame_type_e recvCapture(NDIlib_recv_instance_t receiver, NDIlib_video_frame_v2_t* videoFrame, NDIlib_audio_frame_v2_t* audioFrame, uint32_t timeOutMsec) override;
+    void recvFreeVideo(NDIlib_recv_instance_t receiver, const NDIlib_video_frame_v2_t* videoFrame) override;
+    void recvFreeAudio(NDIlib_recv_instance_t receiver, const NDIlib_audio_frame_v2_t* audioFrame) override;
+    void recvGetPerformance(NDIlib_recv_instance_t receiver, NDIlib_recv_performance_t* totalFrames, NDIlib_recv_performance_t* droppedFrames) override;
+    void recvGetQueue(NDIlib_recv_instance_t receiver, NDIlib_recv_queue_t* queue) override;
+
+    NDIlib_send_instance_t sendCreate(const NDIlib_send_create_t* description) override;
+    void sendDestroy(NDIlib_send_instance_t sender) override;
+    void sendVideo(NDIlib_send_instance_t sender, const NDIlib_video_frame_v2_t* videoFrame) override;
+    void sendAudio(NDIlib_send_instance_t sender, const NDIlib_audio_frame_v2_t* audioFrame) override;
+    int sendGetNoConnections(NDIlib_send_instance_t sender, uint32_t timeOutMsec) override;
+    bool sendGetTally(NDIlib_send_instance_t sender, NDIlib_tally_t* tally, uint32_t timeOutMsec) override;
+
+private:
+    //==============================================================================
+    struct Frame;
+    struct Sender;
+    struct Receiver;
+    struct Finder;
+
+    //==============================================================================
+    void deliver(Sender& sender, std::unique_ptr<Frame> frame);
+    void notifyFinders();
+
+    //==============================================================================
+    juce::CriticalSection lock;
+    Settings settings;
+    juce::Random random;
+
+    juce::OwnedArray<Sender> senders;
+    juce::OwnedArray<Receiver> receivers;
+    juce::OwnedArray<Finder> finders;
+    int nextSenderId{ 1 };
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NdiLoopbackBackend)
+};
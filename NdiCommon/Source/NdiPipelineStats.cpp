@@ -0,0 +1,220 @@
+/*
+  ==============================================================================
+
+    NdiPipelineStats.cpp
+    Created: 19 Oct 2026 11:41:52pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include "NdiPipelineStats.h"
+
+//==============================================================================
+namespace
+{
+    template <typename ValueType>
+    void storeMax(std::atomic<ValueType>& target, ValueType value) noexcept
+    {
+        auto previous = target.load(std::memory_order_relaxed);
+        while (value > previous && !target.compare_exchange_weak(previous, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    juce::String formatMicroseconds(double microseconds)
+    {
+        if (microseconds >= 1000.0)
+            return juce::String(microseconds / 1000.0, 1) + "ms";
+
+        return juce::String((int)microseconds) + "us";
+    }
+
+    juce::String formatHistogram(const juce::String& name, const NdiPipelineStats::Histogram& histogram)
+    {
+        if (histogram.getCount() == 0)
+            return name + " -";
+
+        return name + " p50<" + formatMicroseconds(histogram.getPercentileMicroseconds(50.0))
+            + " p99<" + formatMicroseconds(histogram.getPercentileMicroseconds(99.0))
+            + " max " + formatMicroseconds(histogram.getMaxMicroseconds());
+    }
+
+    /** Like "0,2-3". */
+    juce::String formatCpuMask(juce::uint64 mask)
+    {
+        juce::StringArray ranges;
+        for (int cpu = 0; cpu < 64; ++cpu)
+        {
+            if ((mask >> cpu & 1) == 0)
+                continue;
+
+            int last = cpu;
+            while (last < 63 && (mask >> (last + 1) & 1) != 0)
+                ++last;
+
+            ranges.add(last == cpu ? juce::String(cpu) : juce::String(cpu) + "-" + juce::String(last));
+            cpu = last;
+        }
+        return ranges.joinIntoString(",");
+    }
+}
+
+//==============================================================================
+void NdiPipelineStats::Gauge::set(int newValue) noexcept
+{
+    value.store(newValue, std::memory_order_relaxed);
+    storeMax(highWater, newValue);
+}
+
+void NdiPipelineStats::Gauge::reset() noexcept
+{
+    value.store(0, std::memory_order_relaxed);
+    highWater.store(0, std::memory_order_relaxed);
+}
+
+//==============================================================================
+void NdiPipelineStats::Histogram::add(double microseconds) noexcept
+{
+    int bucket = 0;
+    while (bucket < numBuckets - 1 && microseconds >= getBucketUpperMicroseconds(bucket))
+        ++bucket;
+
+    const auto nanoseconds = (juce::uint64)juce::jmax(0.0, microseconds * 1000.0);
+
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    totalNanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+    storeMax(maxNanoseconds, nanoseconds);
+}
+
+void NdiPipelineStats::Histogram::addSince(juce::int64 startTicks) noexcept
+{
+    add(juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1.0e6);
+}
+
+void NdiPipelineStats::Histogram::reset() noexcept
+{
+    for (auto& bucket : buckets)
+        bucket.store(0, std::memory_order_relaxed);
+
+    count.store(0, std::memory_order_relaxed);
+    totalNanoseconds.store(0, std::memory_order_relaxed);
+    maxNanoseconds.store(0, std::memory_order_relaxed);
+}
+
+double NdiPipelineStats::Histogram::getMeanMicroseconds() const noexcept
+{
+    const auto num_values = getCount();
+    return num_values > 0 ? (double)totalNanoseconds.load(std::memory_order_relaxed) / 1000.0 / (double)num_values : 0.0;
+}
+
+double NdiPipelineStats::Histogram::getMaxMicroseconds() const noexcept
+{
+    return (double)maxNanoseconds.load(std::memory_order_relaxed) / 1000.0;
+}
+
+double NdiPipelineStats::Histogram::getPercentileMicroseconds(double percentile) const noexcept
+{
+    juce::uint64 counts[numBuckets];
+    juce::uint64 num_values = 0;
+    for (int i = 0; i < numBuckets; ++i)
+    {
+        counts[i] = getBucketCount(i);
+        num_values += counts[i];
+    }
+
+    if (num_values == 0)
+        return 0.0;
+
+    const double wanted = (double)num_values * juce::jlimit(0.0, 100.0, percentile) / 100.0;
+    juce::uint64 cumulative = 0;
+    for (int i = 0; i < numBuckets; ++i)
+    {
+        cumulative += counts[i];
+        if ((double)cumulative >= wanted && counts[i] > 0)
+            return getBucketUpperMicroseconds(i);
+    }
+
+    return getBucketUpperMicroseconds(numBuckets - 1);
+}
+
+double NdiPipelineStats::Histogram::getBucketUpperMicroseconds(int bucket) noexcept
+{
+    return std::ldexp(1.0, bucket);
+}
+
+//==============================================================================
+void NdiPipelineStats::ThreadScheduling::set(Scheduler newScheduler, int newPriority, int newNiceValue, juce::uint64 newCpuMask) noexcept
+{
+    scheduler.store(newScheduler, std::memory_order_relaxed);
+    priority.store(newPriority, std::memory_order_relaxed);
+    niceValue.store(newNiceValue, std::memory_order_relaxed);
+    cpuMask.store(newCpuMask, std::memory_order_relaxed);
+}
+
+juce::String NdiPipelineStats::ThreadScheduling::toText() const
+{
+    juce::String text;
+    switch (getScheduler())
+    {
+    case notStarted: return "-";
+    case normal: text = "nice " + juce::String(getNiceValue()); break;
+    case fifo: text = "fifo " + juce::String(getPriority()); break;
+    case roundRobin: text = "rr " + juce::String(getPriority()); break;
+    }
+
+    if (getCpuMask() != 0)
+        text << " cpus " << formatCpuMask(getCpuMask());
+
+    return text;
+}
+
+//==============================================================================
+void NdiPipelineStats::reset() noexcept
+{
+    for (auto* counter : { &videoFramesReceived, &audioFramesReceived, &videoFramesSent, &audioFramesSent,
+                           &framesDropped, &framesOverwritten, &underruns, &underrunsConcealed, &underrunFades, &framesDroppedInNdi, &framesSkipped,
+                           &framesLate, &framesRecorded, &framesNotRecorded })
+        counter->reset();
+
+    for (auto* histogram : { &captureTime, &convertTime, &sendTime })
+        histogram->reset();
+
+    for (auto* gauge : { &audioRingFill, &videoRingFill, &sendQueueAudio, &sendQueueVideo, &ndiQueueAudio, &ndiQueueVideo, &recordBufferFill })
+        gauge->reset();
+
+    resampleRatio.store(1.0f, std::memory_order_relaxed);
+}
+
+juce::StringArray NdiPipelineStats::toText() const
+{
+    juce::StringArray lines;
+
+    lines.add("Received video " + juce::String(videoFramesReceived.get()) + " audio " + juce::String(audioFramesReceived.get())
+        + "  Sent video " + juce::String(videoFramesSent.get()) + " audio " + juce::String(audioFramesSent.get()));
+    lines.add("Dropped " + juce::String(framesDropped.get()) + "  Overwritten " + juce::String(framesOverwritten.get())
+        + "  Underruns " + juce::String(underruns.get())
+        + " (concealed " + juce::String(underrunsConcealed.get()) + ", faded " + juce::String(underrunFades.get()) + ")");
+    lines.add("NDI dropped " + juce::String(framesDroppedInNdi.get()) + "  Skipped " + juce::String(framesSkipped.get())
+        + "  Late " + juce::String(framesLate.get())
+        + "  NDI queue audio " + juce::String(ndiQueueAudio.get()) + " video " + juce::String(ndiQueueVideo.get())
+        + " (high " + juce::String(ndiQueueVideo.getHighWater()) + ")");
+    lines.add(formatHistogram("Capture", captureTime));
+    lines.add(formatHistogram("Convert", convertTime));
+    lines.add(formatHistogram("Send", sendTime));
+    lines.add("Audio ring " + juce::String(audioRingFill.get()) + " (high " + juce::String(audioRingFill.getHighWater()) + ")"
+        + "  Video ring " + juce::String(videoRingFill.get()) + " (high " + juce::String(videoRingFill.getHighWater()) + ")");
+    lines.add("Send queue audio " + juce::String(sendQueueAudio.get()) + " (high " + juce::String(sendQueueAudio.getHighWater()) + ")"
+        + "  video " + juce::String(sendQueueVideo.get()) + " (high " + juce::String(sendQueueVideo.getHighWater()) + ")");
+    if (framesRecorded.get() > 0 || framesNotRecorded.get() > 0)
+        lines.add("Recorded " + juce::String(framesRecorded.get()) + "  Not recorded " + juce::String(framesNotRecorded.get())
+            + "  Record buffer " + juce::String(recordBufferFill.get()) + "% (high " + juce::String(recordBufferFill.getHighWater()) + "%)");
+    lines.add("Resample ratio " + juce::String(resampleRatio.load(std::memory_order_relaxed), 4));
+    if (captureThreads.getScheduler() != ThreadScheduling::notStarted || conversionThreads.getScheduler() != ThreadScheduling::notStarted
+        || sendThreads.getScheduler() != ThreadScheduling::notStarted)
+        lines.add("Threads capture " + captureThreads.toText() + "  convert " + conversionThreads.toText()
+            + "  send " + sendThreads.toText() + "  Refused " + juce::String(threadPolicyRefusals.get()));
+
+    return lines;
+}
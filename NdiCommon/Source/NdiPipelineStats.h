@@ -0,0 +1,162 @@
+/*
+  ==============================================================================
+
+    NdiPipelineStats.h
+    Created: 19 Oct 2026 11:41:52pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Counters for one send or receive pipeline.
+
+    Every value is a relaxed atomic, so the capture, conversion and audio threads
+    update them without locks, and the editors or tests read them at any time.
+    A reading is not a consistent snapshot across values, only each value on its
+    own is exact.
+*/
+class NdiPipelineStats
+{
+public:
+    //==============================================================================
+    class Counter
+    {
+    public:
+        void add(juce::uint64 amount = 1) noexcept { value.fetch_add(amount, std::memory_order_relaxed); }
+        juce::uint64 get() const noexcept { return value.load(std::memory_order_relaxed); }
+        void reset() noexcept { value.store(0, std::memory_order_relaxed); }
+
+    private:
+        std::atomic<juce::uint64> value{ 0 };
+    };
+
+    /** A fill level, e.g. of a ring buffer, with the highest level seen. */
+    class Gauge
+    {
+    public:
+        void set(int newValue) noexcept;
+        int get() const noexcept { return value.load(std::memory_order_relaxed); }
+        int getHighWater() const noexcept { return highWater.load(std::memory_order_relaxed); }
+        void reset() noexcept;
+
+    private:
+        std::atomic<int> value{ 0 };
+        std::atomic<int> highWater{ 0 };
+    };
+
+    /** Durations in power of two buckets, bucket n counts the ones below 2^n microseconds. */
+    class Histogram
+    {
+    public:
+        static constexpr int numBuckets = 24;
+
+        void add(double microseconds) noexcept;
+        void addSince(juce::int64 startTicks) noexcept;
+        void reset() noexcept;
+
+        juce::uint64 getCount() const noexcept { return count.load(std::memory_order_relaxed); }
+        juce::uint64 getBucketCount(int bucket) const noexcept { return buckets[bucket].load(std::memory_order_relaxed); }
+        double getMeanMicroseconds() const noexcept;
+        double getMaxMicroseconds() const noexcept;
+
+        /** The upper bound of the bucket holding this percentile, from 0 to 100. */
+        double getPercentileMicroseconds(double percentile) const noexcept;
+
+        static double getBucketUpperMicroseconds(int bucket) noexcept;
+
+    private:
+        std::atomic<juce::uint64> buckets[numBuckets] = {};
+        std::atomic<juce::uint64> count{ 0 };
+        std::atomic<juce::uint64> totalNanoseconds{ 0 };
+        std::atomic<juce::uint64> maxNanoseconds{ 0 };
+    };
+
+    /** How the threads of one role were scheduled when they last started, see NdiThreadPolicy. */
+    class ThreadScheduling
+    {
+    public:
+        enum Scheduler
+        {
+            notStarted,
+            normal,
+            fifo,
+            roundRobin
+        };
+
+        void set(Scheduler scheduler, int priority, int niceValue, juce::uint64 cpuMask) noexcept;
+
+        Scheduler getScheduler() const noexcept { return (Scheduler)scheduler.load(std::memory_order_relaxed); }
+        int getPriority() const noexcept { return priority.load(std::memory_order_relaxed); }
+        int getNiceValue() const noexcept { return niceValue.load(std::memory_order_relaxed); }
+        /** Bit n for CPU n, 0 if not known. */
+        juce::uint64 getCpuMask() const noexcept { return cpuMask.load(std::memory_order_relaxed); }
+
+        juce::String toText() const;
+
+    private:
+        std::atomic<int> scheduler{ notStarted };
+        std::atomic<int> priority{ 0 };
+        std::atomic<int> niceValue{ 0 };
+        std::atomic<juce::uint64> cpuMask{ 0 };
+    };
+
+    //==============================================================================
+    Counter videoFramesReceived;
+    Counter audioFramesReceived;
+    Counter videoFramesSent;
+    Counter audioFramesSent;
+
+    /** Frames that arrived but did not fit into a full ring buffer, fully or in part. */
+    Counter framesDropped;
+    /** Frames the transport replaced before they were read, e.g. shared-memory overruns. */
+    Counter framesOverwritten;
+    /** Times the audio ran dry while playing, and of those the gaps filled in and the ones that faded out. */
+    Counter underruns;
+    Counter underrunsConcealed;
+    Counter underrunFades;
+    /** Frames the NDI runtime dropped before they could be captured. */
+    Counter framesDroppedInNdi;
+    /** Stale video frames captured but not converted, to catch up with the newest one. */
+    Counter framesSkipped;
+    /** Frames sent more than a frame period after they were due, the sender is not keeping up. */
+    Counter framesLate;
+    /** Captured frames copied to a recording, and the ones left out because the disk was behind. */
+    Counter framesRecorded;
+    Counter framesNotRecorded;
+
+    Histogram captureTime;
+    Histogram convertTime;
+    Histogram sendTime;
+
+    /** In samples for audio, in frames for video. */
+    Gauge audioRingFill;
+    Gauge videoRingFill;
+    Gauge sendQueueAudio;
+    Gauge sendQueueVideo;
+    /** Frames waiting inside the NDI receiver. */
+    Gauge ndiQueueAudio;
+    Gauge ndiQueueVideo;
+    /** In percent of the recorder's buffer. */
+    Gauge recordBufferFill;
+
+    /** Source rate over device rate of the last block resampled. */
+    std::atomic<float> resampleRatio{ 1.0f };
+
+    /** What the worker threads got, kept by reset() since it only changes when they start. */
+    ThreadScheduling captureThreads;
+    ThreadScheduling conversionThreads;
+    ThreadScheduling sendThreads;
+    /** Parts of a thread policy the system refused, e.g. real-time scheduling without the privilege. */
+    Counter threadPolicyRefusals;
+
+    //==============================================================================
+    void reset() noexcept;
+
+    /** One line per group of values, for overlays and logs. */
+    juce::StringArray toText() const;
+};
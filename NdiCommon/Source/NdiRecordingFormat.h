@@ -0,0 +1,178 @@
+/*
+  ==============================================================================
+
+    NdiRecordingFormat.h
+    Created: 19 Oct 2026 5:12:47pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <Processing.NDI.Lib.h>
+
+//==============================================================================
+/**
+    The layout of the frame dumps written by the receiver's NdiRecorder and
+    played back by NdiReplayBackend.
+
+    A file is a header followed by chunks, each aligned to blockSize so the
+    recorder can write them straight from its buffer. A chunk is a ChunkHeader
+    and the frame's data exactly as captured: video planes with their line
+    stride, audio as one run of floats per channel. Closing the file adds an
+    index chunk, and a Trailer as the last bytes that points to it. A file
+    whose recording was cut short has no trailer, but its chunks can still be
+    walked from the start using chunkBytes.
+
+    Everything is stored in the byte order of the machine that recorded it,
+    which is little endian on every platform the plugins are built for.
+*/
+namespace NdiRecordingFormat
+{
+    static constexpr juce::uint32 fileMagic = 0x4345524e;     // "NREC"
+    static constexpr juce::uint32 chunkMagic = 0x4b4e4843;    // "CHNK"
+    static constexpr juce::uint32 trailerMagic = 0x58444e49;  // "INDX"
+    static constexpr juce::uint32 version = 1;
+    static constexpr int blockSize = 4096;
+
+    enum ChunkType : juce::uint32
+    {
+        videoChunk = 1,
+        audioChunk = 2,
+        indexChunk = 3
+    };
+
+    struct FileHeader
+    {
+        juce::uint32 magic;
+        juce::uint32 version;
+        juce::uint32 blockSize;
+        juce::uint32 reserved;
+        juce::int64 createdMillis;
+        char sourceName[256];
+    };
+
+    struct ChunkHeader
+    {
+        juce::uint32 magic;
+        juce::uint32 type;
+        // The frame's data, and the whole chunk including this header and the padding.
+        juce::uint64 payloadBytes;
+        juce::uint64 chunkBytes;
+        // As sent by NDI, in 100ns units.
+        juce::int64 timecode;
+        juce::int64 timestamp;
+        // When the frame was captured, in 100ns units since the recording started.
+        juce::int64 receiveTime;
+
+        // Video frames only.
+        juce::int32 xres;
+        juce::int32 yres;
+        juce::uint32 fourCC;
+        juce::int32 lineStrideBytes;
+        juce::int32 frameRateN;
+        juce::int32 frameRateD;
+        float pictureAspectRatio;
+        juce::int32 frameFormatType;
+
+        // Audio frames only.
+        juce::int32 sampleRate;
+        juce::int32 numChannels;
+        juce::int32 numSamples;
+        juce::int32 reserved;
+    };
+
+    struct IndexEntry
+    {
+        juce::uint64 offset;
+        juce::int64 receiveTime;
+        juce::uint32 type;
+        juce::uint32 reserved;
+    };
+
+    struct Trailer
+    {
+        juce::uint32 magic;
+        juce::uint32 reserved;
+        juce::uint64 indexOffset;
+        juce::uint64 numEntries;
+    };
+
+    static_assert(sizeof(FileHeader) <= blockSize, "The file header has to fit its block");
+    static_assert(sizeof(ChunkHeader) == 96, "The chunk header is part of the file format");
+    static_assert(sizeof(IndexEntry) == 24, "Index entries are part of the file format");
+    static_assert(sizeof(Trailer) == 24, "The trailer is part of the file format");
+
+    /** Rounds a size up to whole blocks. */
+    inline juce::uint64 padToBlock(juce::uint64 numBytes)
+    {
+        return (numBytes + blockSize - 1) & ~(juce::uint64)(blockSize - 1);
+    }
+
+    /** The bytes per pixel of the first plane, for the FourCCs NDI delivers. Zero for unknown ones. */
+    inline int getBytesPerPixel(NDIlib_FourCC_video_type_e fourCC)
+    {
+        switch (fourCC)
+        {
+        case NDIlib_FourCC_video_type_e::NDIlib_FourCC_video_type_UYVY:
+        case NDIlib_FourCC_video_type_e::NDIlib_FourCC_video_type_UYVA:
+        case NDIlib_FourCC_video_type_e::NDIlib_FourCC_video_type_P216:
+        case NDIlib_FourCC_video_type_e::NDIlib_FourCC_video_type_PA16:
+            return 2;
+        case NDIlib_FourCC_video_type_e::NDIlib_FourCC_video_type_YV12:
+        case NDIlib_FourCC_video_type_e::NDIlib_FourCC_video_type_I420:
+        case NDIlib_FourCC_video_type_e::NDIlib_FourCC_video_type_NV12:
+            return 1;
+        case NDIlib_FourCC_video_type_e::NDIlib_FourCC_video_type_BGRA:
+        case NDIlib_FourCC_video_type_e::NDIlib_FourCC_video_type_BGRX:
+        case NDIlib_FourCC_video_type_e::NDIlib_FourCC_video_type_RGBA:
+        case NDIlib_FourCC_video_type_e::NDIlib_FourCC_video_type_RGBX:
+            return 4;
+        default:
+            return 0;
+        }
+    }
+
+    /** The shortest line of the first plane the frame's width allows. Zero for unknown FourCCs. */
+    inline size_t getMinLineStride(const NDIlib_video_frame_v2_t& frame)
+    {
+        return (size_t)juce::jmax(0, frame.xres) * (size_t)getBytesPerPixel(frame.FourCC);
+    }
+
+    /** The line stride of the first plane, where zero means lines are packed. */
+    inline size_t getLineStride(const NDIlib_video_frame_v2_t& frame)
+    {
+        return frame.line_stride_in_bytes > 0 ? (size_t)frame.line_stride_in_bytes : getMinLineStride(frame);
+    }
+
+    /** The bytes of the data of a video frame, for the FourCCs NDI delivers. Zero for unknown ones. */
+    inline size_t getVideoDataBytes(const NDIlib_video_frame_v2_t& frame)
+    {
+        const auto stride = getLineStride(frame);
+        const auto num_lines = (size_t)juce::jmax(0, frame.yres);
+
+        switch (frame.FourCC)
+        {
+        case NDIlib_FourCC_video_type_e::NDIlib_FourCC_video_type_UYVY:
+            return stride * num_lines;
+        case NDIlib_FourCC_video_type_e::NDIlib_FourCC_video_type_UYVA:
+            return stride * num_lines + (size_t)juce::jmax(0, frame.xres) * num_lines;
+        case NDIlib_FourCC_video_type_e::NDIlib_FourCC_video_type_P216:
+            return stride * num_lines * 2;
+        case NDIlib_FourCC_video_type_e::NDIlib_FourCC_video_type_PA16:
+            return stride * num_lines * 3;
+        case NDIlib_FourCC_video_type_e::NDIlib_FourCC_video_type_YV12:
+        case NDIlib_FourCC_video_type_e::NDIlib_FourCC_video_type_I420:
+        case NDIlib_FourCC_video_type_e::NDIlib_FourCC_video_type_NV12:
+            return stride * num_lines * 3 / 2;
+        case NDIlib_FourCC_video_type_e::NDIlib_FourCC_video_type_BGRA:
+        case NDIlib_FourCC_video_type_e::NDIlib_FourCC_video_type_BGRX:
+        case NDIlib_FourCC_video_type_e::NDIlib_FourCC_video_type_RGBA:
+        case NDIlib_FourCC_video_type_e::NDIlib_FourCC_video_type_RGBX:
+            return stride * num_lines;
+        default:
+            return 0;
+        }
+    }
+}
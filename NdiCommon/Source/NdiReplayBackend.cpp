@@ -0,0 +1,358 @@
+/*
+  ==============================================================================
+
+    NdiReplayBackend.cpp
+    Created: 19 Oct 2026 6:03:31pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include "NdiReplayBackend.h"
+
+//==============================================================================
+struct NdiReplayBackend::Receiver
+{
+    // Taken by connect and capture, never while waiting.
+    juce::SpinLock stateLock;
+    bool isConnected{ false };
+    size_t nextFrame{ 0 };
+    juce::int64 startTicks{ 0 };
+
+    NDIlib_recv_performance_t totalFrames{ 0, 0, 0 };
+};
+
+struct NdiReplayBackend::Finder
+{
+    bool hasReported{ false };
+};
+
+//==============================================================================
+NdiReplayBackend::NdiReplayBackend(const juce::File& file)
+    : NdiReplayBackend(file, Settings())
+{
+}
+
+NdiReplayBackend::NdiReplayBackend(const juce::File& file, const Settings& settings_)
+    : settings(settings_)
+{
+    mappedFile = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+    data = static_cast<const char*>(mappedFile->getData());
+    dataSize = (juce::uint64)mappedFile->getSize();
+
+    readIndex();
+
+    sourceName = ("REPLAY (" + file.getFileName() + ")").toStdString();
+    source.p_ndi_name = sourceName.c_str();
+    source.p_url_address = NULL;
+}
+
+NdiReplayBackend::~NdiReplayBackend()
+{
+}
+
+double NdiReplayBackend::getLengthSeconds() const
+{
+    if (frames.empty())
+        return 0.0;
+
+    return (double)(getChunk(frames.size() - 1).receiveTime - getChunk(0).receiveTime) * 1.0e-7;
+}
+
+//==============================================================================
+void NdiReplayBackend::readIndex()
+{
+    if (data == nullptr || dataSize < (juce::uint64)NdiRecordingFormat::blockSize)
+        return;
+
+    const auto& header = *reinterpret_cast<const NdiRecordingFormat::FileHeader*>(data);
+    if (header.magic != NdiRecordingFormat::fileMagic || header.version != NdiRecordingFormat::version)
+        return;
+
+    recordedSourceName = juce::String::fromUTF8(header.sourceName, (int)strnlen(header.sourceName, sizeof(header.sourceName)));
+
+    // A recording that was cut short has no index, its chunks are found by walking them.
+    if (!readIndexFromTrailer())
+        readIndexFromChunks();
+}
+
+bool NdiReplayBackend::readIndexFromTrailer()
+{
+    const auto trailer_size = (juce::uint64)sizeof(NdiRecordingFormat::Trailer);
+    const auto chunk_header_size = (juce::uint64)sizeof(NdiRecordingFormat::ChunkHeader);
+    if (dataSize < NdiRecordingFormat::blockSize + trailer_size)
+        return false;
+
+    // A file that was cut short ends anywhere, so the trailer is copied rather than read in place.
+    NdiRecordingFormat::Trailer trailer;
+    memcpy(&trailer, data + dataSize - trailer_size, sizeof(trailer));
+    if (trailer.magic != NdiRecordingFormat::trailerMagic
+        || trailer.indexOffset + chunk_header_size > dataSize - trailer_size
+        || trailer.numEntries > (dataSize - trailer_size - trailer.indexOffset - chunk_header_size) / sizeof(NdiRecordingFormat::IndexEntry))
+        return false;
+
+    const auto& index_header = *reinterpret_cast<const NdiRecordingFormat::ChunkHeader*>(data + trailer.indexOffset);
+    if (index_header.magic != NdiRecordingFormat::chunkMagic || index_header.type != NdiRecordingFormat::indexChunk)
+        return false;
+
+    const auto* entries = reinterpret_cast<const NdiRecordingFormat::IndexEntry*>(data + trailer.indexOffset + chunk_header_size);
+    frames.reserve((size_t)trailer.numEntries);
+    for (juce::uint64 idx = 0; idx < trailer.numEntries; ++idx)
+    {
+        if (isValidChunk(entries[idx].offset))
+            frames.push_back(entries[idx].offset);
+    }
+
+    return true;
+}
+
+void NdiReplayBackend::readIndexFromChunks()
+{
+    auto offset = (juce::uint64)NdiRecordingFormat::blockSize;
+    while (offset + sizeof(NdiRecordingFormat::ChunkHeader) <= dataSize)
+    {
+        const auto& chunk = *reinterpret_cast<const NdiRecordingFormat::ChunkHeader*>(data + offset);
+        if (chunk.magic != NdiRecordingFormat::chunkMagic || chunk.chunkBytes < sizeof(NdiRecordingFormat::ChunkHeader)
+            || chunk.type == NdiRecordingFormat::indexChunk)
+            break;
+
+        if (isValidChunk(offset))
+            frames.push_back(offset);
+
+        offset += chunk.chunkBytes;
+    }
+}
+
+bool NdiReplayBackend::isValidChunk(juce::uint64 offset) const
+{
+    // The frames are handed out as they are in the file, so nothing may point past its end.
+    if (offset % NdiRecordingFormat::blockSize != 0 || offset + sizeof(NdiRecordingFormat::ChunkHeader) > dataSize)
+        return false;
+
+    const auto& chunk = *reinterpret_cast<const NdiRecordingFormat::ChunkHeader*>(data + offset);
+    if (chunk.magic != NdiRecordingFormat::chunkMagic || chunk.payloadBytes > dataSize - offset - sizeof(NdiRecordingFormat::ChunkHeader))
+        return false;
+
+    if (chunk.type == NdiRecordingFormat::videoChunk)
+    {
+        NDIlib_video_frame_v2_t video_frame;
+        video_frame.xres = chunk.xres;
+        video_frame.yres = chunk.yres;
+        video_frame.FourCC = (NDIlib_FourCC_video_type_e)chunk.fourCC;
+        video_frame.line_stride_in_bytes = chunk.lineStrideBytes;
+
+        const auto data_bytes = NdiRecordingFormat::getVideoDataBytes(video_frame);
+        return data_bytes > 0 && data_bytes <= chunk.payloadBytes;
+    }
+
+    if (chunk.type == NdiRecordingFormat::audioChunk)
+    {
+        return chunk.numChannels > 0 && chunk.numSamples > 0 && chunk.sampleRate > 0
+            && (juce::uint64)chunk.numChannels * (juce::uint64)chunk.numSamples * sizeof(float) <= chunk.payloadBytes;
+    }
+
+    return false;
+}
+
+const NdiRecordingFormat::ChunkHeader& NdiReplayBackend::getChunk(size_t frameIndex) const
+{
+    return *reinterpret_cast<const NdiRecordingFormat::ChunkHeader*>(data + frames[frameIndex]);
+}
+
+juce::int64 NdiReplayBackend::getDueTicks(const Receiver& receiver, size_t frameIndex) const
+{
+    const auto recorded_seconds = (double)(getChunk(frameIndex).receiveTime - getChunk(0).receiveTime) * 1.0e-7;
+    return receiver.startTicks + (juce::int64)(recorded_seconds * (double)juce::Time::getHighResolutionTicksPerSecond());
+}
+
+//==============================================================================
+NDIlib_find_instance_t NdiReplayBackend::findCreate()
+{
+    const juce::ScopedLock sl(lock);
+    return finders.add(new Finder());
+}
+
+void NdiReplayBackend::findDestroy(NDIlib_find_instance_t finder)
+{
+    const juce::ScopedLock sl(lock);
+    finders.removeObject(static_cast<Finder*>(finder));
+}
+
+bool NdiReplayBackend::findWaitForSources(NDIlib_find_instance_t finder, uint32_t timeOutMsec)
+{
+    {
+        const juce::ScopedLock sl(lock);
+        auto* p_finder = static_cast<Finder*>(finder);
+        if (!p_finder->hasReported)
+        {
+            p_finder->hasReported = true;
+            return true;
+        }
+    }
+
+    // The one source never changes.
+    juce::Thread::sleep((int)timeOutMsec);
+    return false;
+}
+
+const NDIlib_source_t* NdiReplayBackend::findGetCurrentSources(NDIlib_find_instance_t, uint32_t* numSources)
+{
+    *numSources = isAvailable() ? 1 : 0;
+    return &source;
+}
+
+//==============================================================================
+NDIlib_recv_instance_t NdiReplayBackend::recvCreate()
+{
+    const juce::ScopedLock sl(lock);
+    return receivers.add(new Receiver());
+}
+
+void NdiReplayBackend::recvDestroy(NDIlib_recv_instance_t receiver)
+{
+    const juce::ScopedLock sl(lock);
+    receivers.removeObject(static_cast<Receiver*>(receiver));
+}
+
+void NdiReplayBackend::recvConnect(NDIlib_recv_instance_t receiver, const NDIlib_source_t* newSource)
+{
+    auto* p_receiver = static_cast<Receiver*>(receiver);
+
+    // Every connect plays the file from the start.
+    const juce::SpinLock::ScopedLockType state_lock(p_receiver->stateLock);
+    p_receiver->isConnected = newSource != nullptr;
+    p_receiver->nextFrame = 0;
+    p_receiver->startTicks = juce::Time::getHighResolutionTicks();
+}
+
+NDIlib_frame_type_e NdiReplayBackend::recvCapture(NDIlib_recv_instance_t receiver, NDIlib_video_frame_v2_t* videoFrame, NDIlib_audio_frame_v2_t* audioFrame, uint32_t timeOutMsec)
+{
+    auto* p_receiver = static_cast<Receiver*>(receiver);
+    const auto ticks_per_msec = (double)juce::Time::getHighResolutionTicksPerSecond() / 1000.0;
+    const auto deadline_ticks = juce::Time::getHighResolutionTicks() + (juce::int64)(timeOutMsec * ticks_per_msec);
+
+    for (;;)
+    {
+        juce::int64 wait_ticks = 0;
+        {
+            const juce::SpinLock::ScopedLockType state_lock(p_receiver->stateLock);
+            const auto now_ticks = juce::Time::getHighResolutionTicks();
+
+            if (p_receiver->isConnected && p_receiver->nextFrame >= frames.size() && settings.isLooping)
+            {
+                p_receiver->nextFrame = 0;
+                p_receiver->startTicks = now_ticks;
+            }
+
+            if (p_receiver->isConnected && p_receiver->nextFrame < frames.size())
+            {
+                const auto frame_index = p_receiver->nextFrame;
+                const auto due_ticks = settings.isRealTime ? getDueTicks(*p_receiver, frame_index) : now_ticks;
+
+                if (due_ticks <= now_ticks)
+                {
+                    ++p_receiver->nextFrame;
+
+                    // The frames point into the read only mapping, receivers only ever read them.
+                    const auto& chunk = getChunk(frame_index);
+                    auto* payload = const_cast<char*>(reinterpret_cast<const char*>(&chunk + 1));
+
+                    if (chunk.type == NdiRecordingFormat::videoChunk && videoFrame != nullptr)
+                    {
+                        *videoFrame = NDIlib_video_frame_v2_t();
+                        videoFrame->xres = chunk.xres;
+                        videoFrame->yres = chunk.yres;
+                        videoFrame->FourCC = (NDIlib_FourCC_video_type_e)chunk.fourCC;
+                        videoFrame->frame_rate_N = chunk.frameRateN;
+                        videoFrame->frame_rate_D = chunk.frameRateD;
+                        videoFrame->picture_aspect_ratio = chunk.pictureAspectRatio;
+                        videoFrame->frame_format_type = (NDIlib_frame_format_type_e)chunk.frameFormatType;
+                        videoFrame->timecode = chunk.timecode;
+                        videoFrame->p_data = reinterpret_cast<uint8_t*>(payload);
+                        videoFrame->line_stride_in_bytes = chunk.lineStrideBytes;
+                        videoFrame->p_metadata = NULL;
+                        videoFrame->timestamp = chunk.timestamp;
+
+                        ++p_receiver->totalFrames.video_frames;
+                        return NDIlib_frame_type_video;
+                    }
+
+                    if (chunk.type == NdiRecordingFormat::audioChunk && audioFrame != nullptr)
+                    {
+                        *audioFrame = NDIlib_audio_frame_v2_t();
+                        audioFrame->sample_rate = chunk.sampleRate;
+                        audioFrame->no_channels = chunk.numChannels;
+                        audioFrame->no_samples = chunk.numSamples;
+                        audioFrame->timecode = chunk.timecode;
+                        audioFrame->p_data = reinterpret_cast<float*>(payload);
+                        audioFrame->channel_stride_in_bytes = chunk.numSamples * (int)sizeof(float);
+                        audioFrame->p_metadata = NULL;
+                        audioFrame->timestamp = chunk.timestamp;
+
+                        ++p_receiver->totalFrames.audio_frames;
+                        return NDIlib_frame_type_audio;
+                    }
+
+                    // A type the caller did not ask for, NDI discards those as well.
+                    continue;
+                }
+
+                wait_ticks = due_ticks - now_ticks;
+            }
+        }
+
+        const auto remaining_ticks = deadline_ticks - juce::Time::getHighResolutionTicks();
+        if (remaining_ticks <= 0)
+            return NDIlib_frame_type_none;
+
+        // Not connected, or at the end: wait out the time out like a quiet source.
+        const auto sleep_ticks = wait_ticks > 0 ? juce::jmin(wait_ticks, remaining_ticks) : remaining_ticks;
+        juce::Thread::sleep(juce::jmax(1, (int)((double)sleep_ticks / ticks_per_msec)));
+    }
+}
+
+void NdiReplayBackend::recvFreeVideo(NDIlib_recv_instance_t, const NDIlib_video_frame_v2_t*)
+{
+    // Nothing was allocated, the frame is part of the mapping.
+}
+
+void NdiReplayBackend::recvFreeAudio(NDIlib_recv_instance_t, const NDIlib_audio_frame_v2_t*)
+{
+}
+
+void NdiReplayBackend::recvGetPerformance(NDIlib_recv_instance_t receiver, NDIlib_recv_performance_t* totalFrames, NDIlib_recv_performance_t* droppedFrames)
+{
+    auto* p_receiver = static_cast<Receiver*>(receiver);
+
+    const juce::SpinLock::ScopedLockType state_lock(p_receiver->stateLock);
+    if (totalFrames) *totalFrames = p_receiver->totalFrames;
+    if (droppedFrames) *droppedFrames = { 0, 0, 0 };
+}
+
+void NdiReplayBackend::recvGetQueue(NDIlib_recv_instance_t receiver, NDIlib_recv_queue_t* queue)
+{
+    *queue = { 0, 0, 0 };
+
+    // As fast as possible, a frame is made when it is asked for and nothing waits.
+    if (!settings.isRealTime)
+        return;
+
+    // In real time the frames already due are the queue, like those waiting inside NDI.
+    auto* p_receiver = static_cast<Receiver*>(receiver);
+    const juce::SpinLock::ScopedLockType state_lock(p_receiver->stateLock);
+    if (!p_receiver->isConnected)
+        return;
+
+    const auto now_ticks = juce::Time::getHighResolutionTicks();
+    const size_t max_frames_ahead = 64;
+    for (auto frame_index = p_receiver->nextFrame; frame_index < juce::jmin(frames.size(), p_receiver->nextFrame + max_frames_ahead); ++frame_index)
+    {
+        if (getDueTicks(*p_receiver, frame_index) > now_ticks)
+            break;
+
+        if (getChunk(frame_index).type == NdiRecordingFormat::videoChunk)
+            ++queue->video_frames;
+        else
+            ++queue->audio_frames;
+    }
+}
@@ -0,0 +1,109 @@
+/*
+  ==============================================================================
+
+    NdiReplayBackend.h
+    Created: 19 Oct 2026 6:03:31pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "NdiBackend.h"
+#include "NdiRecordingFormat.h"
+
+//==============================================================================
+/**
+    Plays a recording made by the receiver back as if it came from NDI.
+
+    The file shows up as the only source. Every receiver connected to it gets
+    the recorded frames from the start, either at the times they were captured
+    or as fast as they are asked for. The file is memory mapped and the frames
+    are handed out in place, nothing is copied or allocated per frame.
+
+    Install it with NdiBackend::setDefault() to run the receive pipeline
+    without a sender. It cannot send.
+*/
+class NdiReplayBackend : public NdiBackend
+{
+public:
+    //==============================================================================
+    struct Settings
+    {
+        /** Deliver each frame at the time it was captured, relative to the connect. */
+        bool isRealTime{ true };
+
+        /** Start again from the beginning at the end, otherwise the source goes quiet. */
+        bool isLooping{ false };
+    };
+
+    //==============================================================================
+    explicit NdiReplayBackend(const juce::File& file);
+    NdiReplayBackend(const juce::File& file, const Settings& settings);
+    ~NdiReplayBackend() override;
+
+    //==============================================================================
+    /** The name the file was recorded from. */
+    const juce::String& getRecordedSourceName() const { return recordedSourceName; }
+    int getNumFrames() const { return (int)frames.size(); }
+    double getLengthSeconds() const;
+
+    //==============================================================================
+    /** False when the file could not be mapped or is not a recording. */
+    bool isAvailable() override { return !frames.empty(); }
+
+    NDIlib_find_instance_t findCreate() override;
+    void findDestroy(NDIlib_find_instance_t finder) override;
+    bool findWaitForSources(NDIlib_find_instance_t finder, uint32_t timeOutMsec) override;
+    const NDIlib_source_t* findGetCurrentSources(NDIlib_find_instance_t finder, uint32_t* numSources) override;
+
+    NDIlib_recv_instance_t recvCreate() override;
+    void recvDestroy(NDIlib_recv_instance_t receiver) override;
+    void recvConnect(NDIlib_recv_instance_t receiver, const NDIlib_source_t* source) override;
+    NDIlib_frame_type_e recvCapture(NDIlib_recv_instance_t receiver, NDIlib_video_frame_v2_t* videoFrame, NDIlib_audio_frame_v2_t* audioFrame, uint32_t timeOutMsec) override;
+    void recvFreeVideo(NDIlib_recv_instance_t receiver, const NDIlib_video_frame_v2_t* videoFrame) override;
+    void recvFreeAudio(NDIlib_recv_instance_t receiver, const NDIlib_audio_frame_v2_t* audioFrame) override;
+    void recvGetPerformance(NDIlib_recv_instance_t receiver, NDIlib_recv_performance_t* totalFrames, NDIlib_recv_performance_t* droppedFrames) override;
+    void recvGetQueue(NDIlib_recv_instance_t receiver, NDIlib_recv_queue_t* queue) override;
+
+    NDIlib_send_instance_t sendCreate(const NDIlib_send_create_t*) override { return nullptr; }
+    void sendDestroy(NDIlib_send_instance_t) override {}
+    void sendVideo(NDIlib_send_instance_t, const NDIlib_video_frame_v2_t*) override {}
+    void sendAudio(NDIlib_send_instance_t, const NDIlib_audio_frame_v2_t*) override {}
+    int sendGetNoConnections(NDIlib_send_instance_t, uint32_t) override { return 0; }
+    bool sendGetTally(NDIlib_send_instance_t, NDIlib_tally_t*, uint32_t) override { return false; }
+
+private:
+    //==============================================================================
+    struct Receiver;
+    struct Finder;
+
+    //==============================================================================
+    void readIndex();
+    bool readIndexFromTrailer();
+    void readIndexFromChunks();
+    bool isValidChunk(juce::uint64 offset) const;
+
+    const NdiRecordingFormat::ChunkHeader& getChunk(size_t frameIndex) const;
+    juce::int64 getDueTicks(const Receiver& receiver, size_t frameIndex) const;
+
+    //==============================================================================
+    const Settings settings;
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    const char* data{ nullptr };
+    juce::uint64 dataSize{ 0 };
+
+    // The offsets of the video and audio chunks, in the order they were captured.
+    std::vector<juce::uint64> frames;
+
+    juce::String recordedSourceName;
+    std::string sourceName;
+    NDIlib_source_t source;
+
+    juce::CriticalSection lock;
+    juce::OwnedArray<Receiver> receivers;
+    juce::OwnedArray<Finder> finders;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NdiReplayBackend)
+};
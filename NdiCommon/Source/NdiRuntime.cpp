@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    NdiRuntime.cpp
+    Created: 19 Oct 2026 10:12:41am
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include "NdiRuntime.h"
+
+//==============================================================================
+NdiRuntime::NdiRuntime()
+{
+}
+
+NdiRuntime::~NdiRuntime()
+{
+    // Only the last user gets here, every finder, receiver and sender is gone by now.
+    if (auto* p_ndi_lib = pNdiLib.load())
+        p_ndi_lib->NDIlib_destroy();
+
+    ndiLibrary.close();
+}
+
+//==============================================================================
+const NDIlib_v4* NdiRuntime::getLib()
+{
+    // Lock free once loaded, this is called for every frame.
+    if (hasTriedLoading)
+        return pNdiLib;
+
+    const juce::ScopedLock load_lock(loadLock);
+
+    if (!hasTriedLoading)
+    {
+        pNdiLib = loadLib();
+        hasTriedLoading = true;
+    }
+
+    return pNdiLib;
+}
+
+const NDIlib_v4* NdiRuntime::loadLib()
+{
+    if (!openLibrary())
+    {
+        DBG("Please re-install the NewTek NDI Runtimes to use this application. " << NDILIB_REDIST_URL);
+        return nullptr;
+    }
+
+    // The main NDI entry point for dynamic loading if we got the library
+    const NDIlib_v4* (*funcPtr_NDIlib_v4_load)(void) = NULL;
+    *((void**)&funcPtr_NDIlib_v4_load) = ndiLibrary.getFunction("NDIlib_v4_load");
+
+    if (!funcPtr_NDIlib_v4_load)
+    {
+        DBG("Please re-install the NewTek NDI Runtimes to use this application. " << NDILIB_REDIST_URL);
+        ndiLibrary.close();
+        return nullptr;
+    }
+
+    // Lets get all of the DLL entry points
+    const NDIlib_v4* p_ndi_lib = funcPtr_NDIlib_v4_load();
+
+    // We can now run as usual
+    if (!p_ndi_lib || !p_ndi_lib->NDIlib_initialize())
+    {   // Cannot run NDI. Most likely because the CPU is not sufficient (see SDK documentation).
+        // you can check this directly with a call to NDIlib_is_supported_CPU()
+        DBG("Cannot run NDI.");
+        ndiLibrary.close();
+        return nullptr;
+    }
+
+    return p_ndi_lib;
+}
+
+bool NdiRuntime::openLibrary()
+{
+    juce::StringArray candidates;
+
+    // The runtime installers point this environment variable at their folder.
+    const juce::String runtime_folder = juce::SystemStats::getEnvironmentVariable(NDILIB_REDIST_FOLDER, {});
+
+#if JUCE_WINDOWS
+    if (runtime_folder.isNotEmpty())
+        candidates.add(juce::File(runtime_folder).getChildFile(NDILIB_LIBRARY_NAME).getFullPathName());
+
+    candidates.add(NDILIB_LIBRARY_NAME);
+#elif JUCE_MAC
+    if (runtime_folder.isNotEmpty())
+        candidates.add(juce::File(runtime_folder).getChildFile("libndi.dylib").getFullPathName());
+
+    candidates.add("libndi.4.dylib"); // The standard versioning scheme on Linux based systems using sym links
+    candidates.add("/usr/local/lib/libndi.4.dylib");
+#else
+    if (runtime_folder.isNotEmpty())
+        candidates.add(juce::File(runtime_folder).getChildFile("libndi.so.4").getFullPathName());
+
+    candidates.add("libndi.so.4"); // The standard versioning scheme on Linux based systems using sym links
+    candidates.add("/usr/local/lib/libndi.so.4");
+    candidates.add("/usr/lib/libndi.so.4");
+#endif
+
+    for (auto& path : candidates)
+    {
+        if (ndiLibrary.open(path))
+            return true;
+    }
+
+    return false;
+}
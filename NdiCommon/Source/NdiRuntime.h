@@ -0,0 +1,56 @@
+/*
+  ==============================================================================
+
+    NdiRuntime.h
+    Created: 19 Oct 2026 10:12:41am
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <Processing.NDI.Lib.h>
+
+//==============================================================================
+/**
+    The NDI runtime shared by every wrapper in the process.
+
+    Hold it through a juce::SharedResourcePointer<NdiRuntime>. Creating one is
+    cheap: the runtime library is only loaded and initialized by the first call
+    to getLib(), and destroyed when the last pointer goes away, so one plugin
+    instance can never tear down the runtime under another.
+
+    The library is always resolved at run time through NDIlib_v4_load, so the
+    plugins load and scan fine on machines without the NDI runtime installed.
+*/
+class NdiRuntime
+{
+public:
+    //==============================================================================
+    NdiRuntime();
+    ~NdiRuntime();
+
+    //==============================================================================
+    /** Loads the runtime on first use.
+        Returns the NDI function table, or nullptr if the runtime is unavailable.
+    */
+    const NDIlib_v4* getLib();
+
+    bool isAvailable() { return getLib() != nullptr; }
+
+private:
+    //==============================================================================
+    const NDIlib_v4* loadLib();
+    bool openLibrary();
+
+    //==============================================================================
+    juce::DynamicLibrary ndiLibrary;
+    std::atomic<const NDIlib_v4*> pNdiLib{ nullptr };
+    std::atomic<bool> hasTriedLoading{ false };
+
+    juce::CriticalSection loadLock;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NdiRuntime)
+};
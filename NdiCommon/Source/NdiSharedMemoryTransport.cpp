@@ -0,0 +1,649 @@
+/*
+  ==============================================================================
+
+    NdiSharedMemoryTransport.cpp
+    Created: 19 Oct 2026 7:21:15pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include "NdiSharedMemoryTransport.h"
+#include "NdiRecordingFormat.h"
+
+#if JUCE_LINUX || JUCE_MAC
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <fcntl.h>
+ #include <unistd.h>
+ #include <time.h>
+ #include <signal.h>
+ #include <cerrno>
+#endif
+
+#if JUCE_LINUX
+ #include <linux/futex.h>
+ #include <sys/syscall.h>
+#endif
+
+//==============================================================================
+namespace
+{
+    constexpr uint32_t segmentMagic = 0x4e444a53; // "NDJS"
+    constexpr uint32_t segmentVersion = 2;
+
+    // Room for a few uncompressed 2160p frames, tmpfs only commits the pages actually written.
+    constexpr juce::uint64 dataCapacity = 64U << 20;
+    constexpr juce::uint64 recordAlignment = 128;
+
+    // A reader that has not captured for this long is treated as gone, e.g. after a crash.
+    constexpr juce::uint64 readerTimeOutMsec = 2000;
+
+    // A writer that has not shown a sign of life for this long is treated as gone, well above its connection poll.
+    constexpr juce::uint64 writerTimeOutMsec = 3000;
+
+    enum RecordType : uint32_t
+    {
+        kPadding = 0,
+        kVideo,
+        kAudio
+    };
+
+    // Lives at the start of the segment, shared by the writer and every reader.
+    struct alignas(64) SegmentHeader
+    {
+        std::atomic<uint32_t> magic;
+        uint32_t version;
+        juce::uint64 capacity;
+
+        // The futex word, bumped after every record and on close.
+        std::atomic<uint32_t> sequence;
+        std::atomic<uint32_t> isClosed;
+        std::atomic<uint32_t> numReaders;
+
+        // The writer reserves space before filling it, readers validate their copy against it.
+        std::atomic<juce::uint64> reservedPosition;
+        std::atomic<juce::uint64> writePosition;
+        std::atomic<juce::uint64> lastReaderActivityMsec;
+
+        // Lets readers tell a crashed writer, which never sets isClosed, from an idle one.
+        int32_t writerPid;
+        std::atomic<juce::uint64> lastWriterActivityMsec;
+    };
+
+    // Precedes every record in the data ring.
+    struct RecordHeader
+    {
+        uint32_t type;
+        uint32_t reserved;
+        juce::uint64 recordSize;
+        juce::uint64 dataSize;
+
+        int32_t xres, yres;
+        int32_t fourCC;
+        int32_t frameRateN, frameRateD;
+        float pictureAspectRatio;
+        int32_t frameFormatType;
+        int32_t lineStrideInBytes;
+
+        int32_t sampleRate;
+        int32_t numChannels;
+        int32_t numSamples;
+        int32_t channelStrideInBytes;
+
+        int64_t timecode;
+        int64_t timestamp;
+    };
+
+    static_assert(sizeof(RecordHeader) <= recordAlignment, "A padding record has to fit in any gap");
+    static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2 && sizeof(long long) == sizeof(juce::uint64),
+                  "Atomics shared between processes have to be lock free");
+
+    juce::uint64 alignRecordSize(juce::uint64 size)
+    {
+        return (size + recordAlignment - 1) & ~(recordAlignment - 1);
+    }
+
+    // A record's data has to hold the frame its header describes, or the receiver would read past it.
+    bool isVideoRecordValid(const RecordHeader& record)
+    {
+        NDIlib_video_frame_v2_t frame(record.xres, record.yres);
+        frame.FourCC = (NDIlib_FourCC_video_type_e)record.fourCC;
+        frame.line_stride_in_bytes = record.lineStrideInBytes;
+
+        const size_t min_stride = NdiRecordingFormat::getMinLineStride(frame);
+
+        return record.xres > 0 && record.yres > 0 && min_stride > 0
+            && record.lineStrideInBytes > 0 && (size_t)record.lineStrideInBytes >= min_stride
+            && NdiRecordingFormat::getVideoDataBytes(frame) <= record.dataSize;
+    }
+
+    bool isAudioRecordValid(const RecordHeader& record)
+    {
+        if (record.numChannels <= 0 || record.numSamples <= 0 || record.channelStrideInBytes <= 0) return false;
+
+        const juce::uint64 channel_bytes = (juce::uint64)record.numSamples * sizeof(float);
+        const juce::uint64 channel_stride = (juce::uint64)record.channelStrideInBytes;
+
+        return channel_stride >= channel_bytes && channel_stride % sizeof(float) == 0
+            && channel_stride * (juce::uint64)record.numChannels <= record.dataSize;
+    }
+
+    // The same clock in every process, unlike juce::Time::getMillisecondCounter().
+    juce::uint64 getMonotonicMsec()
+    {
+       #if JUCE_LINUX || JUCE_MAC
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (juce::uint64)ts.tv_sec * 1000 + (juce::uint64)ts.tv_nsec / 1000000;
+       #else
+        return 0;
+       #endif
+    }
+
+    juce::String getSegmentName(const juce::String& ndiName)
+    {
+        // macOS limits names to 31 characters, so use a hash of the sender name.
+        return "/ndijuce-" + juce::String::toHexString(ndiName.hashCode64());
+    }
+
+    void waitForSequence(std::atomic<uint32_t>& sequence, uint32_t expected, int timeOutMsec)
+    {
+       #if JUCE_LINUX
+        // Not FUTEX_PRIVATE, the word is shared with the writer's process.
+        timespec ts;
+        ts.tv_sec = timeOutMsec / 1000;
+        ts.tv_nsec = (long)(timeOutMsec % 1000) * 1000000;
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&sequence), FUTEX_WAIT, expected, &ts, nullptr, 0);
+       #else
+        // No cross-process futex here, poll at a rate well below one frame.
+        juce::ignoreUnused(expected, timeOutMsec);
+        if (sequence.load(std::memory_order_acquire) == expected)
+            juce::Thread::sleep(1);
+       #endif
+    }
+
+    bool isProcessGone(int32_t pid)
+    {
+       #if JUCE_LINUX || JUCE_MAC
+        // EPERM means it exists but belongs to someone else.
+        return pid > 0 && kill((pid_t)pid, 0) != 0 && errno == ESRCH;
+       #else
+        juce::ignoreUnused(pid);
+        return false;
+       #endif
+    }
+
+    bool isWriterGone(const SegmentHeader& header, juce::uint64 nowMsec)
+    {
+        if (header.isClosed.load(std::memory_order_acquire) != 0)
+            return true;
+
+        // Signed, the writer may have stored a slightly later time than ours.
+        const auto idle_msec = (juce::int64)(nowMsec - header.lastWriterActivityMsec.load(std::memory_order_relaxed));
+        return idle_msec >= (juce::int64)writerTimeOutMsec || isProcessGone(header.writerPid);
+    }
+
+    void wakeReaders(std::atomic<uint32_t>& sequence)
+    {
+        sequence.fetch_add(1, std::memory_order_release);
+
+       #if JUCE_LINUX
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&sequence), FUTEX_WAKE, std::numeric_limits<int>::max(), nullptr, nullptr, 0);
+       #endif
+    }
+}
+
+//==============================================================================
+class NdiSharedMemorySegment
+{
+public:
+    //==============================================================================
+    ~NdiSharedMemorySegment()
+    {
+       #if JUCE_LINUX || JUCE_MAC
+        if (address != nullptr) munmap(address, (size_t)mappedSize);
+        if (fd >= 0) ::close(fd);
+
+        // Readers that are still attached keep their mapping, the name just goes away.
+        if (isOwner) shm_unlink(name.toRawUTF8());
+       #endif
+    }
+
+    //==============================================================================
+    static std::unique_ptr<NdiSharedMemorySegment> create(const juce::String& ndiName)
+    {
+       #if JUCE_LINUX || JUCE_MAC
+        std::unique_ptr<NdiSharedMemorySegment> segment(new NdiSharedMemorySegment(getSegmentName(ndiName), true));
+
+        // A segment left over by a crashed sender with the same name is replaced.
+        shm_unlink(segment->name.toRawUTF8());
+
+        segment->fd = shm_open(segment->name.toRawUTF8(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (segment->fd < 0) return nullptr;
+
+        segment->mappedSize = sizeof(SegmentHeader) + dataCapacity;
+        if (ftruncate(segment->fd, (off_t)segment->mappedSize) != 0) return nullptr;
+        if (!segment->map()) return nullptr;
+
+        auto* header = segment->getHeader();
+        header->version = segmentVersion;
+        header->capacity = dataCapacity;
+        header->sequence.store(0);
+        header->isClosed.store(0);
+        header->numReaders.store(0);
+        header->reservedPosition.store(0);
+        header->writePosition.store(0);
+        header->lastReaderActivityMsec.store(0);
+        header->writerPid = (int32_t)getpid();
+        header->lastWriterActivityMsec.store(getMonotonicMsec());
+
+        // Published last, readers ignore the segment until then.
+        header->magic.store(segmentMagic, std::memory_order_release);
+        return segment;
+       #else
+        juce::ignoreUnused(ndiName);
+        return nullptr;
+       #endif
+    }
+
+    static std::unique_ptr<NdiSharedMemorySegment> open(const juce::String& ndiName)
+    {
+       #if JUCE_LINUX || JUCE_MAC
+        std::unique_ptr<NdiSharedMemorySegment> segment(new NdiSharedMemorySegment(getSegmentName(ndiName), false));
+
+        segment->fd = shm_open(segment->name.toRawUTF8(), O_RDWR, 0600);
+        if (segment->fd < 0) return nullptr;
+
+        struct stat st;
+        if (fstat(segment->fd, &st) != 0 || (juce::uint64)st.st_size < sizeof(SegmentHeader)) return nullptr;
+
+        segment->mappedSize = (juce::uint64)st.st_size;
+        if (!segment->map()) return nullptr;
+
+        auto* header = segment->getHeader();
+        if (header->magic.load(std::memory_order_acquire) != segmentMagic
+            || header->version != segmentVersion
+            || sizeof(SegmentHeader) + header->capacity > segment->mappedSize)
+            return nullptr;
+
+        return segment;
+       #else
+        juce::ignoreUnused(ndiName);
+        return nullptr;
+       #endif
+    }
+
+    /** Removes the name of a segment whose writer died, unless a new writer has taken the name over since. */
+    void unlinkIfOrphaned()
+    {
+       #if JUCE_LINUX || JUCE_MAC
+        if (isOwner || !isProcessGone(getHeader()->writerPid)) return;
+
+        const int named_fd = shm_open(name.toRawUTF8(), O_RDONLY, 0600);
+        if (named_fd < 0) return;
+
+        struct stat named_st, mapped_st;
+        const bool is_same = fstat(named_fd, &named_st) == 0 && fstat(fd, &mapped_st) == 0
+            && named_st.st_dev == mapped_st.st_dev && named_st.st_ino == mapped_st.st_ino;
+        ::close(named_fd);
+
+        if (is_same) shm_unlink(name.toRawUTF8());
+       #endif
+    }
+
+    //==============================================================================
+    SegmentHeader* getHeader() const { return static_cast<SegmentHeader*>(address); }
+    uint8_t* getData() const { return static_cast<uint8_t*>(address) + sizeof(SegmentHeader); }
+
+private:
+    //==============================================================================
+    NdiSharedMemorySegment(const juce::String& name_, bool isOwner_)
+        : name(name_)
+        , isOwner(isOwner_)
+    {
+    }
+
+    bool map()
+    {
+       #if JUCE_LINUX || JUCE_MAC
+        void* mapped = mmap(nullptr, (size_t)mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapped == MAP_FAILED) return false;
+
+        address = mapped;
+        return true;
+       #else
+        return false;
+       #endif
+    }
+
+    //==============================================================================
+    const juce::String name;
+    const bool isOwner;
+    int fd{ -1 };
+    void* address{ nullptr };
+    juce::uint64 mappedSize{ 0 };
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NdiSharedMemorySegment)
+};
+
+//==============================================================================
+namespace
+{
+    void writeRecord(NdiSharedMemorySegment& segment, RecordHeader& record, const void* data, size_t dataSize)
+    {
+        auto* header = segment.getHeader();
+        uint8_t* ring = segment.getData();
+
+        record.reserved = 0;
+        record.dataSize = dataSize;
+        record.recordSize = alignRecordSize(sizeof(RecordHeader) + dataSize);
+
+        // Frames that can never fit are dropped, the reader would never catch up with them.
+        if (record.recordSize > header->capacity) return;
+
+        // Only this thread moves the write position.
+        juce::uint64 position = header->writePosition.load(std::memory_order_relaxed);
+        juce::uint64 offset = position % header->capacity;
+
+        // Records are never split, the gap at the end of the ring is filled with padding.
+        const juce::uint64 padding_size = (offset + record.recordSize > header->capacity) ? header->capacity - offset : 0;
+
+        header->reservedPosition.store(position + padding_size + record.recordSize, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        if (padding_size > 0)
+        {
+            RecordHeader padding;
+            std::memset(&padding, 0, sizeof(padding));
+            padding.type = kPadding;
+            padding.recordSize = padding_size;
+            std::memcpy(ring + offset, &padding, sizeof(padding));
+
+            position += padding_size;
+            offset = 0;
+        }
+
+        std::memcpy(ring + offset, &record, sizeof(RecordHeader));
+        if (dataSize > 0) std::memcpy(ring + offset + sizeof(RecordHeader), data, dataSize);
+
+        header->writePosition.store(position + record.recordSize, std::memory_order_release);
+        header->lastWriterActivityMsec.store(getMonotonicMsec(), std::memory_order_relaxed);
+        wakeReaders(header->sequence);
+    }
+}
+
+//==============================================================================
+NdiSharedMemoryWriter::NdiSharedMemoryWriter(const juce::String& ndiName)
+    : segment(NdiSharedMemorySegment::create(ndiName))
+{
+}
+
+NdiSharedMemoryWriter::~NdiSharedMemoryWriter()
+{
+    if (segment)
+    {
+        // Wake readers waiting for the next frame, so they can fall back to NDI.
+        segment->getHeader()->isClosed.store(1, std::memory_order_release);
+        wakeReaders(segment->getHeader()->sequence);
+    }
+}
+
+bool NdiSharedMemoryWriter::isOpen() const
+{
+    return segment != nullptr;
+}
+
+void NdiSharedMemoryWriter::updateHeartbeat()
+{
+    if (segment) segment->getHeader()->lastWriterActivityMsec.store(getMonotonicMsec(), std::memory_order_relaxed);
+}
+
+bool NdiSharedMemoryWriter::hasReaders() const
+{
+    if (!segment) return false;
+
+    const auto* header = segment->getHeader();
+    if (header->numReaders.load(std::memory_order_relaxed) == 0) return false;
+
+    // Signed, a reader in another process may have stored a slightly later time than ours.
+    const auto idle_msec = (juce::int64)(getMonotonicMsec() - header->lastReaderActivityMsec.load(std::memory_order_relaxed));
+    return idle_msec < (juce::int64)readerTimeOutMsec;
+}
+
+bool NdiSharedMemoryWriter::writeVideo(const NDIlib_video_frame_v2_t& videoFrame)
+{
+    if (!segment) return false;
+
+    RecordHeader record;
+    std::memset(&record, 0, sizeof(record));
+    record.type = kVideo;
+    record.xres = videoFrame.xres;
+    record.yres = videoFrame.yres;
+    record.fourCC = (int32_t)videoFrame.FourCC;
+    record.frameRateN = videoFrame.frame_rate_N;
+    record.frameRateD = videoFrame.frame_rate_D;
+    record.pictureAspectRatio = videoFrame.picture_aspect_ratio;
+    record.frameFormatType = (int32_t)videoFrame.frame_format_type;
+    // Zero means packed lines to NDI, the record always carries the actual stride.
+    record.lineStrideInBytes = (int32_t)NdiRecordingFormat::getLineStride(videoFrame);
+    record.timecode = videoFrame.timecode;
+    record.timestamp = videoFrame.timestamp;
+
+    // Every plane of the FourCC, the same as a recording stores.
+    const size_t data_size = NdiRecordingFormat::getVideoDataBytes(videoFrame);
+    if (data_size == 0) return false;
+
+    writeRecord(*segment, record, videoFrame.p_data, data_size);
+    return true;
+}
+
+void NdiSharedMemoryWriter::writeAudio(const NDIlib_audio_frame_v2_t& audioFrame)
+{
+    if (!segment) return;
+
+    RecordHeader record;
+    std::memset(&record, 0, sizeof(record));
+    record.type = kAudio;
+    record.sampleRate = audioFrame.sample_rate;
+    record.numChannels = audioFrame.no_channels;
+    record.numSamples = audioFrame.no_samples;
+    // Zero means packed channels, as for the video stride.
+    record.channelStrideInBytes = audioFrame.channel_stride_in_bytes > 0 ? audioFrame.channel_stride_in_bytes : audioFrame.no_samples * (int)sizeof(float);
+    record.timecode = audioFrame.timecode;
+    record.timestamp = audioFrame.timestamp;
+
+    const size_t data_size = (size_t)juce::jmax(0, record.channelStrideInBytes) * (size_t)juce::jmax(0, audioFrame.no_channels);
+
+    writeRecord(*segment, record, audioFrame.p_data, data_size);
+}
+
+bool NdiSharedMemoryWriter::isSupported()
+{
+   #if JUCE_LINUX || JUCE_MAC
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+//==============================================================================
+NdiSharedMemoryReader::NdiSharedMemoryReader()
+{
+}
+
+NdiSharedMemoryReader::~NdiSharedMemoryReader()
+{
+    close();
+}
+
+bool NdiSharedMemoryReader::open(const juce::String& ndiName)
+{
+    close();
+
+    segment = NdiSharedMemorySegment::open(ndiName);
+    if (!segment) return false;
+
+    // Left over by a writer that crashed, its name is removed so the next one does not find it either.
+    auto* header = segment->getHeader();
+    if (isWriterGone(*header, getMonotonicMsec()))
+    {
+        segment->unlinkIfOrphaned();
+        segment.reset();
+        return false;
+    }
+
+    header->lastReaderActivityMsec.store(getMonotonicMsec(), std::memory_order_relaxed);
+    header->numReaders.fetch_add(1, std::memory_order_relaxed);
+
+    // Start with the next frame, old ones are stale by now.
+    readPosition = header->writePosition.load(std::memory_order_acquire);
+    numOverruns = 0;
+    return true;
+}
+
+void NdiSharedMemoryReader::close()
+{
+    if (!segment) return;
+
+    segment->getHeader()->numReaders.fetch_sub(1, std::memory_order_relaxed);
+    segment.reset();
+}
+
+bool NdiSharedMemoryReader::isOpen() const
+{
+    return segment != nullptr;
+}
+
+bool NdiSharedMemoryReader::isWriterClosed() const
+{
+    return segment != nullptr && isWriterGone(*segment->getHeader(), getMonotonicMsec());
+}
+
+NDIlib_frame_type_e NdiSharedMemoryReader::capture(NDIlib_video_frame_v2_t* videoFrame, NDIlib_audio_frame_v2_t* audioFrame, uint32_t timeOutMsec)
+{
+    if (!segment) return NDIlib_frame_type_none;
+
+    auto* header = segment->getHeader();
+    const uint8_t* ring = segment->getData();
+    const juce::uint64 capacity = header->capacity;
+    const juce::uint64 deadline_msec = getMonotonicMsec() + timeOutMsec;
+
+    for (;;)
+    {
+        const juce::uint64 now_msec = getMonotonicMsec();
+        header->lastReaderActivityMsec.store(now_msec, std::memory_order_relaxed);
+
+        const uint32_t sequence = header->sequence.load(std::memory_order_acquire);
+        const juce::uint64 write_position = header->writePosition.load(std::memory_order_acquire);
+
+        if (readPosition == write_position)
+        {
+            if (now_msec >= deadline_msec)
+                return NDIlib_frame_type_none;
+
+            // A crashed writer never closes, the caller falls back to NDI once isWriterClosed() says so.
+            if (isWriterGone(*header, now_msec))
+            {
+                segment->unlinkIfOrphaned();
+                return NDIlib_frame_type_none;
+            }
+
+            waitForSequence(header->sequence, sequence, (int)(deadline_msec - now_msec));
+            continue;
+        }
+
+        // Lapped by the writer, skip to the newest data.
+        if (write_position - readPosition > capacity)
+        {
+            readPosition = write_position;
+            ++numOverruns;
+            continue;
+        }
+
+        const juce::uint64 offset = readPosition % capacity;
+
+        RecordHeader record;
+        std::memcpy(&record, ring + offset, sizeof(RecordHeader));
+
+        const bool is_sane = record.recordSize >= recordAlignment
+            && offset + record.recordSize <= capacity
+            && sizeof(RecordHeader) + record.dataSize <= record.recordSize;
+
+        if (is_sane && record.type != kPadding)
+        {
+            if (frameDataSize < record.dataSize)
+            {
+                frameData.realloc((size_t)record.dataSize);
+                frameDataSize = (size_t)record.dataSize;
+            }
+
+            std::memcpy(frameData.get(), ring + offset + sizeof(RecordHeader), (size_t)record.dataSize);
+        }
+
+        // The copy is only good if the writer did not start overwriting it meanwhile.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (!is_sane || header->reservedPosition.load(std::memory_order_relaxed) - readPosition > capacity)
+        {
+            readPosition = header->writePosition.load(std::memory_order_acquire);
+            ++numOverruns;
+            continue;
+        }
+
+        readPosition += record.recordSize;
+
+        switch (record.type)
+        {
+        case kVideo:
+            if (!isVideoRecordValid(record)) break;
+
+            videoFrame->xres = record.xres;
+            videoFrame->yres = record.yres;
+            videoFrame->FourCC = (NDIlib_FourCC_video_type_e)record.fourCC;
+            videoFrame->frame_rate_N = record.frameRateN;
+            videoFrame->frame_rate_D = record.frameRateD;
+            videoFrame->picture_aspect_ratio = record.pictureAspectRatio;
+            videoFrame->frame_format_type = (NDIlib_frame_format_type_e)record.frameFormatType;
+            videoFrame->timecode = record.timecode;
+            videoFrame->p_data = frameData.get();
+            videoFrame->line_stride_in_bytes = record.lineStrideInBytes;
+            videoFrame->p_metadata = nullptr;
+            videoFrame->timestamp = record.timestamp;
+            return NDIlib_frame_type_video;
+
+        case kAudio:
+            if (!isAudioRecordValid(record)) break;
+
+            audioFrame->sample_rate = record.sampleRate;
+            audioFrame->no_channels = record.numChannels;
+            audioFrame->no_samples = record.numSamples;
+            audioFrame->timecode = record.timecode;
+            audioFrame->p_data = reinterpret_cast<float*>(frameData.get());
+            audioFrame->channel_stride_in_bytes = record.channelStrideInBytes;
+            audioFrame->p_metadata = nullptr;
+            audioFrame->timestamp = record.timestamp;
+            return NDIlib_frame_type_audio;
+
+        default:
+            break;
+        }
+
+        // Padding at the end of the ring is skipped, any other record here was damaged and counts as an overrun.
+        if (record.type != kPadding) ++numOverruns;
+    }
+}
+
+juce::String NdiSharedMemoryReader::getLocalSenderName(const juce::String& fullNdiName)
+{
+    // NDI names look like "HOST (Sender)", where HOST is the machine name without its domain.
+    const int open_index = fullNdiName.indexOf(" (");
+    if (open_index <= 0 || !fullNdiName.endsWith(")")) return {};
+
+    const auto host = fullNdiName.substring(0, open_index);
+    const auto local_host = juce::SystemStats::getComputerName().upToFirstOccurrenceOf(".", false, false);
+
+    if (!host.equalsIgnoreCase(local_host)) return {};
+
+    return fullNdiName.substring(open_index + 2, fullNdiName.length() - 1);
+}
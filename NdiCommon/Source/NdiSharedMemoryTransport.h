@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+
+    NdiSharedMemoryTransport.h
+    Created: 19 Oct 2026 7:21:15pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <Processing.NDI.Lib.h>
+
+class NdiSharedMemorySegment;
+
+//==============================================================================
+/**
+    Publishes the raw frames of one sender to other processes on the same host.
+
+    The frames go into a POSIX shared-memory ring named after the sender's NDI
+    name, uncompressed and with their format descriptors, and readers are woken
+    through a futex on Linux. Nothing is copied unless a reader is attached.
+
+    On platforms without POSIX shared memory the writer never opens, and
+    receivers simply keep using NDI.
+*/
+class NdiSharedMemoryWriter
+{
+public:
+    //==============================================================================
+    /** Creates the segment for the sender with this NDI name (without the host part). */
+    explicit NdiSharedMemoryWriter(const juce::String& ndiName);
+    ~NdiSharedMemoryWriter();
+
+    //==============================================================================
+    bool isOpen() const;
+
+    /** True while at least one reader is attached and has been active recently. */
+    bool hasReaders() const;
+
+    /** Tells readers the writer is alive while no frames are written. Call it every second or so. */
+    void updateHeartbeat();
+
+    //==============================================================================
+    /** Video frames in any FourCC NDI delivers, audio frames planar float.
+        Returns false and writes nothing for a FourCC whose size is unknown.
+    */
+    bool writeVideo(const NDIlib_video_frame_v2_t& videoFrame);
+    void writeAudio(const NDIlib_audio_frame_v2_t& audioFrame);
+
+    //==============================================================================
+    static bool isSupported();
+
+private:
+    //==============================================================================
+    std::unique_ptr<NdiSharedMemorySegment> segment;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NdiSharedMemoryWriter)
+};
+
+//==============================================================================
+/**
+    Reads the frames an NdiSharedMemoryWriter publishes in another process.
+
+    capture() behaves like NDIlib_recv_capture_v2: it waits up to the time out
+    for the next frame and fills in the NDI descriptors. The data stays valid
+    until the next capture. A reader that falls too far behind skips ahead to
+    the newest frame instead of blocking the writer.
+*/
+class NdiSharedMemoryReader
+{
+public:
+    //==============================================================================
+    NdiSharedMemoryReader();
+    ~NdiSharedMemoryReader();
+
+    //==============================================================================
+    /** Attaches to the writer for this NDI name. Returns false if there is none on this host. */
+    bool open(const juce::String& ndiName);
+    void close();
+    bool isOpen() const;
+
+    /** True once the writer has closed, crashed or stopped showing signs of life.
+        The caller should fall back to NDI.
+    */
+    bool isWriterClosed() const;
+
+    //==============================================================================
+    NDIlib_frame_type_e capture(NDIlib_video_frame_v2_t* videoFrame, NDIlib_audio_frame_v2_t* audioFrame, uint32_t timeOutMsec);
+
+    /** The number of times the reader was overrun or found a damaged record, and had to skip frames. */
+    int getNumOverruns() const { return numOverruns; }
+
+    //==============================================================================
+    /** Returns the sender part of an "HOST (Sender)" NDI name if HOST is this machine,
+        or an empty string for remote sources.
+    */
+    static juce::String getLocalSenderName(const juce::String& fullNdiName);
+
+private:
+    //==============================================================================
+    std::unique_ptr<NdiSharedMemorySegment> segment;
+    juce::uint64 readPosition{ 0 };
+    juce::HeapBlock<uint8_t> frameData;
+    size_t frameDataSize{ 0 };
+    int numOverruns{ 0 };
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NdiSharedMemoryReader)
+};
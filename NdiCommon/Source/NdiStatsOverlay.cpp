@@ -0,0 +1,62 @@
+/*
+  ==============================================================================
+
+    NdiStatsOverlay.cpp
+    Created: 19 Oct 2026 11:41:52pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include "NdiStatsOverlay.h"
+
+//==============================================================================
+NdiStatsOverlay::NdiStatsOverlay(const NdiPipelineStats& stats_)
+    : stats(stats_)
+{
+    setInterceptsMouseClicks(false, false);
+    setOpaque(false);
+}
+
+NdiStatsOverlay::~NdiStatsOverlay()
+{
+    stopTimer();
+}
+
+//==============================================================================
+void NdiStatsOverlay::paint(juce::Graphics& g)
+{
+    const int line_height = 16;
+    const auto text_area = getLocalBounds().reduced(8).withHeight(lines.size() * line_height + 8);
+
+    g.setColour(juce::Colours::black.withAlpha(0.6f));
+    g.fillRect(text_area);
+
+    g.setColour(juce::Colours::white);
+    g.setFont(juce::Font(juce::Font::getDefaultMonospacedFontName(), 13.0f, juce::Font::plain));
+
+    auto line_area = text_area.reduced(6, 4);
+    for (const auto& line : lines)
+        g.drawText(line, line_area.removeFromTop(line_height), juce::Justification::centredLeft, false);
+}
+
+void NdiStatsOverlay::visibilityChanged()
+{
+    // Nothing is read while hidden.
+    if (isVisible())
+    {
+        timerCallback();
+        startTimerHz(refreshRateHz);
+    }
+    else
+    {
+        stopTimer();
+    }
+}
+
+//==============================================================================
+void NdiStatsOverlay::timerCallback()
+{
+    lines = stats.toText();
+    repaint();
+}
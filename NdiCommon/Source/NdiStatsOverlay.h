@@ -0,0 +1,45 @@
+/*
+  ==============================================================================
+
+    NdiStatsOverlay.h
+    Created: 19 Oct 2026 11:41:52pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "NdiPipelineStats.h"
+
+//==============================================================================
+/**
+    Draws NdiPipelineStats as text over the video, refreshed a few times a second.
+
+    It only reads the counters, and lets the mouse through to what is below.
+*/
+class NdiStatsOverlay : public juce::Component
+                      , private juce::Timer
+{
+public:
+    //==============================================================================
+    explicit NdiStatsOverlay(const NdiPipelineStats& stats);
+    ~NdiStatsOverlay() override;
+
+    //==============================================================================
+    void paint(juce::Graphics& g) override;
+    void visibilityChanged() override;
+
+private:
+    //==============================================================================
+    void timerCallback() override;
+
+    //==============================================================================
+    const NdiPipelineStats& stats;
+    juce::StringArray lines;
+
+    const int refreshRateHz{ 4 };
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NdiStatsOverlay)
+};
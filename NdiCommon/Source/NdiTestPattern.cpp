@@ -0,0 +1,229 @@
+/*
+  ==============================================================================
+
+    NdiTestPattern.cpp
+    Created: 19 Oct 2026 9:16:48pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include "NdiTestPattern.h"
+
+//==============================================================================
+NdiTestPattern::NdiTestPattern(int width_, int height_, NDIlib_FourCC_video_type_e fourCC_, Type type_)
+    : width(juce::jmax(2, width_ & ~1))
+    , height(juce::jmax(2, height_ & ~1))
+    , fourCC(fourCC_)
+    , type(type_)
+{
+    jassert(isSupported(fourCC));
+
+    // White, yellow, cyan, green, magenta, red, blue and black at 75%.
+    static const Pixel bar_colours[] = {
+        { 180, 128, 128, 191, 191, 191 }, { 162,  44, 142, 191, 191,   0 },
+        { 131, 156,  44,   0, 191, 191 }, { 112,  72,  58,   0, 191,   0 },
+        {  84, 184, 198, 191,   0, 191 }, {  65, 100, 212, 191,   0,   0 },
+        {  35, 212, 114,   0,   0, 191 }, {  16, 128, 128,   0,   0,   0 },
+    };
+    constexpr int num_bars = (int)(sizeof(bar_colours) / sizeof(bar_colours[0]));
+
+    std::vector<Pixel> bars((size_t)width);
+    std::vector<Pixel> ramp((size_t)width);
+    for (int x = 0; x < width; ++x)
+    {
+        bars[(size_t)x] = bar_colours[x * num_bars / width];
+
+        const auto grey = (uint8_t)(x * 255 / (width - 1));
+        ramp[(size_t)x] = { (uint8_t)(16 + grey * 219 / 255), 128, 128, grey, grey, grey };
+    }
+
+    const int chroma_rows = height / 2;
+    const auto write_y = [](const Pixel* p, uint8_t* d) { d[0] = p[0].y; d[1] = p[1].y; };
+    const auto write_cb = [](const Pixel* p, uint8_t* d) { d[0] = p[0].cb; };
+    const auto write_cr = [](const Pixel* p, uint8_t* d) { d[0] = p[0].cr; };
+
+    switch (fourCC)
+    {
+    case NDIlib_FourCC_video_type_UYVY:
+    case NDIlib_FourCC_video_type_UYVA:
+        addPlane(height, width * 2, 4, bars, ramp, [](const Pixel* p, uint8_t* d) { d[0] = p[0].cb; d[1] = p[0].y; d[2] = p[0].cr; d[3] = p[1].y; });
+        // The alpha plane follows the UYVY one.
+        if (fourCC == NDIlib_FourCC_video_type_UYVA)
+            addPlane(height, width, 2, bars, ramp, [](const Pixel*, uint8_t* d) { d[0] = 255; d[1] = 255; });
+        break;
+
+    case NDIlib_FourCC_video_type_BGRA:
+    case NDIlib_FourCC_video_type_BGRX:
+        addPlane(height, width * 4, 8, bars, ramp, [](const Pixel* p, uint8_t* d)
+            {
+                for (int px_idx = 0; px_idx < 2; ++px_idx, d += 4)
+                {
+                    d[0] = p[px_idx].b; d[1] = p[px_idx].g; d[2] = p[px_idx].r; d[3] = 255;
+                }
+            });
+        break;
+
+    case NDIlib_FourCC_video_type_RGBA:
+    case NDIlib_FourCC_video_type_RGBX:
+        addPlane(height, width * 4, 8, bars, ramp, [](const Pixel* p, uint8_t* d)
+            {
+                for (int px_idx = 0; px_idx < 2; ++px_idx, d += 4)
+                {
+                    d[0] = p[px_idx].r; d[1] = p[px_idx].g; d[2] = p[px_idx].b; d[3] = 255;
+                }
+            });
+        break;
+
+    case NDIlib_FourCC_video_type_NV12:
+        addPlane(height, width, 2, bars, ramp, write_y);
+        addPlane(chroma_rows, width, 2, bars, ramp, [](const Pixel* p, uint8_t* d) { d[0] = p[0].cb; d[1] = p[0].cr; });
+        break;
+
+    case NDIlib_FourCC_video_type_I420:
+        addPlane(height, width, 2, bars, ramp, write_y);
+        addPlane(chroma_rows, width / 2, 1, bars, ramp, write_cb);
+        addPlane(chroma_rows, width / 2, 1, bars, ramp, write_cr);
+        break;
+
+    case NDIlib_FourCC_video_type_YV12:
+        addPlane(height, width, 2, bars, ramp, write_y);
+        addPlane(chroma_rows, width / 2, 1, bars, ramp, write_cr);
+        addPlane(chroma_rows, width / 2, 1, bars, ramp, write_cb);
+        break;
+
+    default:
+        break;
+    }
+
+    for (const auto& plane : planes)
+        frameSize += (size_t)plane.numRows * (size_t)plane.bytesPerRow;
+
+    if (type == Type::noise)
+        createNoiseFrames();
+}
+
+//==============================================================================
+bool NdiTestPattern::isSupported(NDIlib_FourCC_video_type_e fourCC)
+{
+    switch (fourCC)
+    {
+    case NDIlib_FourCC_video_type_UYVY:
+    case NDIlib_FourCC_video_type_UYVA:
+    case NDIlib_FourCC_video_type_BGRA:
+    case NDIlib_FourCC_video_type_BGRX:
+    case NDIlib_FourCC_video_type_RGBA:
+    case NDIlib_FourCC_video_type_RGBX:
+    case NDIlib_FourCC_video_type_NV12:
+    case NDIlib_FourCC_video_type_I420:
+    case NDIlib_FourCC_video_type_YV12:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool NdiTestPattern::parseFourCC(const juce::String& text, NDIlib_FourCC_video_type_e& fourCC)
+{
+    static const std::pair<const char*, NDIlib_FourCC_video_type_e> names[] = {
+        { "UYVY", NDIlib_FourCC_video_type_UYVY }, { "UYVA", NDIlib_FourCC_video_type_UYVA },
+        { "BGRA", NDIlib_FourCC_video_type_BGRA }, { "BGRX", NDIlib_FourCC_video_type_BGRX },
+        { "RGBA", NDIlib_FourCC_video_type_RGBA }, { "RGBX", NDIlib_FourCC_video_type_RGBX },
+        { "NV12", NDIlib_FourCC_video_type_NV12 }, { "I420", NDIlib_FourCC_video_type_I420 },
+        { "YV12", NDIlib_FourCC_video_type_YV12 },
+    };
+
+    for (const auto& name : names)
+    {
+        if (text.trim().equalsIgnoreCase(name.first))
+        {
+            fourCC = name.second;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//==============================================================================
+void NdiTestPattern::render(juce::int64 frameIndex, uint8_t* dest) const
+{
+    if (type == Type::noise)
+    {
+        std::memcpy(dest, noiseFrames[(size_t)(frameIndex % numNoiseFrames)].data(), frameSize);
+        return;
+    }
+
+    // About eight seconds to scroll across at 60 fps, whatever the width.
+    const int num_pairs = width / 2;
+    const int pairs_per_frame = juce::jmax(1, num_pairs / 480);
+    const int scroll_pairs = (int)((frameIndex * pairs_per_frame) % num_pairs);
+
+    for (const auto& plane : planes)
+    {
+        const uint8_t* bars_row = plane.barsLine.data() + scroll_pairs * plane.bytesPerPair;
+        for (int row_idx = 0; row_idx < plane.numRows; ++row_idx, dest += plane.bytesPerRow)
+            std::memcpy(dest, row_idx < plane.firstRampRow ? bars_row : plane.rampLine.data(), (size_t)plane.bytesPerRow);
+    }
+}
+
+void NdiTestPattern::describe(NDIlib_video_frame_v2_t& frame) const
+{
+    frame.xres = width;
+    frame.yres = height;
+    frame.FourCC = fourCC;
+    frame.line_stride_in_bytes = planes.empty() ? 0 : planes.front().bytesPerRow;
+}
+
+//==============================================================================
+void NdiTestPattern::addPlane(int numRows, int bytesPerRow, int bytesPerPair,
+                              const std::vector<Pixel>& bars, const std::vector<Pixel>& ramp,
+                              const std::function<void(const Pixel*, uint8_t*)>& writePair)
+{
+    Plane plane;
+    plane.numRows = numRows;
+    plane.bytesPerRow = bytesPerRow;
+    plane.bytesPerPair = bytesPerPair;
+    plane.firstRampRow = numRows * 2 / 3;
+
+    const auto create_line = [&](const std::vector<Pixel>& pixels)
+    {
+        std::vector<uint8_t> line((size_t)bytesPerRow * 2);
+        for (int pair_idx = 0; pair_idx < width / 2; ++pair_idx)
+            writePair(&pixels[(size_t)pair_idx * 2], line.data() + pair_idx * bytesPerPair);
+
+        std::memcpy(line.data() + bytesPerRow, line.data(), (size_t)bytesPerRow);
+        return line;
+    };
+
+    plane.barsLine = create_line(bars);
+    plane.rampLine = create_line(ramp);
+    planes.push_back(std::move(plane));
+}
+
+void NdiTestPattern::createNoiseFrames()
+{
+    juce::Random random;
+
+    for (int frame_idx = 0; frame_idx < numNoiseFrames; ++frame_idx)
+    {
+        std::vector<uint8_t> frame(frameSize);
+        for (auto& value : frame)
+            value = (uint8_t)random.nextInt(256);
+
+        // Noise in the colours only, the alpha stays opaque.
+        if (fourCC == NDIlib_FourCC_video_type_UYVA)
+        {
+            const size_t alpha_offset = (size_t)planes[0].numRows * (size_t)planes[0].bytesPerRow;
+            std::fill(frame.begin() + (std::ptrdiff_t)alpha_offset, frame.end(), (uint8_t)255);
+        }
+        else if (fourCC == NDIlib_FourCC_video_type_BGRA || fourCC == NDIlib_FourCC_video_type_BGRX
+              || fourCC == NDIlib_FourCC_video_type_RGBA || fourCC == NDIlib_FourCC_video_type_RGBX)
+        {
+            for (size_t byte_idx = 3; byte_idx < frame.size(); byte_idx += 4)
+                frame[byte_idx] = 255;
+        }
+
+        noiseFrames.push_back(std::move(frame));
+    }
+}
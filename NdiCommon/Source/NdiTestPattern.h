@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+    NdiTestPattern.h
+    Created: 19 Oct 2026 9:16:48pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <Processing.NDI.Lib.h>
+#include <functional>
+#include <vector>
+
+//==============================================================================
+/**
+    Draws moving test frames straight into an NDI FourCC, for load tests without a camera.
+
+    "bars" scrolls 75% colour bars over a static grey ramp. Each row is a copy
+    of a line prepared up front, so drawing a frame costs about a memcpy of it.
+    "noise" cycles through a few random frames prepared up front, the worst
+    case for the NDI encoder.
+
+    Supports UYVY, UYVA, BGRA, BGRX, RGBA, RGBX, NV12, I420 and YV12. Sizes
+    are rounded down to even, as the subsampled formats need.
+*/
+class NdiTestPattern
+{
+public:
+    //==============================================================================
+    enum class Type
+    {
+        bars,
+        noise
+    };
+
+    NdiTestPattern(int width, int height, NDIlib_FourCC_video_type_e fourCC, Type type);
+
+    static bool isSupported(NDIlib_FourCC_video_type_e fourCC);
+
+    /** Takes a name like "UYVY" or "bgra". Returns false if it is not supported. */
+    static bool parseFourCC(const juce::String& text, NDIlib_FourCC_video_type_e& fourCC);
+
+    //==============================================================================
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+    /** Bytes of one frame, all planes. */
+    size_t getFrameSize() const { return frameSize; }
+
+    /** Draws a frame, the pattern moves with the index. */
+    void render(juce::int64 frameIndex, uint8_t* dest) const;
+
+    /** Fills in the size, FourCC and line stride of a frame, the data is up to the caller. */
+    void describe(NDIlib_video_frame_v2_t& frame) const;
+
+private:
+    //==============================================================================
+    struct Pixel
+    {
+        uint8_t y, cb, cr;
+        uint8_t r, g, b;
+    };
+
+    /** One plane of the frame, its rows are taken from two lines stored twice over so any scroll offset is one copy. */
+    struct Plane
+    {
+        int numRows{ 0 };
+        int bytesPerRow{ 0 };
+        // Bytes covering two pixels across, the step the bars scroll by.
+        int bytesPerPair{ 0 };
+        int firstRampRow{ 0 };
+        std::vector<uint8_t> barsLine;
+        std::vector<uint8_t> rampLine;
+    };
+
+    void addPlane(int numRows, int bytesPerRow, int bytesPerPair,
+                  const std::vector<Pixel>& bars, const std::vector<Pixel>& ramp,
+                  const std::function<void(const Pixel*, uint8_t*)>& writePair);
+    void createNoiseFrames();
+
+    //==============================================================================
+    const int width;
+    const int height;
+    const NDIlib_FourCC_video_type_e fourCC;
+    const Type type;
+
+    std::vector<Plane> planes;
+    size_t frameSize{ 0 };
+
+    static constexpr int numNoiseFrames = 4;
+    std::vector<std::vector<uint8_t>> noiseFrames;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NdiTestPattern)
+};
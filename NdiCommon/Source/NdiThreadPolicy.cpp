@@ -0,0 +1,307 @@
+/*
+  ==============================================================================
+
+    NdiThreadPolicy.cpp
+    Created: 20 Oct 2026 1:22:47am
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include "NdiThreadPolicy.h"
+
+#if JUCE_LINUX
+ #include <pthread.h>
+ #include <sched.h>
+ #include <sys/resource.h>
+ #include <sys/syscall.h>
+ #include <unistd.h>
+ #include <cerrno>
+#endif
+
+//==============================================================================
+namespace
+{
+    constexpr int numRoles = 3;
+    const char* const environmentVariables[numRoles] = { "NDI_CAPTURE_THREADS", "NDI_CONVERT_THREADS", "NDI_SEND_THREADS" };
+
+    struct PolicyRegistry
+    {
+        juce::CriticalSection lock;
+        NdiThreadPolicy policies[numRoles];
+        bool isLoaded[numRoles] = {};
+
+        // Bit n set once role n is loaded and has the default policy, read without the lock on every ticket.
+        std::atomic<juce::uint32> defaultRoles{ 0 };
+    };
+
+    PolicyRegistry& getRegistry()
+    {
+        static PolicyRegistry registry;
+        return registry;
+    }
+
+    NdiPipelineStats::ThreadScheduling& getScheduling(NdiThreadPolicy::Role role, NdiPipelineStats& stats)
+    {
+        switch (role)
+        {
+        case NdiThreadPolicy::Role::capture: return stats.captureThreads;
+        case NdiThreadPolicy::Role::conversion: return stats.conversionThreads;
+        case NdiThreadPolicy::Role::send: break;
+        }
+        return stats.sendThreads;
+    }
+
+    /** What the calling thread got the last time a policy was applied to it. */
+    struct AppliedPolicy
+    {
+        int role{ -1 };
+        NdiPipelineStats::ThreadScheduling::Scheduler scheduler{ NdiPipelineStats::ThreadScheduling::normal };
+        int priority{ 0 };
+        int niceValue{ 0 };
+        juce::uint64 cpuMask{ 0 };
+        // Nothing was changed from how the thread started.
+        bool isDefault{ false };
+    };
+
+    thread_local AppliedPolicy appliedPolicy;
+
+#if JUCE_LINUX
+    /** How the thread was scheduled before the first policy, put back where a later policy leaves something out. */
+    struct BaselineScheduling
+    {
+        bool isCaptured{ false };
+        int niceValue{ 0 };
+        cpu_set_t cpus;
+    };
+
+    thread_local BaselineScheduling baselineScheduling;
+#endif
+
+    bool isInteger(const juce::String& text)
+    {
+        const auto digits = text.startsWithChar('-') || text.startsWithChar('+') ? text.substring(1) : text;
+        return digits.isNotEmpty() && digits.containsOnly("0123456789");
+    }
+
+    /** "0,2-3" to bits 0, 2 and 3. Returns 0 if any part is malformed. */
+    juce::uint64 parseCpuList(const juce::String& text)
+    {
+        juce::uint64 mask = 0;
+        for (const auto& range : juce::StringArray::fromTokens(text, ",", ""))
+        {
+            const auto first = range.upToFirstOccurrenceOf("-", false, false).trim();
+            const auto last = range.containsChar('-') ? range.fromFirstOccurrenceOf("-", false, false).trim() : first;
+            if (!first.containsOnly("0123456789") || !last.containsOnly("0123456789") || first.isEmpty() || last.isEmpty())
+                return 0;
+
+            const int first_cpu = first.getIntValue();
+            const int last_cpu = last.getIntValue();
+            if (first_cpu > last_cpu || last_cpu > 63)
+                return 0;
+
+            for (int cpu = first_cpu; cpu <= last_cpu; ++cpu)
+                mask |= (juce::uint64)1 << cpu;
+        }
+        return mask;
+    }
+}
+
+//==============================================================================
+NdiThreadPolicy NdiThreadPolicy::fromString(const juce::String& text)
+{
+    NdiThreadPolicy policy;
+
+    for (const auto& setting : juce::StringArray::fromTokens(text, " ", ""))
+    {
+        const auto key = setting.upToFirstOccurrenceOf("=", false, false).trim().toLowerCase();
+        const auto value = setting.fromFirstOccurrenceOf("=", false, false).trim();
+
+        if ((key == "fifo" || key == "rr") && isInteger(value))
+        {
+            policy.scheduler = key == "fifo" ? Scheduler::fifo : Scheduler::roundRobin;
+            policy.realtimePriority = juce::jlimit(1, 99, value.getIntValue());
+        }
+        else if (key == "nice" && isInteger(value))
+        {
+            policy.hasNiceValue = true;
+            policy.niceValue = juce::jlimit(-20, 19, value.getIntValue());
+        }
+        else if (key == "cpus")
+        {
+            policy.cpuMask = parseCpuList(value);
+        }
+    }
+
+    return policy;
+}
+
+//==============================================================================
+NdiThreadPolicy NdiThreadPolicy::getForRole(Role role)
+{
+    auto& registry = getRegistry();
+    const int role_idx = (int)role;
+
+    const juce::ScopedLock registry_lock(registry.lock);
+    if (!registry.isLoaded[role_idx])
+    {
+        registry.policies[role_idx] = fromString(juce::SystemStats::getEnvironmentVariable(environmentVariables[role_idx], {}));
+        registry.isLoaded[role_idx] = true;
+        if (registry.policies[role_idx].isDefault())
+            registry.defaultRoles.fetch_or(1U << role_idx);
+    }
+    return registry.policies[role_idx];
+}
+
+void NdiThreadPolicy::setForRole(Role role, const NdiThreadPolicy& policy)
+{
+    auto& registry = getRegistry();
+    const int role_idx = (int)role;
+
+    const juce::ScopedLock registry_lock(registry.lock);
+    registry.policies[role_idx] = policy;
+    registry.isLoaded[role_idx] = true;
+    if (policy.isDefault())
+        registry.defaultRoles.fetch_or(1U << role_idx);
+    else
+        registry.defaultRoles.fetch_and(~(1U << role_idx));
+}
+
+//==============================================================================
+void NdiThreadPolicy::applyToCurrentThread(Role role, NdiPipelineStats& stats)
+{
+    const auto policy = getForRole(role);
+    int num_refused = 0;
+
+#if JUCE_LINUX
+    const pthread_t thread = pthread_self();
+    const auto thread_id = (id_t)syscall(SYS_gettid);
+
+    auto& baseline = baselineScheduling;
+    if (!baseline.isCaptured)
+    {
+        errno = 0;
+        const int nice_value = getpriority(PRIO_PROCESS, thread_id);
+        baseline.niceValue = errno == 0 ? nice_value : 0;
+        CPU_ZERO(&baseline.cpus);
+        pthread_getaffinity_np(thread, sizeof(baseline.cpus), &baseline.cpus);
+        baseline.isCaptured = true;
+    }
+    else
+    {
+        // A pool thread that ran another role before, what that role set and this one does not is undone.
+        if (!policy.hasNiceValue)
+            setpriority(PRIO_PROCESS, thread_id, baseline.niceValue);
+        if (policy.cpuMask == 0)
+            pthread_setaffinity_np(thread, sizeof(baseline.cpus), &baseline.cpus);
+        if (policy.scheduler == Scheduler::normal)
+        {
+            sched_param normal_param{};
+            pthread_setschedparam(thread, SCHED_OTHER, &normal_param);
+        }
+    }
+
+    // On Linux the nice value belongs to the thread, not the process.
+    if (policy.hasNiceValue && setpriority(PRIO_PROCESS, thread_id, policy.niceValue) != 0)
+        ++num_refused;
+
+    if (policy.cpuMask != 0)
+    {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        for (int cpu = 0; cpu < 64; ++cpu)
+        {
+            if ((policy.cpuMask >> cpu & 1) != 0)
+                CPU_SET(cpu, &cpus);
+        }
+
+        if (pthread_setaffinity_np(thread, sizeof(cpus), &cpus) != 0)
+            ++num_refused;
+    }
+
+    if (policy.scheduler != Scheduler::normal)
+    {
+        const int sched_policy = policy.scheduler == Scheduler::fifo ? SCHED_FIFO : SCHED_RR;
+        sched_param param{};
+        param.sched_priority = juce::jlimit(sched_get_priority_min(sched_policy), sched_get_priority_max(sched_policy), policy.realtimePriority);
+
+        if (pthread_setschedparam(thread, sched_policy, &param) != 0)
+        {
+            ++num_refused;
+
+            // Without CAP_SYS_NICE an unprivileged thread may still go up to the RLIMIT_RTPRIO soft limit.
+            rlimit limit;
+            if (getrlimit(RLIMIT_RTPRIO, &limit) == 0 && limit.rlim_cur > 0 && limit.rlim_cur < (rlim_t)param.sched_priority)
+            {
+                param.sched_priority = (int)limit.rlim_cur;
+                pthread_setschedparam(thread, sched_policy, &param);
+            }
+        }
+    }
+
+    // What the thread actually got, which is what the stats show.
+    int actual_policy = SCHED_OTHER;
+    sched_param actual_param{};
+    pthread_getschedparam(thread, &actual_policy, &actual_param);
+
+    errno = 0;
+    const int actual_nice = getpriority(PRIO_PROCESS, thread_id);
+    const bool has_actual_nice = errno == 0;
+
+    juce::uint64 actual_cpu_mask = 0;
+    cpu_set_t actual_cpus;
+    CPU_ZERO(&actual_cpus);
+    // Left at 0 while the thread may run on every CPU, so the stats only show a real restriction.
+    if (pthread_getaffinity_np(thread, sizeof(actual_cpus), &actual_cpus) == 0
+        && CPU_COUNT(&actual_cpus) < sysconf(_SC_NPROCESSORS_ONLN))
+    {
+        for (int cpu = 0; cpu < 64; ++cpu)
+        {
+            if (CPU_ISSET(cpu, &actual_cpus))
+                actual_cpu_mask |= (juce::uint64)1 << cpu;
+        }
+    }
+
+    appliedPolicy.scheduler = actual_policy == SCHED_FIFO ? NdiPipelineStats::ThreadScheduling::fifo
+                            : actual_policy == SCHED_RR ? NdiPipelineStats::ThreadScheduling::roundRobin
+                            : NdiPipelineStats::ThreadScheduling::normal;
+    appliedPolicy.priority = actual_param.sched_priority;
+    appliedPolicy.niceValue = has_actual_nice ? actual_nice : 0;
+    appliedPolicy.cpuMask = actual_cpu_mask;
+#else
+    // Left to the host's scheduling elsewhere.
+    if (!policy.isDefault())
+        ++num_refused;
+
+    appliedPolicy = AppliedPolicy();
+#endif
+
+    appliedPolicy.role = (int)role;
+    appliedPolicy.isDefault = policy.isDefault();
+    getScheduling(role, stats).set(appliedPolicy.scheduler, appliedPolicy.priority, appliedPolicy.niceValue, appliedPolicy.cpuMask);
+
+    if (num_refused > 0)
+    {
+        DBG("The system refused " << num_refused << " part(s) of the thread policy, the thread runs on without them.");
+        stats.threadPolicyRefusals.add((juce::uint64)num_refused);
+    }
+}
+
+void NdiThreadPolicy::switchCurrentThreadTo(Role role, NdiPipelineStats& stats)
+{
+    if (appliedPolicy.role != (int)role)
+    {
+        // Neither role changes anything, so the thread stays as it is and not a single call is made.
+        const bool is_new_default = (getRegistry().defaultRoles.load(std::memory_order_acquire) & (1U << (int)role)) != 0;
+        if (!(appliedPolicy.role >= 0 && appliedPolicy.isDefault && is_new_default))
+        {
+            applyToCurrentThread(role, stats);
+            return;
+        }
+
+        appliedPolicy.role = (int)role;
+    }
+
+    // Already scheduled the way this role wants, only this owner's stats have to hear about it.
+    getScheduling(role, stats).set(appliedPolicy.scheduler, appliedPolicy.priority, appliedPolicy.niceValue, appliedPolicy.cpuMask);
+}
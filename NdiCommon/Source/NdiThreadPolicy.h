@@ -0,0 +1,80 @@
+/*
+  ==============================================================================
+
+    NdiThreadPolicy.h
+    Created: 20 Oct 2026 1:22:47am
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "NdiPipelineStats.h"
+
+//==============================================================================
+/**
+    How an NDI worker thread is scheduled: its nice value, a real-time policy
+    and priority, and the CPUs it may run on.
+
+    There is one policy per role for the whole process. It is read from
+    NDI_CAPTURE_THREADS, NDI_CONVERT_THREADS or NDI_SEND_THREADS the first time
+    it is needed, e.g. "fifo=20 cpus=2-3" or "nice=-5", and the command-line
+    tools can set it from their options. Dedicated threads apply it once when
+    they start, the shared executor's threads whenever they take up work of
+    another role. Either way what they actually got is recorded in the stats.
+
+    Only Linux applies anything. Real-time scheduling needs CAP_SYS_NICE or an
+    RLIMIT_RTPRIO. Without them the priority is lowered to the limit, or the
+    thread stays on the normal scheduler. Each refusal is counted and the
+    thread runs on.
+*/
+class NdiThreadPolicy
+{
+public:
+    //==============================================================================
+    enum class Role
+    {
+        capture,
+        conversion,
+        send
+    };
+
+    enum class Scheduler
+    {
+        normal,
+        fifo,
+        roundRobin
+    };
+
+    Scheduler scheduler{ Scheduler::normal };
+    /** 1 to 99, for fifo and roundRobin only. */
+    int realtimePriority{ 0 };
+    bool hasNiceValue{ false };
+    int niceValue{ 0 };
+    /** Bit n allows CPU n, 0 leaves the affinity alone. */
+    juce::uint64 cpuMask{ 0 };
+
+    bool isDefault() const { return scheduler == Scheduler::normal && !hasNiceValue && cpuMask == 0; }
+
+    //==============================================================================
+    /** Reads space separated settings: "fifo=<priority>", "rr=<priority>", "nice=<value>" and
+        "cpus=<list>", the list like "0,2-3". Unknown or malformed settings are left out.
+    */
+    static NdiThreadPolicy fromString(const juce::String& text);
+    juce::String toString() const;
+
+    static NdiThreadPolicy getForRole(Role role);
+    /** Affects threads started afterwards. */
+    static void setForRole(Role role, const NdiThreadPolicy& policy);
+
+    //==============================================================================
+    /** Applies the role's policy to the calling thread and records the outcome in the stats. */
+    static void applyToCurrentThread(Role role, NdiPipelineStats& stats);
+
+    /** For pool threads that run work of every role. Applies the role's policy only if the thread has
+        another one, undoing what that one set, and otherwise just records it in the stats, which is cheap.
+        Switching between roles that both have the default policy makes no system calls at all.
+    */
+    static void switchCurrentThreadTo(Role role, NdiPipelineStats& stats);
+};
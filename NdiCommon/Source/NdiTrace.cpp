@@ -0,0 +1,263 @@
+/*
+  ==============================================================================
+
+    NdiTrace.cpp
+    Created: 19 Oct 2026 1:12:40pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include "NdiTrace.h"
+#include <map>
+
+//==============================================================================
+namespace
+{
+    /** Every ring ever created. Rings are never deleted, a thread that exits hands its ring to the next new one. */
+    struct TraceRegistry
+    {
+        static constexpr int maxNumThreads = 64;
+
+        TraceRegistry()
+            : originTicks(NdiTrace::now())
+            , originHighResolutionTicks(juce::Time::getHighResolutionTicks())
+        {
+        }
+
+        double getTicksPerMicrosecond() const
+        {
+            // The trace clock is not always the high resolution clock, so measure its rate against it.
+            // Wait for a few milliseconds to have passed since the origin to keep the error small.
+            while (juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - originHighResolutionTicks) < 0.01)
+                juce::Thread::sleep(1);
+
+            const auto elapsed_ticks = NdiTrace::now() - originTicks;
+            const auto elapsed_seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - originHighResolutionTicks);
+            return (double)elapsed_ticks / (elapsed_seconds * 1.0e6);
+        }
+
+        // Held to add or reuse a ring, and while the rings are copied out.
+        juce::SpinLock lock;
+        juce::OwnedArray<NdiTrace::ThreadBuffer> buffers;
+        int nextThreadId{ 1 };
+
+        const juce::uint64 originTicks;
+        const juce::int64 originHighResolutionTicks;
+    };
+
+    TraceRegistry& getRegistry()
+    {
+        static TraceRegistry registry;
+        return registry;
+    }
+
+    juce::String getCurrentThreadName(int threadId)
+    {
+        if (auto* thread = juce::Thread::getCurrentThread())
+            return thread->getThreadName();
+
+        if (juce::MessageManager::existsAndIsCurrentThread())
+            return "Message Thread";
+
+        // Host threads, which for a plugin are usually the audio threads.
+        return "Host Thread " + juce::String(threadId);
+    }
+
+    struct CopiedEvent
+    {
+        const char* name;
+        juce::uint64 startTicks;
+        juce::uint64 endTicks;
+    };
+
+    struct CopiedThread
+    {
+        int threadId;
+        juce::String threadName;
+        std::vector<CopiedEvent> events;
+    };
+}
+
+//==============================================================================
+class NdiTraceThreadAccess
+{
+public:
+    static NdiTrace::ThreadBuffer* registerCurrentThread()
+    {
+        auto& registry = getRegistry();
+        const juce::SpinLock::ScopedLockType registry_lock(registry.lock);
+
+        NdiTrace::ThreadBuffer* buffer = nullptr;
+        if (registry.buffers.size() < TraceRegistry::maxNumThreads)
+        {
+            buffer = registry.buffers.add(new NdiTrace::ThreadBuffer());
+        }
+        else
+        {
+            for (auto* retired : registry.buffers)
+            {
+                if (retired->isRetired.load())
+                {
+                    buffer = retired;
+                    break;
+                }
+            }
+        }
+
+        if (buffer == nullptr)
+            return nullptr;
+
+        // The zones of a previous thread are dropped rather than shown under this one.
+        buffer->readStartIndex.store(buffer->writeIndex.load());
+        buffer->threadId = registry.nextThreadId++;
+        buffer->threadName = getCurrentThreadName(buffer->threadId);
+        buffer->isRetired.store(false);
+        return buffer;
+    }
+
+    static void retire(NdiTrace::ThreadBuffer* buffer) noexcept
+    {
+        buffer->isRetired.store(true);
+    }
+
+    static void copyEvents(NdiTrace::ThreadBuffer& buffer, CopiedThread& copied)
+    {
+        const auto end_index = buffer.writeIndex.load(std::memory_order_acquire);
+        const auto capacity = (juce::uint64)NdiTrace::ThreadBuffer::capacity;
+        auto start_index = juce::jmax(buffer.readStartIndex.load(), end_index > capacity ? end_index - capacity : 0);
+
+        copied.threadId = buffer.threadId;
+        copied.threadName = buffer.threadName;
+        copied.events.reserve((size_t)(end_index - start_index));
+
+        for (auto index = start_index; index < end_index; ++index)
+        {
+            const auto& event = buffer.events[index & (capacity - 1)];
+            copied.events.push_back({ event.name.load(std::memory_order_relaxed),
+                                      event.startTicks.load(std::memory_order_relaxed),
+                                      event.endTicks.load(std::memory_order_relaxed) });
+        }
+
+        // The owner kept writing while this copied, the oldest slots may have been overwritten meanwhile.
+        const auto new_end_index = buffer.writeIndex.load(std::memory_order_acquire);
+        if (new_end_index > start_index + capacity - 1)
+        {
+            const auto num_overwritten = juce::jmin((juce::uint64)copied.events.size(), new_end_index + 1 - capacity - start_index);
+            copied.events.erase(copied.events.begin(), copied.events.begin() + (std::ptrdiff_t)num_overwritten);
+        }
+    }
+
+    static void clear(NdiTrace::ThreadBuffer& buffer) noexcept
+    {
+        buffer.readStartIndex.store(buffer.writeIndex.load());
+    }
+};
+
+//==============================================================================
+NdiTrace::ThreadBuffer* NdiTrace::getThreadBuffer() noexcept
+{
+    thread_local ThreadBuffer* thread_buffer = nullptr;
+    thread_local bool has_registered = false;
+
+    if (thread_buffer != nullptr || has_registered)
+        return thread_buffer;
+
+    has_registered = true;
+    thread_buffer = NdiTraceThreadAccess::registerCurrentThread();
+
+    // Hands the ring back when this thread exits.
+    struct Retirer
+    {
+        ~Retirer() { if (buffer != nullptr) NdiTraceThreadAccess::retire(buffer); }
+        ThreadBuffer* buffer;
+    };
+    thread_local Retirer retirer{ thread_buffer };
+
+    return thread_buffer;
+}
+
+//==============================================================================
+bool NdiTrace::writeChromeTrace(const juce::File& file)
+{
+    file.deleteFile();
+    juce::FileOutputStream stream(file);
+    if (stream.failedToOpen())
+        return false;
+
+    writeChromeTrace(stream);
+    stream.flush();
+    return stream.getStatus().wasOk();
+}
+
+void NdiTrace::writeChromeTrace(juce::OutputStream& stream)
+{
+    auto& registry = getRegistry();
+    const auto ticks_per_microsecond = registry.getTicksPerMicrosecond();
+
+    std::vector<CopiedThread> threads;
+    {
+        const juce::SpinLock::ScopedLockType registry_lock(registry.lock);
+        threads.resize((size_t)registry.buffers.size());
+        for (int i = 0; i < registry.buffers.size(); ++i)
+            NdiTraceThreadAccess::copyEvents(*registry.buffers.getUnchecked(i), threads[(size_t)i]);
+    }
+
+    // Zone names are literals, so each one is escaped once.
+    std::map<const char*, juce::String> quoted_names;
+    const auto quote = [](const juce::String& text) { return juce::JSON::toString(juce::var(text)); };
+
+    const auto to_microseconds = [&](juce::uint64 ticks)
+    {
+        // Ticks from before the origin would wrap around.
+        return ticks > registry.originTicks ? (double)(ticks - registry.originTicks) / ticks_per_microsecond : 0.0;
+    };
+
+    stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool is_first = true;
+    const auto separator = [&is_first]() { const char* text = is_first ? "\n" : ",\n"; is_first = false; return text; };
+
+    for (const auto& thread : threads)
+    {
+        const auto tid = juce::String(thread.threadId);
+        stream << separator() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+               << ",\"args\":{\"name\":" << quote(thread.threadName) << "}}";
+
+        for (const auto& event : thread.events)
+        {
+            auto& quoted_name = quoted_names[event.name];
+            if (quoted_name.isEmpty())
+                quoted_name = quote(event.name != nullptr ? juce::String(event.name) : juce::String("?"));
+
+            const auto start_microseconds = to_microseconds(event.startTicks);
+            const auto duration_microseconds = juce::jmax(0.0, to_microseconds(event.endTicks) - start_microseconds);
+
+            stream << separator() << "{\"name\":" << quoted_name << ",\"cat\":\"ndi\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+                   << ",\"ts\":" << juce::String(start_microseconds, 3) << ",\"dur\":" << juce::String(duration_microseconds, 3) << "}";
+        }
+    }
+
+    stream << "\n]}\n";
+}
+
+juce::File NdiTrace::saveChromeTraceAndReveal()
+{
+    const auto file = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+        .getNonexistentChildFile("NdiTrace_" + juce::Time::getCurrentTime().formatted("%Y%m%d_%H%M%S"), ".json", false);
+
+    if (!writeChromeTrace(file))
+        return {};
+
+    file.revealToUser();
+    return file;
+}
+
+void NdiTrace::clear()
+{
+    auto& registry = getRegistry();
+    const juce::SpinLock::ScopedLockType registry_lock(registry.lock);
+
+    for (auto* buffer : registry.buffers)
+        NdiTraceThreadAccess::clear(*buffer);
+}
@@ -0,0 +1,134 @@
+/*
+  ==============================================================================
+
+    NdiTrace.h
+    Created: 19 Oct 2026 1:12:40pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+#if JUCE_MSVC && JUCE_INTEL
+ #include <intrin.h>
+#elif JUCE_INTEL
+ #include <x86intrin.h>
+#endif
+
+// Set NDI_TRACE_ENABLED=1 in the exporter's preprocessor definitions to record trace zones.
+// Otherwise NDI_TRACE_ZONE expands to nothing and the pipeline carries no tracing code at all.
+#ifndef NDI_TRACE_ENABLED
+ #define NDI_TRACE_ENABLED 0
+#endif
+
+//==============================================================================
+/**
+    Records timed zones of the send and receive pipelines, to be viewed as a
+    timeline in chrome://tracing or https://ui.perfetto.dev.
+
+    Each thread writes into its own lock-free ring of the last zones it closed,
+    so recording never blocks and never allocates after the first zone of a
+    thread. writeChromeTrace() may be called from any thread at any time.
+
+    Zone names must be string literals, only the pointer is stored.
+*/
+class NdiTrace
+{
+public:
+    //==============================================================================
+    struct Event
+    {
+        std::atomic<const char*> name{ nullptr };
+        std::atomic<juce::uint64> startTicks{ 0 };
+        std::atomic<juce::uint64> endTicks{ 0 };
+    };
+
+    class ThreadBuffer
+    {
+    public:
+        static constexpr int capacity = 1 << 14;
+
+        void add(const char* name, juce::uint64 startTicks, juce::uint64 endTicks) noexcept
+        {
+            // Only the owning thread writes, the index is published for the dump.
+            const auto index = writeIndex.load(std::memory_order_relaxed);
+            auto& event = events[index & (capacity - 1)];
+            event.name.store(name, std::memory_order_relaxed);
+            event.startTicks.store(startTicks, std::memory_order_relaxed);
+            event.endTicks.store(endTicks, std::memory_order_relaxed);
+            writeIndex.store(index + 1, std::memory_order_release);
+        }
+
+    private:
+        friend class NdiTraceThreadAccess;
+
+        Event events[capacity];
+        std::atomic<juce::uint64> writeIndex{ 0 };
+        std::atomic<juce::uint64> readStartIndex{ 0 };
+        std::atomic<bool> isRetired{ false };
+        int threadId{ 0 };
+        juce::String threadName;
+    };
+
+    //==============================================================================
+    /** Times the scope it lives in, use it through NDI_TRACE_ZONE. */
+    class Zone
+    {
+    public:
+        explicit Zone(const char* name_) noexcept
+            : name(name_), startTicks(now())
+        {
+        }
+
+        ~Zone() noexcept
+        {
+            if (auto* buffer = getThreadBuffer())
+                buffer->add(name, startTicks, now());
+        }
+
+    private:
+        const char* name;
+        const juce::uint64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE(Zone)
+    };
+
+    //==============================================================================
+    /** A cheap timestamp, converted to time when the trace is written. */
+    static juce::uint64 now() noexcept
+    {
+       #if JUCE_INTEL
+        return (juce::uint64)__rdtsc();
+       #elif JUCE_ARM && JUCE_64BIT && ! JUCE_MSVC
+        juce::uint64 ticks;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+        return ticks;
+       #else
+        return (juce::uint64)juce::Time::getHighResolutionTicks();
+       #endif
+    }
+
+    /** The calling thread's ring, created on its first zone. Null when too many threads trace. */
+    static ThreadBuffer* getThreadBuffer() noexcept;
+
+    //==============================================================================
+    /** Writes every zone still held by the rings as Chrome trace event JSON. */
+    static bool writeChromeTrace(const juce::File& file);
+    static void writeChromeTrace(juce::OutputStream& stream);
+
+    /** Writes a new file in the user's documents folder and shows it, for the editors' trace buttons. */
+    static juce::File saveChromeTraceAndReveal();
+
+    /** Drops every recorded zone. */
+    static void clear();
+
+    static constexpr bool isEnabled() noexcept { return NDI_TRACE_ENABLED != 0; }
+};
+
+#if NDI_TRACE_ENABLED
+ #define NDI_TRACE_ZONE(name) const NdiTrace::Zone JUCE_JOIN_MACRO(ndiTraceZone_, __LINE__)(name)
+#else
+ #define NDI_TRACE_ZONE(name)
+#endif
@@ -0,0 +1,243 @@
+/*
+  ==============================================================================
+
+    NdiUnderrunConcealer.cpp
+    Created: 19 Oct 2026 11:48:12pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include "NdiUnderrunConcealer.h"
+#include <cmath>
+#include <cstring>
+
+//==============================================================================
+void NdiUnderrunConcealer::prepare(int numChannels)
+{
+    history.setSize(juce::jmax(1, numChannels), historySize * 2);
+    history.clear();
+    historyEnd = historySize;
+
+    cycle.setSize(history.getNumChannels(), historySize);
+    monoHistory.allocate((size_t)historySize, true);
+    entryOffsets.allocate((size_t)history.getNumChannels(), true);
+
+    reset();
+}
+
+void NdiUnderrunConcealer::reset()
+{
+    state = State::silent;
+}
+
+//==============================================================================
+bool NdiUnderrunConcealer::process(juce::AudioBuffer<float>& block, int numValid, double sampleRate, NdiPipelineStats& stats)
+{
+    const int num_samples = block.getNumSamples();
+    numValid = juce::jlimit(0, num_samples, numValid);
+
+    if (numValid > 0)
+    {
+        if (state == State::silent)
+        {
+            block.applyGainRamp(0, juce::jmin(fadeSamples, numValid), 0.0f, 1.0f);
+        }
+        else if (state == State::concealing)
+        {
+            // Back from a gap, crossfade from the repeats to the real audio.
+            const int num_channels = juce::jmin(block.getNumChannels(), cycle.getNumChannels());
+            const int crossfade_length = juce::jmin(overlap, numValid);
+            const float gain = getConcealGain();
+            for (int ch_idx = 0; ch_idx < num_channels; ++ch_idx)
+            {
+                float* dest = block.getWritePointer(ch_idx);
+                const float* src = cycle.getReadPointer(ch_idx);
+                for (int sample_idx = 0; sample_idx < crossfade_length; ++sample_idx)
+                {
+                    const float concealed = gain * src[(cyclePosition + sample_idx) % period];
+                    const float weight = (sample_idx + 0.5f) / crossfade_length;
+                    dest[sample_idx] = concealed + (dest[sample_idx] - concealed) * weight;
+                }
+            }
+
+            // Gaps that got as far as fading out were counted then.
+            if (numConcealed < maxConcealSamples)
+                stats.underrunsConcealed.add();
+        }
+
+        state = State::playing;
+        appendToHistory(block, 0, numValid);
+    }
+
+    if (numValid < num_samples)
+    {
+        if (state == State::playing)
+        {
+            stats.underruns.add();
+            startConcealing(sampleRate);
+            state = State::concealing;
+        }
+
+        if (state == State::concealing)
+            render(block, numValid, stats);
+        else
+            block.clear(numValid, num_samples - numValid);
+
+        appendToHistory(block, numValid, num_samples - numValid);
+    }
+
+    return state != State::silent;
+}
+
+//==============================================================================
+void NdiUnderrunConcealer::appendToHistory(const juce::AudioBuffer<float>& block, int startSample, int numSamples)
+{
+    if (numSamples >= historySize)
+    {
+        startSample += numSamples - historySize;
+        numSamples = historySize;
+        historyEnd = 0;
+    }
+    else if (historyEnd + numSamples > history.getNumSamples())
+    {
+        for (int ch_idx = 0; ch_idx < history.getNumChannels(); ++ch_idx)
+        {
+            float* data = history.getWritePointer(ch_idx);
+            std::memmove(data, data + historyEnd - historySize, sizeof(float) * (size_t)historySize);
+        }
+        historyEnd = historySize;
+    }
+
+    for (int ch_idx = 0; ch_idx < history.getNumChannels(); ++ch_idx)
+    {
+        if (ch_idx < block.getNumChannels())
+            history.copyFrom(ch_idx, historyEnd, block, ch_idx, startSample, numSamples);
+        else
+            history.clear(ch_idx, historyEnd, numSamples);
+    }
+
+    historyEnd += numSamples;
+}
+
+void NdiUnderrunConcealer::startConcealing(double sampleRate)
+{
+    const double rate = sampleRate > 0.0 ? sampleRate : 48000.0;
+    const int correlation_length = juce::jlimit(16, historySize / 4, juce::roundToInt(correlationMsec * 0.001 * rate));
+    const int max_period = juce::jmin(juce::roundToInt(maxPeriodMsec * 0.001 * rate), historySize - correlation_length, historySize * 4 / 5);
+    const int min_period = juce::jlimit(2, max_period, juce::roundToInt(minPeriodMsec * 0.001 * rate));
+
+    period = findPeriod(min_period, max_period, correlation_length);
+    overlap = juce::jmax(1, period / 4);
+
+    for (int ch_idx = 0; ch_idx < history.getNumChannels(); ++ch_idx)
+    {
+        const float* latest = history.getReadPointer(ch_idx) + historyEnd;
+        float* dest = cycle.getWritePointer(ch_idx);
+
+        // The last period, its end blended into the samples one period before, which run on into its start.
+        juce::FloatVectorOperations::copy(dest, latest - period, period);
+        for (int sample_idx = 0; sample_idx < overlap; ++sample_idx)
+        {
+            const float weight = 0.5f - 0.5f * std::cos(juce::MathConstants<float>::pi * (sample_idx + 0.5f) / overlap);
+            float& sample = dest[period - overlap + sample_idx];
+            sample += (latest[-period - overlap + sample_idx] - sample) * weight;
+        }
+
+        // The repeats start from the sample after latest[-period - 1], this is how far that is from the last one played.
+        entryOffsets[ch_idx] = latest[-1] - latest[-period - 1];
+    }
+
+    cyclePosition = 0;
+    numConcealed = 0;
+    maxConcealSamples = juce::roundToInt(maxConcealMsec * 0.001 * rate);
+}
+
+int NdiUnderrunConcealer::findPeriod(int minPeriod, int maxPeriod, int correlationLength)
+{
+    // The channels summed, the same period is used for all of them.
+    const int length = maxPeriod + correlationLength;
+    juce::FloatVectorOperations::clear(monoHistory.get(), length);
+    for (int ch_idx = 0; ch_idx < history.getNumChannels(); ++ch_idx)
+        juce::FloatVectorOperations::add(monoHistory.get(), history.getReadPointer(ch_idx) + historyEnd - length, length);
+
+    const float* recent = monoHistory.get() + length - correlationLength;
+    const auto get_score = [recent, correlationLength](int lag, int step)
+    {
+        const float* earlier = recent - lag;
+        float cross = 0.0f, energy = 0.0f;
+        for (int sample_idx = 0; sample_idx < correlationLength; sample_idx += step)
+        {
+            cross += recent[sample_idx] * earlier[sample_idx];
+            energy += earlier[sample_idx] * earlier[sample_idx];
+        }
+        return energy > 1.0e-9f ? cross / std::sqrt(energy) : 0.0f;
+    };
+
+    // Every other lag on every other sample first, then the neighbours of the best one in full.
+    int best_lag = maxPeriod;
+    float best_score = 0.0f;
+    for (int lag = minPeriod; lag <= maxPeriod; lag += 2)
+    {
+        const float score = get_score(lag, 2);
+        if (score > best_score)
+        {
+            best_score = score;
+            best_lag = lag;
+        }
+    }
+
+    const int coarse_lag = best_lag;
+    best_score = get_score(coarse_lag, 1);
+    for (int lag = juce::jmax(minPeriod, coarse_lag - 1); lag <= juce::jmin(maxPeriod, coarse_lag + 1); ++lag)
+    {
+        const float score = lag == coarse_lag ? best_score : get_score(lag, 1);
+        if (score > best_score)
+        {
+            best_score = score;
+            best_lag = lag;
+        }
+    }
+
+    return best_lag;
+}
+
+//==============================================================================
+float NdiUnderrunConcealer::getConcealGain() const
+{
+    const int fade_position = numConcealed - maxConcealSamples;
+    return fade_position <= 0 ? 1.0f : juce::jmax(0.0f, 1.0f - (float)fade_position / fadeSamples);
+}
+
+void NdiUnderrunConcealer::render(juce::AudioBuffer<float>& block, int startSample, NdiPipelineStats& stats)
+{
+    const int num_channels = juce::jmin(block.getNumChannels(), cycle.getNumChannels());
+    for (int ch_idx = num_channels; ch_idx < block.getNumChannels(); ++ch_idx)
+        block.clear(ch_idx, startSample, block.getNumSamples() - startSample);
+
+    float* const* dest = block.getArrayOfWritePointers();
+    const float* const* src = cycle.getArrayOfReadPointers();
+
+    for (int sample_idx = startSample; sample_idx < block.getNumSamples(); ++sample_idx)
+    {
+        if (numConcealed == maxConcealSamples)
+            stats.underrunFades.add();
+
+        // Too long to fill in, faded out over the repeats.
+        if (numConcealed >= maxConcealSamples + fadeSamples)
+        {
+            state = State::silent;
+            block.clear(sample_idx, block.getNumSamples() - sample_idx);
+            return;
+        }
+
+        const float gain = getConcealGain();
+        const float entry_weight = numConcealed < overlap ? 1.0f - (float)(numConcealed + 1) / overlap : 0.0f;
+        for (int ch_idx = 0; ch_idx < num_channels; ++ch_idx)
+            dest[ch_idx][sample_idx] = gain * (src[ch_idx][cyclePosition] + entry_weight * entryOffsets[ch_idx]);
+
+        ++numConcealed;
+        if (++cyclePosition == period)
+            cyclePosition = 0;
+    }
+}
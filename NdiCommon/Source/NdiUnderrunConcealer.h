@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    NdiUnderrunConcealer.h
+    Created: 19 Oct 2026 11:48:12pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "NdiPipelineStats.h"
+
+//==============================================================================
+/**
+    Fills short gaps in received audio instead of fading it to silence.
+
+    When the ring runs dry, the last pitch period of the audio is found by
+    autocorrelation and repeated. The end of the period is overlap-added with
+    the audio one period before it, so the repeats join without a click, and
+    the real audio is crossfaded in again when it returns. A gap longer than
+    the limit fades out, and the audio after it fades in.
+
+    Works on the ring's samples, before resampling. prepare() allocates, and
+    process() never does. It costs one period search per gap.
+*/
+class NdiUnderrunConcealer
+{
+public:
+    //==============================================================================
+    /** Call while the audio thread is not running. */
+    void prepare(int numChannels);
+
+    /** Goes silent, the next audio fades in. */
+    void reset();
+
+    /** The longest gap that is filled in before fading out, 0 fades out straight away. */
+    void setMaxConcealMsec(double msec) { maxConcealMsec = juce::jmax(0.0, msec); }
+
+    /** The first numValid samples of the block came from the ring, fills in the rest.
+        Gaps are counted in the stats. Returns false once the output is silent.
+    */
+    bool process(juce::AudioBuffer<float>& block, int numValid, double sampleRate, NdiPipelineStats& stats);
+
+private:
+    //==============================================================================
+    enum class State
+    {
+        silent,
+        playing,
+        concealing
+    };
+
+    void appendToHistory(const juce::AudioBuffer<float>& block, int startSample, int numSamples);
+    void startConcealing(double sampleRate);
+    int findPeriod(int minPeriod, int maxPeriod, int correlationLength);
+    float getConcealGain() const;
+    void render(juce::AudioBuffer<float>& block, int startSample, NdiPipelineStats& stats);
+
+    //==============================================================================
+    State state{ State::silent };
+    double maxConcealMsec{ 40.0 };
+
+    // The newest historySize samples end at historyEnd, the buffer is twice that so they move back only now and then.
+    juce::AudioBuffer<float> history;
+    int historyEnd{ 0 };
+
+    // One period ready to repeat, its end blended into the audio that led to its start.
+    juce::AudioBuffer<float> cycle;
+    juce::HeapBlock<float> monoHistory;
+    juce::HeapBlock<float> entryOffsets;
+    int period{ 1 };
+    int overlap{ 1 };
+    int cyclePosition{ 0 };
+    int numConcealed{ 0 };
+    int maxConcealSamples{ 0 };
+
+    static constexpr int historySize = 4096;
+    static constexpr int fadeSamples = 256;
+    static constexpr double minPeriodMsec = 2.5;
+    static constexpr double maxPeriodMsec = 16.0;
+    static constexpr double correlationMsec = 8.0;
+};
@@ -12,8 +12,10 @@
 
 #include <JuceHeader.h>
 #include <Processing.NDI.Lib.h>
-#include "NdiSendWrapper.h"
 
+/** Converts video between NDI frames and the wrappers' frames, which differ per plugin
+    but share the fields used here.
+*/
 class NdiVideoHelper
 {
 public:
@@ -82,7 +84,8 @@ public:
         return juce::Colour::fromRGBA(r, g, b, a);
     }
 
-    static void convertVideoFrame(NdiSendWrapper::NdiVideoFrame& videoFrame, const NDIlib_video_frame_v2_t& srcFrame)
+    template <typename VideoFrame>
+    static void convertVideoFrame(VideoFrame& videoFrame, const NDIlib_video_frame_v2_t& srcFrame)
     {
         videoFrame.xres = srcFrame.xres;
         videoFrame.yres = srcFrame.yres;
@@ -179,10 +182,10 @@ public:
                     const int pix_idx = x_idx + y_idx * srcFrame.xres;
                     const int fourcc_idx = pix_idx * 3;
                     const int y = srcFrame.p_data[fourcc_idx + 0];
-                    const int u = srcFrame.p_data[fourcc_idx + 1] & 0xf0 >> 4;
-                    const int v = srcFrame.p_data[fourcc_idx + 1] & 0x0f;
+                    const int cb = srcFrame.p_data[fourcc_idx + 1] & 0xf0 >> 4;
+                    const int cr = srcFrame.p_data[fourcc_idx + 1] & 0x0f;
                     const int a = srcFrame.p_data[fourcc_idx + 2];
-                    juce::Colour col = getColourFromYCbCr(y, u, v, a);
+                    juce::Colour col = getColourFromYCbCr(y, cb, cr, a);
                     image.setPixelAt(x_idx, y_idx, col);
                 }
             }
@@ -195,7 +198,8 @@ public:
         videoFrame.image = image;
     }
 
-    static void convertVideoFrame(NDIlib_video_frame_v2_t& destFrame, const NdiSendWrapper::NdiVideoFrame& videoFrame)
+    template <typename VideoFrame>
+    static void convertVideoFrame(NDIlib_video_frame_v2_t& destFrame, const VideoFrame& videoFrame)
     {
         destFrame.FourCC = NDIlib_FourCC_type_UYVY;
         int color_data_size = 0;
@@ -276,4 +280,127 @@ public:
 
         destFrame.p_metadata = NULL;
     }
+
+    /** Decodes a frame straight into an area of an ARGB image, scaled to fit and centred.
+        Only the pixels of the area are produced, each from its nearest source pixel, so a
+        small area costs little however large the frame is. The rest of the area is cleared.
+    */
+    static void convertVideoFrameToArea(juce::Image::BitmapData& dest, const juce::Rectangle<int>& area, const NDIlib_video_frame_v2_t& srcFrame)
+    {
+        jassert(dest.pixelFormat == juce::Image::PixelFormat::ARGB);
+
+        juce::PixelARGB black;
+        black.setARGB(255, 0, 0, 0);
+        for (int y_idx = area.getY(); y_idx < area.getBottom(); ++y_idx)
+        {
+            auto* line = reinterpret_cast<juce::PixelARGB*>(dest.getLinePointer(y_idx)) + area.getX();
+            std::fill(line, line + area.getWidth(), black);
+        }
+
+        if (srcFrame.p_data == nullptr || srcFrame.xres <= 0 || srcFrame.yres <= 0 || area.isEmpty())
+            return;
+
+        const auto picture = juce::RectanglePlacement(juce::RectanglePlacement::centred)
+            .appliedTo(juce::Rectangle<int>(srcFrame.xres, srcFrame.yres), area);
+
+        const juce::uint8* data = srcFrame.p_data;
+        const int yres = srcFrame.yres;
+
+        switch (srcFrame.FourCC)
+        {
+        case NDIlib_FourCC_video_type_e::NDIlib_FourCC_type_RGBA:
+        case NDIlib_FourCC_video_type_e::NDIlib_FourCC_type_RGBX:
+        {
+            // The X formats carry padding where the alpha would be.
+            const int stride = getLineStride(srcFrame, 4);
+            const bool has_alpha = srcFrame.FourCC == NDIlib_FourCC_video_type_e::NDIlib_FourCC_type_RGBA;
+            scaleInto(dest, picture, srcFrame, [=](int x_idx, int y_idx, juce::PixelARGB& pixel)
+                {
+                    const auto* p = data + y_idx * stride + x_idx * 4;
+                    setPixel(pixel, p[0], p[1], p[2], has_alpha ? p[3] : 255);
+                });
+        }
+        break;
+        case NDIlib_FourCC_video_type_e::NDIlib_FourCC_type_BGRA:
+        case NDIlib_FourCC_video_type_e::NDIlib_FourCC_type_BGRX:
+        {
+            const int stride = getLineStride(srcFrame, 4);
+            const bool has_alpha = srcFrame.FourCC == NDIlib_FourCC_video_type_e::NDIlib_FourCC_type_BGRA;
+            scaleInto(dest, picture, srcFrame, [=](int x_idx, int y_idx, juce::PixelARGB& pixel)
+                {
+                    const auto* p = data + y_idx * stride + x_idx * 4;
+                    setPixel(pixel, p[2], p[1], p[0], has_alpha ? p[3] : 255);
+                });
+        }
+        break;
+        case NDIlib_FourCC_video_type_e::NDIlib_FourCC_type_UYVY:
+        case NDIlib_FourCC_video_type_e::NDIlib_FourCC_video_type_UYVA:
+        {
+            // UYVA is a UYVY plane followed by a plane of one alpha byte per pixel.
+            const int stride = getLineStride(srcFrame, 2);
+            const bool has_alpha = srcFrame.FourCC == NDIlib_FourCC_video_type_e::NDIlib_FourCC_video_type_UYVA;
+            const auto* alpha_plane = data + stride * yres;
+            const int alpha_stride = srcFrame.xres;
+
+            scaleInto(dest, picture, srcFrame, [=](int x_idx, int y_idx, juce::PixelARGB& pixel)
+                {
+                    const auto* pair = data + y_idx * stride + (x_idx >> 1) * 4;
+                    const int a = has_alpha ? alpha_plane[y_idx * alpha_stride + x_idx] : 255;
+                    setPixelFromYUV(pixel, pair[(x_idx & 1) != 0 ? 3 : 1], pair[0], pair[2], a);
+                });
+        }
+        break;
+        default:
+            break;
+        }
+    }
+
+private:
+    static int getLineStride(const NDIlib_video_frame_v2_t& srcFrame, int bytesPerPixel)
+    {
+        return srcFrame.line_stride_in_bytes > 0 ? srcFrame.line_stride_in_bytes : srcFrame.xres * bytesPerPixel;
+    }
+
+    /** Visits the nearest source pixel of every pixel of the picture area. */
+    template <typename ReadPixel>
+    static void scaleInto(juce::Image::BitmapData& dest, const juce::Rectangle<int>& picture, const NDIlib_video_frame_v2_t& srcFrame, ReadPixel readPixel)
+    {
+        if (picture.isEmpty())
+            return;
+
+        // 16.16 fixed point, sampling the middle of each destination pixel.
+        const juce::int64 step_x = ((juce::int64)srcFrame.xres << 16) / picture.getWidth();
+        const juce::int64 step_y = ((juce::int64)srcFrame.yres << 16) / picture.getHeight();
+
+        juce::int64 src_y = step_y / 2;
+        for (int y_idx = picture.getY(); y_idx < picture.getBottom(); ++y_idx, src_y += step_y)
+        {
+            const int src_y_idx = juce::jmin(srcFrame.yres - 1, (int)(src_y >> 16));
+            auto* line = reinterpret_cast<juce::PixelARGB*>(dest.getLinePointer(y_idx)) + picture.getX();
+
+            juce::int64 src_x = step_x / 2;
+            for (int x_idx = 0; x_idx < picture.getWidth(); ++x_idx, src_x += step_x)
+                readPixel(juce::jmin(srcFrame.xres - 1, (int)(src_x >> 16)), src_y_idx, line[x_idx]);
+        }
+    }
+
+    static void setPixel(juce::PixelARGB& pixel, int r, int g, int b, int a)
+    {
+        pixel.setARGB((juce::uint8)a, (juce::uint8)r, (juce::uint8)g, (juce::uint8)b);
+        if (a != 255)
+            pixel.premultiply();
+    }
+
+    static void setPixelFromYUV(juce::PixelARGB& pixel, int y, int u, int v, int a)
+    {
+        // The same BT.601 video range conversion as getColourFromYUV, in integers.
+        const int c = 298 * (y - 16) + 128;
+        const int d = u - 128;
+        const int e = v - 128;
+        setPixel(pixel,
+                 juce::jlimit(0, 255, (c + 409 * e) >> 8),
+                 juce::jlimit(0, 255, (c - 100 * d - 208 * e) >> 8),
+                 juce::jlimit(0, 255, (c + 516 * d) >> 8),
+                 a);
+    }
 };
@@ -18,15 +18,20 @@ class AudioRingBuffer
 public:
     static constexpr size_t order = 24;
     static constexpr size_t bufferSize = 1U << order;
-    static constexpr int channelSize = 2;
-
-    AudioRingBuffer()
-        : sampleRate(0), numChannels(0)
+    static constexpr int defaultNumChannels = 2;
+    // The most channels carried, a source with more is cut off here.
+    static constexpr int maxChannels = 64;
+
+    // The default holds minutes of audio, a smaller capacity suits many rings at once.
+    // The storage is planar, capacity samples for each channel.
+    explicit AudioRingBuffer(int capacity = (int)bufferSize)
+        : sampleRate(0), numChannels(0), abstractFifo(capacity)
     {
-        internalBuffer.setSize(channelSize, bufferSize);
+        internalBuffer.setSize(defaultNumChannels, capacity);
     }
 
-    void push(const juce::AudioBuffer<SampleType>& inputBuffer)
+    // Returns the number of samples written, the rest did not fit.
+    int push(const juce::AudioBuffer<SampleType>& inputBuffer)
     {
         int start1, size1, start2, size2;
 
@@ -57,10 +62,16 @@ public:
         }
 
         abstractFifo.finishedWrite(size1 + size2);
+
+        return size1 + size2;
     }
 
+    // Returns the number of samples read, nothing while the storage is being resized.
     int pop(juce::AudioBuffer<SampleType>& outputBuffer)
     {
+        const juce::SpinLock::ScopedTryLockType storage_lock(storageLock);
+        if (!storage_lock.isLocked()) return 0;
+
         int start1, size1, start2, size2;
 
         abstractFifo.prepareToRead(outputBuffer.getNumSamples(), start1, size1, start2, size2);
@@ -99,22 +110,73 @@ public:
         return abstractFifo.getNumReady() != 0;
     }
 
+    int getNumReady() const
+    {
+        return abstractFifo.getNumReady();
+    }
+
+    // Sizes the storage to numChannels. Allocates, call it from the writing thread and never the audio thread.
     void reset()
     {
-        internalBuffer.setSize(numChannels, bufferSize);
+        const juce::SpinLock::ScopedLockType storage_lock(storageLock);
+        internalBuffer.setSize(juce::jlimit(1, maxChannels, numChannels), abstractFifo.getTotalSize());
         internalBuffer.clear();
     }
 
+    // For a source whose channel count changed, sizes the storage to it and drops what was queued in the old format.
+    // Allocates, call it from the writing thread and never the audio thread.
+    void setNumChannels(int newNumChannels)
+    {
+        const juce::SpinLock::ScopedLockType storage_lock(storageLock);
+        numChannels = juce::jlimit(1, maxChannels, newNumChannels);
+        internalBuffer.setSize(numChannels, abstractFifo.getTotalSize());
+        internalBuffer.clear();
+        abstractFifo.reset();
+    }
+
+    // The channels the storage has room for, ask from the writing thread.
+    int getNumStorageChannels() const
+    {
+        return internalBuffer.getNumChannels();
+    }
+
+    // Drops everything ready to read. Only call this from the reading thread.
+    int discardAll()
+    {
+        const juce::SpinLock::ScopedTryLockType storage_lock(storageLock);
+        if (!storage_lock.isLocked()) return 0;
+
+        const int num_ready = abstractFifo.getNumReady();
+        abstractFifo.finishedRead(num_ready);
+        return num_ready;
+    }
+
+    // Drops up to numSamples of the oldest samples. Only call this from the reading thread.
+    int discard(int numSamples)
+    {
+        const juce::SpinLock::ScopedTryLockType storage_lock(storageLock);
+        if (!storage_lock.isLocked()) return 0;
+
+        const int num_discarded = juce::jlimit(0, abstractFifo.getNumReady(), numSamples);
+        abstractFifo.finishedRead(num_discarded);
+        return num_discarded;
+    }
+
     int sampleRate;
     int numChannels;
 
 private:
     juce::AudioBuffer<SampleType> internalBuffer;
-    juce::AbstractFifo abstractFifo{ bufferSize };
+    juce::AbstractFifo abstractFifo;
+
+    // Held by the writer to resize the storage, the reader only ever tries to take it.
+    juce::SpinLock storageLock;
 
 };
 
 
+// Images need juce_graphics, which the headless tools leave out.
+#if JUCE_MODULE_AVAILABLE_juce_graphics
 class VideoRingBuffer
 {
 public:
@@ -128,7 +190,8 @@ public:
         }
     }
 
-    void push(const juce::Image& input)
+    // Returns 0 when the frame did not fit.
+    int push(const juce::Image& input)
     {
         int start1, size1, start2, size2;
 
@@ -145,6 +208,8 @@ public:
         }
 
         abstractFifo.finishedWrite(size1 + size2);
+
+        return size1 + size2;
     }
 
     int pop(juce::Image& output)
@@ -173,7 +238,21 @@ public:
         return abstractFifo.getNumReady() != 0;
     }
 
+    int getNumReady() const
+    {
+        return abstractFifo.getNumReady();
+    }
+
+    // Drops everything ready to read. Only call this from the reading thread.
+    int discardAll()
+    {
+        const int num_ready = abstractFifo.getNumReady();
+        abstractFifo.finishedRead(num_ready);
+        return num_ready;
+    }
+
 private:
     juce::Array<juce::Image> imageBuffer;
     juce::AbstractFifo abstractFifo{ bufferSize };
-};
\ No newline at end of file
+};
+#endif
@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+
+    NdiDiscoveryService.cpp
+    Created: 19 Oct 2026 2:05:17pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include "NdiDiscoveryService.h"
+
+//==============================================================================
+NdiDiscoveryService::NdiDiscoveryService()
+    : juce::Thread("NDI Discovery Thread")
+    , sources(std::make_shared<const SourceList>())
+{
+}
+
+NdiDiscoveryService::~NdiDiscoveryService()
+{
+    // The finder waits in short slices, so this returns quickly.
+    stopThread(findTimeOutMsec * 4);
+}
+
+//==============================================================================
+NdiDiscoveryService::Snapshot NdiDiscoveryService::getSources()
+{
+    ensureStarted();
+    return std::atomic_load(&sources);
+}
+
+void NdiDiscoveryService::addListener(NdiWrapper::SourceListener* listener)
+{
+    listeners.add(listener);
+    ensureStarted();
+}
+
+void NdiDiscoveryService::removeListener(NdiWrapper::SourceListener* listener)
+{
+    listeners.remove(listener);
+}
+
+//==============================================================================
+void NdiDiscoveryService::run()
+{
+    auto ndi_backend = NdiBackend::getDefault();
+
+    // Create a finder
+    NDIlib_find_instance_t p_ndi_finder = ndi_backend->findCreate();
+    if (!p_ndi_finder) return;
+
+    while (!threadShouldExit())
+    {
+        // Returns early as soon as the sources change.
+        if (!ndi_backend->findWaitForSources(p_ndi_finder, findTimeOutMsec))
+            continue;
+
+        uint32_t num_sources = 0;
+        const NDIlib_source_t* p_ndi_sources = ndi_backend->findGetCurrentSources(p_ndi_finder, &num_sources);
+
+        // Copy out everything, the source pointers are only valid until the next call.
+        auto new_sources = std::make_shared<SourceList>();
+        for (uint32_t src_idx = 0; src_idx < num_sources; ++src_idx)
+        {
+            NdiWrapper::NdiSource s{ p_ndi_sources[src_idx].p_ndi_name, p_ndi_sources[src_idx].p_url_address, p_ndi_sources[src_idx].p_ip_address };
+            new_sources->add(s);
+        }
+
+        publish(new_sources);
+    }
+
+    // Destroy the NDI finder
+    ndi_backend->findDestroy(p_ndi_finder);
+}
+
+void NdiDiscoveryService::ensureStarted()
+{
+    const juce::ScopedLock start_lock(startLock);
+
+    // Started once only, without a runtime the thread finishes straight away.
+    if (hasStarted)
+        return;
+
+    hasStarted = true;
+    startThread(3);
+}
+
+void NdiDiscoveryService::publish(Snapshot newSources)
+{
+    if (isSameSourceList(*std::atomic_load(&sources), *newSources))
+        return;
+
+    std::atomic_store(&sources, newSources);
+
+    listeners.call([](NdiWrapper::SourceListener& l) { l.ndiSourcesChanged(); });
+}
+
+bool NdiDiscoveryService::isSameSourceList(const SourceList& a, const SourceList& b)
+{
+    if (a.size() != b.size())
+        return false;
+
+    for (int idx = 0; idx < a.size(); ++idx)
+    {
+        if (a.getReference(idx).NdiName != b.getReference(idx).NdiName
+            || a.getReference(idx).UrlAddress != b.getReference(idx).UrlAddress)
+            return false;
+    }
+
+    return true;
+}
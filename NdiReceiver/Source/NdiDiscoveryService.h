@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    NdiDiscoveryService.h
+    Created: 19 Oct 2026 2:05:17pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "NdiWrapper.h"
+#include "NdiBackend.h"
+
+//==============================================================================
+/**
+    Runs a single NDI finder on a background thread for the whole process.
+
+    Hold it through a juce::SharedResourcePointer<NdiDiscoveryService>. The
+    finder thread starts on first use and stops with the last pointer. It
+    always discovers through the default NdiBackend. The
+    sources are kept as an immutable snapshot which is swapped atomically, so
+    reading them never blocks on the network.
+*/
+class NdiDiscoveryService : private juce::Thread
+{
+public:
+    //==============================================================================
+    using SourceList = juce::Array<NdiWrapper::NdiSource>;
+    using Snapshot = std::shared_ptr<const SourceList>;
+
+    //==============================================================================
+    NdiDiscoveryService();
+    ~NdiDiscoveryService() override;
+
+    //==============================================================================
+    /** Returns the latest sources instantly. */
+    Snapshot getSources();
+
+    /** Listeners are called on the discovery thread whenever the sources change. */
+    void addListener(NdiWrapper::SourceListener* listener);
+    void removeListener(NdiWrapper::SourceListener* listener);
+
+private:
+    //==============================================================================
+    void run() override;
+    void ensureStarted();
+    void publish(Snapshot newSources);
+
+    static bool isSameSourceList(const SourceList& a, const SourceList& b);
+
+    //==============================================================================
+
+    Snapshot sources;
+    juce::ListenerList<NdiWrapper::SourceListener, juce::Array<NdiWrapper::SourceListener*, juce::CriticalSection>> listeners;
+    juce::CriticalSection startLock;
+    bool hasStarted{ false };
+
+    const int findTimeOutMsec{ 40 };
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NdiDiscoveryService)
+};
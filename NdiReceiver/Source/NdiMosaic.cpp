@@ -0,0 +1,161 @@
+/*
+  ==============================================================================
+
+    NdiMosaic.cpp
+    Created: 19 Oct 2026 4:26:03pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include "NdiMosaic.h"
+#include "NdiVideoHelper.h"
+#include "NdiTrace.h"
+
+//==============================================================================
+namespace
+{
+    void copyArea(const juce::Image& source, juce::Image& dest, const juce::Rectangle<int>& area)
+    {
+        const juce::Image::BitmapData source_data(source, area.getX(), area.getY(), area.getWidth(), area.getHeight());
+        juce::Image::BitmapData dest_data(dest, area.getX(), area.getY(), area.getWidth(), area.getHeight(), juce::Image::BitmapData::writeOnly);
+
+        for (int y_idx = 0; y_idx < area.getHeight(); ++y_idx)
+            memcpy(dest_data.getLinePointer(y_idx), source_data.getLinePointer(y_idx), (size_t)(area.getWidth() * source_data.pixelStride));
+    }
+}
+
+//==============================================================================
+NdiMosaic::NdiMosaic()
+{
+    setSize(640, 360);
+}
+
+NdiMosaic::~NdiMosaic()
+{
+}
+
+//==============================================================================
+void NdiMosaic::setSize(int width, int height)
+{
+    const juce::ScopedWriteLock layout_lock(layoutLock);
+
+    wallBounds = { juce::jmax(1, width), juce::jmax(1, height) };
+    stagingImage = juce::Image(juce::Image::PixelFormat::ARGB, wallBounds.getWidth(), wallBounds.getHeight(), true, juce::SoftwareImageType());
+    image = juce::Image(juce::Image::PixelFormat::ARGB, wallBounds.getWidth(), wallBounds.getHeight(), true);
+
+    layOutTiles();
+}
+
+void NdiMosaic::setTileIds(const juce::Array<int>& tileIds)
+{
+    const juce::ScopedWriteLock layout_lock(layoutLock);
+
+    numTiles = juce::jmin(tileIds.size(), maxNumTiles);
+    for (int idx = 0; idx < numTiles; ++idx)
+        tiles[idx].id = tileIds[idx];
+
+    layOutTiles();
+}
+
+juce::Array<NdiMosaic::Tile> NdiMosaic::getTiles() const
+{
+    juce::Array<Tile> result;
+
+    const juce::ScopedReadLock layout_lock(layoutLock);
+    for (int idx = 0; idx < numTiles; ++idx)
+        result.add({ tiles[idx].id, tiles[idx].bounds });
+
+    return result;
+}
+
+void NdiMosaic::layOutTiles()
+{
+    // Called with the layout lock held for writing, so no tile is being drawn.
+    const int num_columns = juce::jmax(1, (int)std::ceil(std::sqrt((double)numTiles)));
+    const int num_rows = juce::jmax(1, (numTiles + num_columns - 1) / num_columns);
+
+    for (int idx = 0; idx < numTiles; ++idx)
+    {
+        const int column = idx % num_columns;
+        const int row = idx / num_columns;
+
+        const int left = wallBounds.getWidth() * column / num_columns;
+        const int top = wallBounds.getHeight() * row / num_rows;
+        const int right = wallBounds.getWidth() * (column + 1) / num_columns;
+        const int bottom = wallBounds.getHeight() * (row + 1) / num_rows;
+
+        // A pixel of gap between the tiles.
+        tiles[idx].bounds = juce::Rectangle<int>::leftTopRightBottom(left, top, right, bottom).reduced(1);
+        tiles[idx].isDirty = false;
+    }
+
+    stagingImage.clear(stagingImage.getBounds());
+    isLayoutChanged = true;
+}
+
+//==============================================================================
+bool NdiMosaic::drawFrame(int tileId, const NDIlib_video_frame_v2_t& frame)
+{
+    if (!enabled)
+        return false;
+
+    const juce::ScopedReadLock layout_lock(layoutLock);
+
+    for (int idx = 0; idx < numTiles; ++idx)
+    {
+        auto& tile = tiles[idx];
+        if (tile.id != tileId)
+            continue;
+
+        {
+            NDI_TRACE_ZONE("Convert video");
+            const juce::SpinLock::ScopedLockType tile_lock(tile.lock);
+            juce::Image::BitmapData staging_data(stagingImage, juce::Image::BitmapData::writeOnly);
+            NdiVideoHelper::convertVideoFrameToArea(staging_data, tile.bounds, frame);
+        }
+
+        tile.isDirty = true;
+        return true;
+    }
+
+    return false;
+}
+
+juce::RectangleList<int> NdiMosaic::updateImage()
+{
+    juce::RectangleList<int> changed_area;
+
+    const juce::ScopedReadLock layout_lock(layoutLock);
+
+    // After a new layout the whole wall is copied, tiles and gaps.
+    if (isLayoutChanged.exchange(false))
+    {
+        for (int idx = 0; idx < numTiles; ++idx)
+            tiles[idx].isDirty = false;
+
+        for (int idx = 0; idx < numTiles; ++idx)
+            tiles[idx].lock.enter();
+
+        copyArea(stagingImage, image, wallBounds);
+
+        for (int idx = 0; idx < numTiles; ++idx)
+            tiles[idx].lock.exit();
+
+        changed_area.add(wallBounds);
+        return changed_area;
+    }
+
+    for (int idx = 0; idx < numTiles; ++idx)
+    {
+        auto& tile = tiles[idx];
+        if (!tile.isDirty.exchange(false))
+            continue;
+
+        const juce::SpinLock::ScopedLockType tile_lock(tile.lock);
+        copyArea(stagingImage, image, tile.bounds);
+        changed_area.add(tile.bounds);
+    }
+
+    return changed_area;
+}
@@ -0,0 +1,89 @@
+/*
+  ==============================================================================
+
+    NdiMosaic.h
+    Created: 19 Oct 2026 4:26:03pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <Processing.NDI.Lib.h>
+
+//==============================================================================
+/**
+    A multiviewer wall: one image split into a grid of tiles, one per source.
+
+    Frames are decoded straight into their tile at tile size by drawFrame(),
+    from any thread, so a wall of sixteen sources costs about as much as one
+    frame of the wall's size. The message thread copies the tiles that changed
+    into the image it draws with updateImage(), and repaints only those.
+*/
+class NdiMosaic
+{
+public:
+    //==============================================================================
+    static constexpr int maxNumTiles = 16;
+
+    struct Tile
+    {
+        int id;
+        juce::Rectangle<int> bounds;
+    };
+
+    NdiMosaic();
+    ~NdiMosaic();
+
+    //==============================================================================
+    /** Frames are only decoded into tiles while enabled. */
+    void setEnabled(bool shouldBeEnabled) { enabled = shouldBeEnabled; }
+    bool isEnabled() const { return enabled; }
+
+    /** Sets the size of the wall. Message thread only. */
+    void setSize(int width, int height);
+
+    /** Lays the tiles out as a grid, in the order given. */
+    void setTileIds(const juce::Array<int>& tileIds);
+    juce::Array<Tile> getTiles() const;
+
+    //==============================================================================
+    /** Decodes a frame into the tile of the given id. Returns false if there is no such tile. */
+    bool drawFrame(int tileId, const NDIlib_video_frame_v2_t& frame);
+
+    /** Brings the drawn image up to date and returns the areas that changed. Message thread only. */
+    juce::RectangleList<int> updateImage();
+    const juce::Image& getImage() const { return image; }
+
+private:
+    //==============================================================================
+    struct TileState
+    {
+        int id{ 0 };
+        juce::Rectangle<int> bounds;
+        juce::SpinLock lock;
+        std::atomic<bool> isDirty{ false };
+    };
+
+    void layOutTiles();
+
+    //==============================================================================
+    std::atomic<bool> enabled{ false };
+
+    // Held for reading while a tile is drawn or copied, and for writing to change the layout.
+    juce::ReadWriteLock layoutLock;
+    TileState tiles[maxNumTiles];
+    int numTiles{ 0 };
+    juce::Rectangle<int> wallBounds;
+    std::atomic<bool> isLayoutChanged{ true };
+
+    // Decoded into by any thread, and never drawn, so a graphics context never caches it.
+    juce::Image stagingImage;
+
+    // Only touched by the message thread.
+    juce::Image image;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NdiMosaic)
+};
@@ -0,0 +1,490 @@
+/*
+  ==============================================================================
+
+    NdiMultiReceiver.cpp
+    Created: 19 Oct 2026 3:05:18pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include "NdiMultiReceiver.h"
+#include <Processing.NDI.Lib.h>
+#include "NdiVideoHelper.h"
+#include "NdiAudioHelper.h"
+#include "RingBuffer.h"
+#include "NdiUnderrunConcealer.h"
+#include "NdiDriftCorrector.h"
+#include "NdiChannelRouter.h"
+#include "NdiExecutor.h"
+
+//==============================================================================
+struct NdiMultiReceiver::Source
+{
+    Source(int id_, const NdiWrapper::NdiSource& description, std::shared_ptr<NdiBackend> backend_,
+           NDIlib_recv_instance_t receiver_, std::shared_ptr<NdiPipelineStats> stats_, std::shared_ptr<NdiMosaic> mosaic_)
+        : id(id_)
+        , name(description.NdiName)
+        , ndiName(description.NdiName.toStdString())
+        , urlAddress(description.UrlAddress.toStdString())
+        , backend(std::move(backend_))
+        , receiver(receiver_)
+        , stats(std::move(stats_))
+        , mosaic(std::move(mosaic_))
+        , conversionQueue("NDI Convert " + description.NdiName, NdiThreadPolicy::Role::conversion, *stats)
+    {
+        NDIlib_source_t ndi_source;
+        ndi_source.p_ndi_name = ndiName.c_str();
+        ndi_source.p_url_address = urlAddress.empty() ? NULL : urlAddress.c_str();
+        backend->recvConnect(receiver, &ndi_source);
+    }
+
+    ~Source()
+    {
+        // The capture task has stopped, once the conversion running is done this is the last user.
+        conversionQueue.cancelAndWait();
+        if (hasPendingFrame)
+            backend->recvFreeVideo(receiver, &pendingFrame);
+
+        backend->recvDestroy(receiver);
+    }
+
+    //==============================================================================
+    int capture()
+    {
+        // Called by the repeating capture task. Never waits for a frame, the worker is shared with every other instance.
+        NDIlib_video_frame_v2_t video_frame;
+        NDIlib_audio_frame_v2_t audio_frame;
+
+        NDIlib_frame_type_e frame_type;
+        {
+            NDI_TRACE_ZONE("Capture");
+            frame_type = backend->recvCapture(receiver, &video_frame, &audio_frame, 0);
+        }
+
+        if (frame_type == NDIlib_frame_type_video)
+        {
+            stats->videoFramesReceived.add();
+            submitVideo(video_frame);
+        }
+        else if (frame_type == NDIlib_frame_type_audio)
+        {
+            stats->audioFramesReceived.add();
+            pushAudio(audio_frame);
+            backend->recvFreeAudio(receiver, &audio_frame);
+        }
+        else if (frame_type == NDIlib_frame_type_none || frame_type == NDIlib_frame_type_error)
+        {
+            // Polled while frames are coming in, a source that went quiet only now and then.
+            return juce::Time::getMillisecondCounter() - lastCaptureMsec < (juce::uint32)quietAfterMsec
+                ? capturePollIntervalMsec
+                : idleIntervalMsec;
+        }
+
+        if (frame_type == NDIlib_frame_type_video || frame_type == NDIlib_frame_type_audio)
+            lastCaptureMsec = juce::Time::getMillisecondCounter();
+
+        // More may be waiting already.
+        return 0;
+    }
+
+    void submitVideo(const NDIlib_video_frame_v2_t& frame)
+    {
+        // Called by the capture task.
+        NDIlib_video_frame_v2_t replaced_frame;
+        bool has_replaced_frame = false;
+        bool should_schedule = false;
+        {
+            const juce::SpinLock::ScopedLockType pending_lock(pendingLock);
+
+            has_replaced_frame = hasPendingFrame;
+            replaced_frame = pendingFrame;
+
+            pendingFrame = frame;
+            hasPendingFrame = true;
+
+            should_schedule = !isScheduled;
+            isScheduled = true;
+        }
+
+        if (has_replaced_frame)
+        {
+            backend->recvFreeVideo(receiver, &replaced_frame);
+            stats->framesSkipped.add();
+        }
+
+        if (should_schedule)
+            conversionQueue.submit([this]() { convertPendingFrames(); });
+    }
+
+    void convertPendingFrames()
+    {
+        // Called on a worker thread, one at a time per source.
+        for (;;)
+        {
+            NDIlib_video_frame_v2_t frame;
+            {
+                const juce::SpinLock::ScopedLockType pending_lock(pendingLock);
+                if (!hasPendingFrame)
+                {
+                    isScheduled = false;
+                    return;
+                }
+
+                frame = pendingFrame;
+                hasPendingFrame = false;
+            }
+
+            // The multiviewer only needs the frame at tile size, no full size image is made.
+            {
+                const auto convert_start_ticks = juce::Time::getHighResolutionTicks();
+                if (mosaic->drawFrame(id, frame))
+                {
+                    stats->convertTime.addSince(convert_start_ticks);
+                    backend->recvFreeVideo(receiver, &frame);
+                    continue;
+                }
+            }
+
+            NdiWrapper::NdiVideoFrame converted_frame;
+            {
+                NDI_TRACE_ZONE("Convert video");
+                const auto convert_start_ticks = juce::Time::getHighResolutionTicks();
+                NdiVideoHelper::convertVideoFrame(converted_frame, frame);
+                stats->convertTime.addSince(convert_start_ticks);
+            }
+            backend->recvFreeVideo(receiver, &frame);
+
+            const juce::SpinLock::ScopedLockType latest_lock(latestLock);
+            latestImage = converted_frame.image;
+            hasNewImage = true;
+        }
+    }
+
+    bool getNewVideoFrame(juce::Image& image)
+    {
+        const juce::SpinLock::ScopedLockType latest_lock(latestLock);
+        if (!hasNewImage)
+            return false;
+
+        image = latestImage;
+        hasNewImage = false;
+        return true;
+    }
+
+    //==============================================================================
+    void pushAudio(NDIlib_audio_frame_v2_t& frame)
+    {
+        // Called by the capture task.
+        NdiWrapper::NdiAudioFrame converted_frame;
+        NdiAudioHelper::convertAudioFrame(converted_frame, frame);
+
+        audioCache.sampleRate = converted_frame.sample_rate;
+
+        // The ring follows the source's channel count, what it held in the old layout is dropped.
+        const int num_channels = juce::jlimit(1, AudioRingBuffer<float>::maxChannels, converted_frame.no_channels);
+        if (num_channels != audioCache.numChannels)
+            audioCache.setNumChannels(num_channels);
+
+        // Nobody listens, keep the ring empty so enabling the audio does not start with stale samples.
+        if (!audioEnabled)
+            return;
+
+        if (audioCache.push(converted_frame.samples) < converted_frame.samples.getNumSamples())
+            stats->framesDropped.add();
+    }
+
+    //==============================================================================
+    const int id;
+    const juce::String name;
+    const std::string ndiName;
+    const std::string urlAddress;
+
+    const std::shared_ptr<NdiBackend> backend;
+    const NDIlib_recv_instance_t receiver;
+    const std::shared_ptr<NdiPipelineStats> stats;
+    const std::shared_ptr<NdiMosaic> mosaic;
+
+    // Used by the capture task only.
+    juce::uint32 lastCaptureMsec{ 0 };
+    const int capturePollIntervalMsec{ 5 };
+    const int idleIntervalMsec{ 100 };
+    const int quietAfterMsec{ 1000 };
+
+    // The frame waiting for conversion, and whether a conversion task is on it.
+    juce::SpinLock pendingLock;
+    NDIlib_video_frame_v2_t pendingFrame;
+    bool hasPendingFrame{ false };
+    bool isScheduled{ false };
+    NdiExecutor::Queue conversionQueue;
+
+    juce::SpinLock latestLock;
+    juce::Image latestImage;
+    bool hasNewImage{ false };
+
+    // About two seconds at 48kHz for each channel, enough for any sensible network jitter.
+    AudioRingBuffer<float> audioCache{ 1 << 17 };
+    std::atomic<bool> audioEnabled{ false };
+    std::atomic<float> gain{ 1.0f };
+
+    // Used by the audio thread only.
+    juce::LagrangeInterpolator interpolators[AudioRingBuffer<float>::maxChannels];
+    NdiChannelRouter router;
+    NdiUnderrunConcealer underrunConcealer;
+    NdiDriftCorrector driftCorrector;
+    bool isLastRenderedSamplesShorten{ true };
+};
+
+//==============================================================================
+NdiMultiReceiver::NdiMultiReceiver()
+    : NdiMultiReceiver(NdiBackend::getDefault())
+{
+}
+
+NdiMultiReceiver::NdiMultiReceiver(std::shared_ptr<NdiBackend> backend)
+    : ndiBackend(std::move(backend))
+    , stats(std::make_shared<NdiPipelineStats>())
+    , mosaic(std::make_shared<NdiMosaic>())
+{
+    entries.reserve(maxNumSources);
+    prepareToPlay(deviceSampleRate, 512);
+}
+
+NdiMultiReceiver::~NdiMultiReceiver()
+{
+    removeAllSources();
+}
+
+//==============================================================================
+int NdiMultiReceiver::addSource(const NdiWrapper::NdiSource& description)
+{
+    {
+        const juce::SpinLock::ScopedLockType entries_lock(entriesLock);
+        if ((int)entries.size() >= maxNumSources)
+            return -1;
+    }
+
+    if (!ndiBackend->isAvailable())
+        return -1;
+
+    auto receiver = ndiBackend->recvCreate();
+    if (receiver == nullptr)
+        return -1;
+
+    Entry entry;
+    entry.source = std::make_shared<Source>(nextSourceId++, description, ndiBackend, receiver, stats, mosaic);
+    entry.captureQueue = std::make_unique<NdiExecutor::Queue>("NDI Capture " + description.NdiName, NdiThreadPolicy::Role::capture, *stats);
+
+    // The queue goes before the source, see Entry.
+    auto* source = entry.source.get();
+    entry.captureQueue->submitRepeating([source]() { return source->capture(); }, NdiExecutor::Lane::audio);
+
+    const int source_id = entry.source->id;
+    entry.source->underrunConcealer.prepare(numOutputChannels);
+
+    {
+        const juce::SpinLock::ScopedLockType entries_lock(entriesLock);
+        entries.push_back(std::move(entry));
+    }
+
+    updateMosaicLayout();
+    return source_id;
+}
+
+void NdiMultiReceiver::removeSource(int sourceId)
+{
+    Entry removed;
+    {
+        const juce::SpinLock::ScopedLockType entries_lock(entriesLock);
+        for (auto it = entries.begin(); it != entries.end(); ++it)
+        {
+            if (it->source->id == sourceId)
+            {
+                removed = std::move(*it);
+                entries.erase(it);
+                break;
+            }
+        }
+    }
+
+    updateMosaicLayout();
+
+    // Outside the lock, so the audio thread is not held up while the capture task stops.
+    // A conversion still running keeps the source alive until it is done.
+    removed.captureQueue.reset();
+}
+
+void NdiMultiReceiver::removeAllSources()
+{
+    std::vector<Entry> removed;
+    {
+        const juce::SpinLock::ScopedLockType entries_lock(entriesLock);
+        removed.swap(entries);
+    }
+
+    updateMosaicLayout();
+
+    // Each capture task stops within one capture, none of them waits for a frame.
+    removed.clear();
+}
+
+juce::Array<int> NdiMultiReceiver::getSourceIds() const
+{
+    juce::Array<int> source_ids;
+
+    const juce::SpinLock::ScopedLockType entries_lock(entriesLock);
+    for (const auto& entry : entries)
+        source_ids.add(entry.source->id);
+
+    return source_ids;
+}
+
+juce::String NdiMultiReceiver::getSourceName(int sourceId) const
+{
+    if (auto source = findSource(sourceId))
+        return source->name;
+
+    return {};
+}
+
+//==============================================================================
+void NdiMultiReceiver::setAudioEnabled(int sourceId, bool shouldMix)
+{
+    if (auto source = findSource(sourceId))
+        source->audioEnabled = shouldMix;
+}
+
+bool NdiMultiReceiver::isAudioEnabled(int sourceId) const
+{
+    if (auto source = findSource(sourceId))
+        return source->audioEnabled;
+
+    return false;
+}
+
+void NdiMultiReceiver::setGain(int sourceId, float newGain)
+{
+    if (auto source = findSource(sourceId))
+        source->gain = newGain;
+}
+
+bool NdiMultiReceiver::getNewVideoFrame(int sourceId, juce::Image& image)
+{
+    if (auto source = findSource(sourceId))
+        return source->getNewVideoFrame(image);
+
+    return false;
+}
+
+//==============================================================================
+void NdiMultiReceiver::prepareToPlay(double sampleRate, int maximumBlockSize, int numOutputs)
+{
+    deviceSampleRate = sampleRate;
+    numOutputChannels = juce::jlimit(1, NdiChannelRouter::maxChannels, numOutputs);
+
+    // Sized for the most channels and samples there can be, mixAudio() only ever shrinks them.
+    const int max_retrieve_samples = maximumBlockSize * maxResampleRatio + 1;
+    retrieveBuffer.setSize(AudioRingBuffer<float>::maxChannels, max_retrieve_samples);
+    routedBuffer.setSize(numOutputChannels, max_retrieve_samples);
+    resampledBuffer.setSize(numOutputChannels, maximumBlockSize);
+
+    const juce::SpinLock::ScopedLockType entries_lock(entriesLock);
+    for (auto& entry : entries)
+    {
+        for (auto& interpolator : entry.source->interpolators)
+            interpolator.reset();
+
+        entry.source->underrunConcealer.prepare(numOutputChannels);
+    }
+}
+
+void NdiMultiReceiver::mixAudio(juce::AudioBuffer<float>& buffer, double targetLatencyMsec)
+{
+    NDI_TRACE_ZONE("Mix");
+
+    // A source is being added or removed right now, it is only one block without the mix.
+    const juce::SpinLock::ScopedTryLockType entries_lock(entriesLock);
+    if (!entries_lock.isLocked())
+        return;
+
+    const int num_samples = juce::jmin(buffer.getNumSamples(), resampledBuffer.getNumSamples());
+    const int num_outputs = juce::jmin(buffer.getNumChannels(), numOutputChannels);
+
+    for (auto& entry : entries)
+    {
+        auto& source = *entry.source;
+        auto& audio_cache = source.audioCache;
+        const int source_sample_rate = audio_cache.sampleRate;
+
+        // Like the connected source, each one plays once its ring holds the target, then is read even when empty.
+        const double target_fill = targetLatencyMsec * 0.001 * source_sample_rate;
+        const bool is_buffered = !source.isLastRenderedSamplesShorten
+            || (audio_cache.isReady() && audio_cache.getNumReady() >= target_fill);
+
+        if (!source.audioEnabled || source_sample_rate <= 0 || !is_buffered)
+        {
+            // Throw away what was captured before the audio was disabled, it would play late otherwise.
+            if (!source.audioEnabled && audio_cache.isReady())
+                audio_cache.pop(retrieveBuffer);
+
+            source.isLastRenderedSamplesShorten = true;
+            source.underrunConcealer.reset();
+            continue;
+        }
+
+        if (const int num_excess = NdiDriftCorrector::getNumExcessSamples(audio_cache.getNumReady(), target_fill, source_sample_rate))
+            audio_cache.discard(num_excess);
+
+        if (source.isLastRenderedSamplesShorten)
+            source.driftCorrector.reset(audio_cache.getNumReady());
+
+        // Pull as many source samples as make one device block, bent to hold the ring at the target, and resample them to the block.
+        const int num_to_retrieve = source.driftCorrector.getNumToRetrieve(num_samples, deviceSampleRate, source_sample_rate,
+                                                                           audio_cache.getNumReady(), target_fill);
+        const int num_retrieve_samples = juce::jlimit(1, routedBuffer.getNumSamples(), num_to_retrieve);
+        const int num_source_channels = juce::jlimit(1, AudioRingBuffer<float>::maxChannels, audio_cache.numChannels);
+
+        // Within the preallocated size, so neither of these allocates.
+        retrieveBuffer.setSize(num_source_channels, num_retrieve_samples, false, false, true);
+        routedBuffer.setSize(numOutputChannels, num_retrieve_samples, false, false, true);
+        retrieveBuffer.clear();
+
+        const int num_retrieved = audio_cache.pop(retrieveBuffer);
+
+        // Onto the bus before resampling, so only the output channels are resampled.
+        if (!source.router.matches(num_source_channels, numOutputChannels))
+            source.router.setDefaultRouting(num_source_channels, numOutputChannels);
+        source.router.process(retrieveBuffer, routedBuffer, num_retrieve_samples);
+
+        // Short gaps are filled in, longer ones fade out, and the audio fades in after.
+        source.isLastRenderedSamplesShorten = !source.underrunConcealer.process(routedBuffer, num_retrieved,
+                                                                                source_sample_rate, *stats);
+
+        const double speed_ratio = (double)num_retrieve_samples / (double)num_samples;
+        const float source_gain = source.gain;
+        for (int ch_idx = 0; ch_idx < num_outputs; ++ch_idx)
+        {
+            source.interpolators[ch_idx].process(speed_ratio, routedBuffer.getReadPointer(ch_idx),
+                                                 resampledBuffer.getWritePointer(ch_idx), num_samples);
+            buffer.addFrom(ch_idx, 0, resampledBuffer, ch_idx, 0, num_samples, source_gain);
+        }
+    }
+}
+
+//==============================================================================
+std::shared_ptr<NdiMultiReceiver::Source> NdiMultiReceiver::findSource(int sourceId) const
+{
+    const juce::SpinLock::ScopedLockType entries_lock(entriesLock);
+    for (const auto& entry : entries)
+    {
+        if (entry.source->id == sourceId)
+            return entry.source;
+    }
+
+    return nullptr;
+}
+
+void NdiMultiReceiver::updateMosaicLayout()
+{
+    mosaic->setTileIds(getSourceIds());
+}
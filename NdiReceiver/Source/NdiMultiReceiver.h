@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    NdiMultiReceiver.h
+    Created: 19 Oct 2026 3:05:18pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "NdiWrapper.h"
+#include "NdiPipelineStats.h"
+#include "NdiBackend.h"
+#include "NdiMosaic.h"
+#include "NdiExecutor.h"
+
+//==============================================================================
+/**
+    Receives several NDI sources at once.
+
+    Each source gets its own NDI receiver and a repeating capture task on the
+    process wide NdiExecutor, which never waits for a frame and only captures
+    and hands the audio over. Video conversion runs on the executor too, each
+    source through its own queue with at most one frame in flight: a frame arriving while the previous one is
+    still converting replaces the one waiting, so a slow machine shows fewer
+    frames instead of older ones.
+
+    While its mosaic is enabled, frames are decoded straight into the source's
+    tile of the mosaic instead of being converted at full size.
+
+    The audio of the sources it is enabled for is resampled to the device rate
+    and mixed into the output by mixAudio().
+*/
+class NdiMultiReceiver
+{
+public:
+    //==============================================================================
+    static constexpr int maxNumSources = 16;
+
+    NdiMultiReceiver();
+    explicit NdiMultiReceiver(std::shared_ptr<NdiBackend> backend);
+    ~NdiMultiReceiver();
+
+    //==============================================================================
+    /** Starts receiving a source. Returns its id, or -1 when it could not be added. */
+    int addSource(const NdiWrapper::NdiSource& source);
+    void removeSource(int sourceId);
+    void removeAllSources();
+
+    juce::Array<int> getSourceIds() const;
+    juce::String getSourceName(int sourceId) const;
+
+    //==============================================================================
+    void setAudioEnabled(int sourceId, bool shouldMix);
+    bool isAudioEnabled(int sourceId) const;
+    void setGain(int sourceId, float newGain);
+
+    /** Takes the newest converted frame of a source. Returns false if none arrived since the last call. */
+    bool getNewVideoFrame(int sourceId, juce::Image& image);
+
+    /** The multiviewer wall of all sources, laid out in the order they were added. */
+    NdiMosaic& getMosaic() { return *mosaic; }
+
+    //==============================================================================
+    /** Call before mixAudio(), while the audio thread is not running. Each source is routed onto numOutputs channels. */
+    void prepareToPlay(double sampleRate, int maximumBlockSize, int numOutputs = 2);
+
+    /** Adds the enabled sources to the buffer. Real-time safe.
+        Each source's ring is held at the target latency, the same one as the connected source's.
+    */
+    void mixAudio(juce::AudioBuffer<float>& buffer, double targetLatencyMsec);
+
+    //==============================================================================
+    /** Summed over all sources. */
+    const NdiPipelineStats& getStats() const { return *stats; }
+
+private:
+    //==============================================================================
+    struct Source;
+
+    // The capture task uses the source, the queue is declared after it so it is cancelled first.
+    struct Entry
+    {
+        std::shared_ptr<Source> source;
+        std::unique_ptr<NdiExecutor::Queue> captureQueue;
+    };
+
+    //==============================================================================
+    std::shared_ptr<Source> findSource(int sourceId) const;
+    void updateMosaicLayout();
+
+    //==============================================================================
+    std::shared_ptr<NdiBackend> ndiBackend;
+    std::shared_ptr<NdiPipelineStats> stats;
+    std::shared_ptr<NdiMosaic> mosaic;
+
+    // Held briefly to change the list, the audio thread only ever tries to take it.
+    juce::SpinLock entriesLock;
+    std::vector<Entry> entries;
+    int nextSourceId{ 1 };
+
+    double deviceSampleRate{ 44100.0 };
+    int numOutputChannels{ 2 };
+    juce::AudioBuffer<float> retrieveBuffer;
+    juce::AudioBuffer<float> routedBuffer;
+    juce::AudioBuffer<float> resampledBuffer;
+
+    // Sources faster than this are not kept up with, the rest of their audio runs over.
+    static constexpr int maxResampleRatio = 8;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NdiMultiReceiver)
+};
@@ -0,0 +1,282 @@
+/*
+  ==============================================================================
+
+    NdiRecorder.cpp
+    Created: 19 Oct 2026 5:12:47pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include "NdiRecorder.h"
+
+//==============================================================================
+NdiRecorder::NdiRecorder(const juce::File& file_, const juce::String& sourceName, NdiPipelineStats& stats_, size_t bufferBytes)
+    : juce::Thread("NDI Recorder")
+    , file(file_)
+    , stats(stats_)
+    , startTicks(juce::Time::getHighResolutionTicks())
+{
+    file.deleteFile();
+    fileStream = std::make_unique<juce::FileOutputStream>(file);
+    if (fileStream->failedToOpen())
+    {
+        fileStream.reset();
+        return;
+    }
+
+    // Whole blocks at block aligned addresses, so every write is a run of complete pages.
+    bufferSize = juce::jmax((size_t)NdiRecordingFormat::blockSize, bufferBytes & ~(size_t)(NdiRecordingFormat::blockSize - 1));
+    storage.malloc(bufferSize + NdiRecordingFormat::blockSize);
+    buffer = reinterpret_cast<char*>(((juce::pointer_sized_uint)storage.get() + NdiRecordingFormat::blockSize - 1) & ~(juce::pointer_sized_uint)(NdiRecordingFormat::blockSize - 1));
+
+    chunks.resize((size_t)chunkFifo.getTotalSize());
+    index.reserve(1 << 16);
+
+    juce::HeapBlock<char> header_block(NdiRecordingFormat::blockSize, true);
+    auto* header = reinterpret_cast<NdiRecordingFormat::FileHeader*>(header_block.get());
+    header->magic = NdiRecordingFormat::fileMagic;
+    header->version = NdiRecordingFormat::version;
+    header->blockSize = NdiRecordingFormat::blockSize;
+    header->createdMillis = juce::Time::currentTimeMillis();
+    sourceName.copyToUTF8(header->sourceName, sizeof(header->sourceName));
+
+    if (!fileStream->write(header_block.get(), NdiRecordingFormat::blockSize))
+    {
+        fileStream.reset();
+        return;
+    }
+
+    fileOffset = NdiRecordingFormat::blockSize;
+    startThread(5);
+}
+
+NdiRecorder::~NdiRecorder()
+{
+    if (!isOpen())
+        return;
+
+    // Whatever is still buffered is written before the index, however long that takes.
+    signalThreadShouldExit();
+    stopThread(-1);
+
+    finishFile();
+}
+
+//==============================================================================
+bool NdiRecorder::writeVideo(const NDIlib_video_frame_v2_t& frame)
+{
+    const auto data_bytes = NdiRecordingFormat::getVideoDataBytes(frame);
+    auto* header = (isOpen() && frame.p_data != nullptr && data_bytes > 0) ? reserveChunk(NdiRecordingFormat::videoChunk, data_bytes) : nullptr;
+    if (header == nullptr)
+    {
+        stats.framesNotRecorded.add();
+        return false;
+    }
+
+    header->timecode = frame.timecode;
+    header->timestamp = frame.timestamp;
+    header->xres = frame.xres;
+    header->yres = frame.yres;
+    header->fourCC = (juce::uint32)frame.FourCC;
+    header->lineStrideBytes = frame.line_stride_in_bytes;
+    header->frameRateN = frame.frame_rate_N;
+    header->frameRateD = frame.frame_rate_D;
+    header->pictureAspectRatio = frame.picture_aspect_ratio;
+    header->frameFormatType = (juce::int32)frame.frame_format_type;
+
+    memcpy(header + 1, frame.p_data, data_bytes);
+
+    commitChunk(*header);
+    return true;
+}
+
+bool NdiRecorder::writeAudio(const NDIlib_audio_frame_v2_t& frame)
+{
+    const int num_channels = juce::jmax(0, frame.no_channels);
+    const int num_samples = juce::jmax(0, frame.no_samples);
+    const auto channel_bytes = (size_t)num_samples * sizeof(float);
+
+    auto* header = (isOpen() && frame.p_data != nullptr && channel_bytes > 0 && num_channels > 0)
+        ? reserveChunk(NdiRecordingFormat::audioChunk, channel_bytes * (size_t)num_channels) : nullptr;
+    if (header == nullptr)
+    {
+        stats.framesNotRecorded.add();
+        return false;
+    }
+
+    header->timecode = frame.timecode;
+    header->timestamp = frame.timestamp;
+    header->sampleRate = frame.sample_rate;
+    header->numChannels = num_channels;
+    header->numSamples = num_samples;
+
+    // The channels are stored back to back, without the capture's channel stride.
+    auto* dest = reinterpret_cast<char*>(header + 1);
+    const auto* source = reinterpret_cast<const char*>(frame.p_data);
+    for (int ch_idx = 0; ch_idx < num_channels; ++ch_idx)
+        memcpy(dest + (size_t)ch_idx * channel_bytes, source + (size_t)ch_idx * (size_t)frame.channel_stride_in_bytes, channel_bytes);
+
+    commitChunk(*header);
+    return true;
+}
+
+//==============================================================================
+NdiRecordingFormat::ChunkHeader* NdiRecorder::reserveChunk(juce::uint32 type, juce::uint64 payloadBytes)
+{
+    const auto chunk_bytes = (size_t)NdiRecordingFormat::padToBlock(sizeof(NdiRecordingFormat::ChunkHeader) + payloadBytes);
+    if (chunk_bytes > bufferSize || chunkFifo.getFreeSpace() == 0)
+        return nullptr;
+
+    const auto write_position = writePosition.load(std::memory_order_relaxed);
+    const auto read_position = readPosition.load(std::memory_order_acquire);
+
+    // A chunk never wraps around, the end of the buffer is skipped when it would not fit there.
+    auto offset = (size_t)(write_position % bufferSize);
+    const size_t num_skipped = offset + chunk_bytes > bufferSize ? bufferSize - offset : 0;
+    if (write_position + num_skipped + chunk_bytes - read_position > bufferSize)
+        return nullptr;
+
+    if (num_skipped > 0)
+        offset = 0;
+
+    reservedOffset = offset;
+    reservedBytes = num_skipped + chunk_bytes;
+
+    auto* header = reinterpret_cast<NdiRecordingFormat::ChunkHeader*>(buffer + offset);
+    memset(header, 0, sizeof(NdiRecordingFormat::ChunkHeader));
+    header->magic = NdiRecordingFormat::chunkMagic;
+    header->type = type;
+    header->payloadBytes = payloadBytes;
+    header->chunkBytes = chunk_bytes;
+
+    // Keep the padding from carrying old frames into the file.
+    const auto payload_end = sizeof(NdiRecordingFormat::ChunkHeader) + (size_t)payloadBytes;
+    memset(buffer + offset + payload_end, 0, chunk_bytes - payload_end);
+
+    // NDI's timestamps depend on the sender, so the replay goes by when the frames arrived here.
+    const auto elapsed_seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    header->receiveTime = (juce::int64)(elapsed_seconds * 1.0e7);
+
+    return header;
+}
+
+void NdiRecorder::commitChunk(const NdiRecordingFormat::ChunkHeader& header)
+{
+    int start1, size1, start2, size2;
+    chunkFifo.prepareToWrite(1, start1, size1, start2, size2);
+    chunks[(size_t)(size1 > 0 ? start1 : start2)] = { reservedOffset, (size_t)header.chunkBytes, reservedBytes, header.type, header.receiveTime };
+    chunkFifo.finishedWrite(1);
+
+    const auto write_position = writePosition.load(std::memory_order_relaxed) + reservedBytes;
+    writePosition.store(write_position, std::memory_order_release);
+
+    stats.framesRecorded.add();
+    stats.recordBufferFill.set((int)((write_position - readPosition.load(std::memory_order_relaxed)) * 100 / bufferSize));
+}
+
+//==============================================================================
+void NdiRecorder::run()
+{
+    while (!threadShouldExit())
+    {
+        if (!writePendingChunks())
+            wait(writeIntervalMsec);
+    }
+
+    // The capture task no longer writes once the recorder is being destroyed.
+    while (writePendingChunks())
+    {
+    }
+}
+
+bool NdiRecorder::writePendingChunks()
+{
+    const int num_ready = chunkFifo.getNumReady();
+    if (num_ready == 0)
+        return false;
+
+    size_t run_offset = 0;
+    size_t run_bytes = 0;
+    size_t run_reserved_bytes = 0;
+
+    // Chunks that follow each other in the buffer go to the file in one write.
+    const auto write_run = [&]()
+    {
+        if (run_bytes == 0)
+            return;
+
+        if (!hasWriteFailed && !fileStream->write(buffer + run_offset, run_bytes))
+        {
+            // Most likely the disk is full. Keep releasing the buffer so the capture carries on.
+            DBG("NdiRecorder: writing " << file.getFullPathName() << " failed");
+            hasWriteFailed = true;
+        }
+
+        if (!hasWriteFailed)
+            fileOffset += run_bytes;
+
+        readPosition.fetch_add(run_reserved_bytes, std::memory_order_release);
+        run_bytes = 0;
+        run_reserved_bytes = 0;
+    };
+
+    int start1, size1, start2, size2;
+    chunkFifo.prepareToRead(num_ready, start1, size1, start2, size2);
+
+    const auto add_chunks = [&](int startIndex, int numChunks)
+    {
+        for (int idx = startIndex; idx < startIndex + numChunks; ++idx)
+        {
+            const auto& chunk = chunks[(size_t)idx];
+            if (run_bytes > 0 && (chunk.offset != run_offset + run_bytes || run_bytes + chunk.numBytes > maxWriteBytes))
+                write_run();
+
+            if (run_bytes == 0)
+                run_offset = chunk.offset;
+
+            if (!hasWriteFailed)
+                index.push_back({ fileOffset + run_bytes, chunk.receiveTime, chunk.type, 0 });
+
+            run_bytes += chunk.numBytes;
+            run_reserved_bytes += chunk.numBytesReserved;
+        }
+    };
+
+    add_chunks(start1, size1);
+    add_chunks(start2, size2);
+    write_run();
+
+    chunkFifo.finishedRead(size1 + size2);
+
+    return true;
+}
+
+void NdiRecorder::finishFile()
+{
+    if (!hasWriteFailed)
+    {
+        const auto index_bytes = (juce::uint64)index.size() * sizeof(NdiRecordingFormat::IndexEntry);
+        const auto chunk_bytes = NdiRecordingFormat::padToBlock(sizeof(NdiRecordingFormat::ChunkHeader) + index_bytes);
+
+        NdiRecordingFormat::ChunkHeader header;
+        memset(&header, 0, sizeof(header));
+        header.magic = NdiRecordingFormat::chunkMagic;
+        header.type = NdiRecordingFormat::indexChunk;
+        header.payloadBytes = index_bytes;
+        header.chunkBytes = chunk_bytes;
+
+        juce::MemoryBlock index_block((size_t)chunk_bytes, true);
+        index_block.copyFrom(&header, 0, sizeof(header));
+        if (index_bytes > 0)
+            index_block.copyFrom(index.data(), sizeof(header), (size_t)index_bytes);
+
+        NdiRecordingFormat::Trailer trailer{ NdiRecordingFormat::trailerMagic, 0, fileOffset, (juce::uint64)index.size() };
+
+        fileStream->write(index_block.getData(), index_block.getSize());
+        fileStream->write(&trailer, sizeof(trailer));
+    }
+
+    fileStream->flush();
+    fileStream.reset();
+}
@@ -0,0 +1,100 @@
+/*
+  ==============================================================================
+
+    NdiRecorder.h
+    Created: 19 Oct 2026 5:12:47pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <Processing.NDI.Lib.h>
+#include "NdiPipelineStats.h"
+#include "NdiRecordingFormat.h"
+
+//==============================================================================
+/**
+    Writes captured NDI frames to disk as they arrived, see NdiRecordingFormat.
+
+    The capture task copies each frame into a large block aligned buffer and
+    returns. It never waits: a frame that does not fit because the disk is
+    behind is counted and left out. A thread of its own writes the buffer to
+    the file in large runs of whole blocks.
+
+    The file is finished when the recorder is destroyed.
+*/
+class NdiRecorder : private juce::Thread
+{
+public:
+    //==============================================================================
+    // About a quarter of a second of 2160p60 UYVY.
+    static constexpr size_t defaultBufferBytes = (size_t)256 << 20;
+
+    NdiRecorder(const juce::File& file, const juce::String& sourceName, NdiPipelineStats& stats,
+                size_t bufferBytes = defaultBufferBytes);
+    ~NdiRecorder() override;
+
+    /** False if the file could not be created. */
+    bool isOpen() const { return fileStream != nullptr; }
+    const juce::File& getFile() const { return file; }
+
+    //==============================================================================
+    /** Copies a frame for writing. Call from one thread at a time, usually the capture task.
+        Returns false if the frame was left out. */
+    bool writeVideo(const NDIlib_video_frame_v2_t& frame);
+    bool writeAudio(const NDIlib_audio_frame_v2_t& frame);
+
+private:
+    //==============================================================================
+    struct PendingChunk
+    {
+        size_t offset;
+        size_t numBytes;
+        // Including what was skipped at the end of the buffer to keep the chunk in one piece.
+        size_t numBytesReserved;
+        juce::uint32 type;
+        juce::int64 receiveTime;
+    };
+
+    //==============================================================================
+    void run() override;
+
+    NdiRecordingFormat::ChunkHeader* reserveChunk(juce::uint32 type, juce::uint64 payloadBytes);
+    void commitChunk(const NdiRecordingFormat::ChunkHeader& header);
+    bool writePendingChunks();
+    void finishFile();
+
+    //==============================================================================
+    const juce::File file;
+    NdiPipelineStats& stats;
+    std::unique_ptr<juce::FileOutputStream> fileStream;
+
+    // The block aligned ring the capture task copies into.
+    juce::HeapBlock<char> storage;
+    char* buffer{ nullptr };
+    size_t bufferSize{ 0 };
+    std::atomic<juce::uint64> writePosition{ 0 };
+    std::atomic<juce::uint64> readPosition{ 0 };
+    size_t reservedOffset{ 0 };
+    size_t reservedBytes{ 0 };
+
+    juce::AbstractFifo chunkFifo{ 4096 };
+    std::vector<PendingChunk> chunks;
+
+    // Only used by the writing thread.
+    std::vector<NdiRecordingFormat::IndexEntry> index;
+    juce::uint64 fileOffset{ 0 };
+    bool hasWriteFailed{ false };
+
+    const juce::int64 startTicks;
+
+    // Short enough that the buffer never fills while the disk keeps up.
+    const int writeIntervalMsec{ 2 };
+    // Longer runs are split, so the buffer is released while the disk is busy.
+    const size_t maxWriteBytes{ (size_t)32 << 20 };
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NdiRecorder)
+};
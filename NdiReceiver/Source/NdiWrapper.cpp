@@ -12,237 +12,554 @@
 #include <Processing.NDI.Lib.h>
 #include "NdiVideoHelper.h"
 #include "NdiAudioHelper.h"
-
-#if JUCE_MAC
-#include <dlfcn.h>
-#endif
+#include "NdiBackend.h"
+#include "NdiDiscoveryService.h"
+#include "NdiSharedMemoryTransport.h"
+#include "NdiInProcessRouter.h"
+#include "NdiRecorder.h"
+#include "NdiRecordingFormat.h"
 
 //==============================================================================
 class NdiWrapper::Impl
 {
 public:
     //==============================================================================
-    Impl()
+    explicit Impl(NdiPipelineStats& stats_)
+        : stats(stats_)
     {
-#if JUCE_MAC
-        std::string ndi_path;
-        
-        // ToDo
-        const char* p_NDI_runtime_folder = std::getenv("NDI_RUNTIME_DIR_V4");
-        if (p_NDI_runtime_folder)
-        {
-            ndi_path = p_NDI_runtime_folder;
-            ndi_path += "/libndi.dylib";
-        }
-        else
-        {
-            ndi_path = "libndi.4.dylib"; // The standard versioning scheme on Linux based systems using sym links
-        }
-        
-        // Try to load the library
-        void* handle_ndi_lib = ::dlopen(ndi_path.c_str(), RTLD_LOCAL | RTLD_LAZY);
-        
-        // If handle is NULL, Re-try to load the library by absolute path.
-        if(!handle_ndi_lib)
-        {
-            ndi_path = "/usr/local/lib/libndi.4.dylib";
-            handle_ndi_lib = ::dlopen(ndi_path.c_str(), RTLD_LOCAL | RTLD_LAZY);
-        }
-        
-        // The main NDI entry point for dynamic loading if we got the library
-        const NDIlib_v4* (*funcPtr_NDIlib_v4_load)(void) = NULL;
-        if (handle_ndi_lib)
-        {
-            *((void**)&funcPtr_NDIlib_v4_load) = ::dlsym(handle_ndi_lib, "NDIlib_v4_load");
-        }
-        
-        if (!funcPtr_NDIlib_v4_load)
-        {
-            DBG("Please re-install the NewTek NDI Runtimes to use this application.");
-            return;
-        }
-        
-        // Lets get all of the DLL entry points
-        pNdiLib = funcPtr_NDIlib_v4_load();
-        
-        // We can now run as usual
-        if (!pNdiLib->NDIlib_initialize())
-        {    // Cannot run NDI. Most likely because the CPU is not sufficient (see SDK documentation).
-            // you can check this directly with a call to NDIlib_is_supported_CPU()
-            DBG("Cannot run NDI.");
-            return;
-        }
-        
-        // Create a finder
-        pNdiFinder = pNdiLib->NDIlib_find_create_v2(NULL);
-        if (!pNdiFinder) return;
-        
-        // We now have at least one source, so we create a receiver to look at it.
-        pNdiReceiver = pNdiLib->NDIlib_recv_create_v3(NULL);
-        if (!pNdiReceiver) return;
-#else
-        // Not required, but "correct" (see the SDK documentation.
-        if (!NDIlib_initialize()) return;
-
-        // Create a finder
-        pNdiFinder = NDIlib_find_create_v2();
-        if (!pNdiFinder) return;
-
-        // We now have at least one source, so we create a receiver to look at it.
-        pNdiReceiver = NDIlib_recv_create_v3();
-        if (!pNdiReceiver) return;
-#endif
+        // Nothing is loaded or created here, so plugin scans and session loads stay fast.
+        // The receiver is created on first use, the shared finder on the first find().
     }
 
     ~Impl()
     {
-#if JUCE_MAC
-        if(pNdiLib)
+        if(ndiBackend)
         {
             // Destroy the receiver
-            pNdiLib->NDIlib_recv_destroy(pNdiReceiver);
-
-            // Destroy the NDI finder. We needed to have access to the pointers to p_sources[0]
-            pNdiLib->NDIlib_find_destroy(pNdiFinder);
-
-            // Not required, but nice
-            pNdiLib->NDIlib_destroy();
+            if(pNdiReceiver) ndiBackend->recvDestroy(pNdiReceiver);
         }
-#else
-        // Destroy the receiver
-        NDIlib_recv_destroy(pNdiReceiver);
-
-        // Destroy the NDI finder. We needed to have access to the pointers to p_sources[0]
-        NDIlib_find_destroy(pNdiFinder);
 
-        // Not required, but nice
-        NDIlib_destroy();
-#endif
+        // The backend, and the runtime behind it, are destroyed along with their last user.
     }
 
     //==============================================================================
     juce::Array<NdiWrapper::NdiSource> find()
     {
-        juce::Array<NdiWrapper::NdiSource> sources{};
-
-        // Wait until there is one source
-        uint32_t num_sources = 0;
-        DBG("Looking for sources ...\n");
-        
-#if JUCE_MAC
-        if(pNdiLib) pNdiLib->NDIlib_find_wait_for_sources(pNdiFinder, 1000/* One second */);
-        if(pNdiLib) pNdiSources = pNdiLib->NDIlib_find_get_current_sources(pNdiFinder, &num_sources);
-#else
-        NDIlib_find_wait_for_sources(pNdiFinder, 1000/* One second */);
-        pNdiSources = NDIlib_find_get_current_sources(pNdiFinder, &num_sources);
-#endif
-
-        if (!num_sources)
-        {
-            return sources;
-        }
+        // The discovery service keeps the sources up to date in the background.
+        return *ndiDiscovery->getSources();
+    }
+
+    void connect(const NdiWrapper::NdiSource& source)
+    {
+        const juce::ScopedLock frame_lock(lock);
+
+        connectedNdiName = source.NdiName.toStdString();
+        connectedUrlAddress = source.UrlAddress.toStdString();
 
-        for(int src_idx = 0; src_idx < num_sources; ++src_idx)
+        inProcessSubscriber.detach();
+        localReader.close();
+        lastNumOverruns = 0;
+        numStaleVideoFrames = 0;
+
+        // A sender in this process hands its frames over directly, one on this host through shared memory.
+        // Either way the network is skipped.
+        const auto local_sender_name = NdiSharedMemoryReader::getLocalSenderName(source.NdiName);
+        if (preferLocalTransport && local_sender_name.isNotEmpty()
+            && (inProcessSubscriber.attach(local_sender_name) || localReader.open(local_sender_name)))
         {
-            NdiWrapper::NdiSource s { pNdiSources[src_idx].p_ndi_name, pNdiSources[src_idx].p_url_address, pNdiSources[src_idx].p_ip_address };
-            sources.add(s);
+            if (pNdiReceiver) ndiBackend->recvConnect(pNdiReceiver, NULL);
+            return;
         }
 
-        return sources;
+        connectThroughNdi();
     }
 
-    void connect(int sourceIndex) const
+    void addSourceListener(NdiWrapper::SourceListener* listener)
     {
-#if JUCE_MAC
-        // Connect to our sources
-        if(pNdiLib) pNdiLib->NDIlib_recv_connect(pNdiReceiver, pNdiSources + sourceIndex);
-#else
-        // Connect to our sources
-        NDIlib_recv_connect(pNdiReceiver, pNdiSources + sourceIndex);
-#endif
+        ndiDiscovery->addListener(listener);
     }
 
-    void disconnect() const
+    void removeSourceListener(NdiWrapper::SourceListener* listener)
     {
-#if JUCE_MAC
-        // Disconnect with NULL source
-        if(pNdiLib) pNdiLib->NDIlib_recv_connect(pNdiReceiver, NULL);
-#else
+        ndiDiscovery->removeListener(listener);
+    }
+
+    void disconnect()
+    {
+        const juce::ScopedLock frame_lock(lock);
+
+        connectedNdiName.clear();
+        connectedUrlAddress.clear();
+        inProcessSubscriber.detach();
+        localReader.close();
+
+        if (!pNdiReceiver) return;
+
         // Disconnect with NULL source
-        NDIlib_recv_connect(pNdiReceiver, NULL);
-#endif
+        ndiBackend->recvConnect(pNdiReceiver, NULL);
     }
 
-    NdiWrapper::NdiFrame getFrame()
+    int captureFrame(NdiWrapper::NdiFrame& result_frame)
     {
+        // Called by the repeating capture task. Never waits for a frame, the worker is shared with every other instance.
         const juce::ScopedLock frame_lock(lock);
 
-        NdiWrapper::NdiFrame result_frame;
+        result_frame.type = NdiFrameType::kNone;
+
+        // The local sender went away, it may still be reachable through NDI.
+        if (localReader.isWriterClosed() || inProcessSubscriber.isPublisherGone())
+        {
+            inProcessSubscriber.detach();
+            localReader.close();
+            connectThroughNdi();
+        }
+
+        // Audio from a sender in this process is read straight from the audio thread, its video by readInProcessVideo().
+        if (inProcessSubscriber.isAttached())
+            return idleIntervalMsec;
+
+        const bool is_local = localReader.isOpen();
+        if (!is_local && !pNdiReceiver)
+            return idleIntervalMsec;
 
         // The descriptors
         NDIlib_video_frame_v2_t video_frame;
         NDIlib_audio_frame_v2_t audio_frame;
-        NDIlib_frame_type_e frame_type = NDIlib_frame_type_e::NDIlib_frame_type_none;
-#if JUCE_MAC
-        if(pNdiLib) frame_type = pNdiLib->NDIlib_recv_capture_v2(pNdiReceiver, &video_frame, &audio_frame, nullptr, timeOutMsec);
-#else
-        frame_type = NDIlib_recv_capture_v2(pNdiReceiver, &video_frame, &audio_frame, nullptr, timeOutMsec);
-#endif
+        const auto capture_start_ticks = juce::Time::getHighResolutionTicks();
+        NDIlib_frame_type_e frame_type;
+        {
+            NDI_TRACE_ZONE("Capture");
+            frame_type = is_local
+                ? localReader.capture(&video_frame, &audio_frame, 0)
+                : ndiBackend->recvCapture(pNdiReceiver, &video_frame, &audio_frame, 0);
+        }
+
+        if (frame_type == NDIlib_frame_type_video || frame_type == NDIlib_frame_type_audio)
+        {
+            stats.captureTime.addSince(capture_start_ticks);
+            lastCaptureMsec = juce::Time::getMillisecondCounter();
+        }
+
+        if (!is_local)
+            samplePerformance();
+
+        // Recorded before anything else happens to the frame, skipped ones included.
+        if (recorder != nullptr)
+        {
+            if (frame_type == NDIlib_frame_type_video)
+                recorder->writeVideo(video_frame);
+            else if (frame_type == NDIlib_frame_type_audio)
+                recorder->writeAudio(audio_frame);
+        }
+
+        // The writer overwrote frames this reader had not read yet, or left a damaged one.
+        if (is_local)
+        {
+            const int num_overruns = localReader.getNumOverruns();
+            if (num_overruns > lastNumOverruns)
+                stats.framesOverwritten.add((juce::uint64)(num_overruns - lastNumOverruns));
+            lastNumOverruns = num_overruns;
+        }
+
         switch (frame_type)
         {   // No data
         case NDIlib_frame_type_e::NDIlib_frame_type_none:
-            //DBG("No data received.");
-            result_frame.type = NdiFrameType::kNone;
-            break;
+        case NDIlib_frame_type_e::NDIlib_frame_type_error:
+            // Polled while frames are coming in, a source that went quiet only now and then.
+            return juce::Time::getMillisecondCounter() - lastCaptureMsec < (juce::uint32)quietAfterMsec
+                ? capturePollIntervalMsec
+                : idleIntervalMsec;
 
             // Video data
         case NDIlib_frame_type_e::NDIlib_frame_type_video:
             //DBG("Video data received (" << video_frame.xres << "x" << video_frame.yres <<" ).");
+            if (!is_local && shouldSkipVideoFrame())
+            {
+                ndiBackend->recvFreeVideo(pNdiReceiver, &video_frame);
+                stats.framesSkipped.add();
+                break;
+            }
+
+            // Waits for convertPendingVideo(), kVideo tells the caller to wake it.
+            setPendingVideo(video_frame, is_local);
             result_frame.type = NdiFrameType::kVideo;
-            NdiVideoHelper::convertVideoFrame(result_frame.video, video_frame);
-#if JUCE_MAC
-            if(pNdiLib) pNdiLib->NDIlib_recv_free_video_v2(pNdiReceiver, &video_frame);
-#else
-            NDIlib_recv_free_video_v2(pNdiReceiver, &video_frame);
-#endif
+            stats.videoFramesReceived.add();
             break;
 
             // Audio data
         case NDIlib_frame_type_e::NDIlib_frame_type_audio:
             //DBG("Audio data received (" << audio_frame.no_samples <<" samples).");
             result_frame.type = NdiFrameType::kAudio;
-            NdiAudioHelper::convertAudioFrame(result_frame.audio, audio_frame);
-#if JUCE_MAC
-            if(pNdiLib) pNdiLib->NDIlib_recv_free_audio_v2(pNdiReceiver, &audio_frame);
-#else
-            NDIlib_recv_free_audio_v2(pNdiReceiver, &audio_frame);
-#endif
+            {
+                NDI_TRACE_ZONE("Convert audio");
+                const auto convert_start_ticks = juce::Time::getHighResolutionTicks();
+                NdiAudioHelper::convertAudioFrame(result_frame.audio, audio_frame);
+                stats.convertTime.addSince(convert_start_ticks);
+            }
+            if (!is_local) ndiBackend->recvFreeAudio(pNdiReceiver, &audio_frame);
             break;
 
-        case NDIlib_frame_type_e::NDIlib_frame_type_error:
         case NDIlib_frame_type_e::NDIlib_frame_type_metadata:
         case NDIlib_frame_type_e::NDIlib_frame_type_status_change:
         case NDIlib_frame_type_e::NDIlib_frame_type_max:
             break;
         }
 
-        return result_frame;
+        // More may be waiting already.
+        return 0;
+    }
+
+    bool convertPendingVideo(NdiWrapper::NdiVideoFrame& result_frame)
+    {
+        // Called by the video task, without the lock so connects and captures go on meanwhile.
+        NDIlib_video_frame_v2_t video_frame;
+        bool is_local;
+        {
+            const juce::SpinLock::ScopedLockType pending_lock(pendingLock);
+            if (!hasPendingFrame)
+                return false;
+
+            video_frame = pendingFrame;
+            is_local = isPendingLocal;
+            hasPendingFrame = false;
+            if (is_local) pendingData.swapWith(convertingData);
+        }
+
+        NDI_TRACE_ZONE("Convert video");
+        const auto convert_start_ticks = juce::Time::getHighResolutionTicks();
+        const auto preview_bounds = getPreviewBounds(video_frame.xres, video_frame.yres);
+        if (preview_bounds.isEmpty())
+        {
+            NdiVideoHelper::convertVideoFrame(result_frame, video_frame);
+        }
+        else
+        {
+            // Only the pixels shown are decoded, the editor draws the image unscaled.
+            juce::Image preview_image(juce::Image::PixelFormat::ARGB, preview_bounds.getWidth(), preview_bounds.getHeight(), false);
+            {
+                juce::Image::BitmapData preview_data(preview_image, juce::Image::BitmapData::writeOnly);
+                NdiVideoHelper::convertVideoFrameToArea(preview_data, preview_image.getBounds(), video_frame);
+            }
+            result_frame.image = preview_image;
+            result_frame.xres = video_frame.xres;
+            result_frame.yres = video_frame.yres;
+            result_frame.timecode = video_frame.timecode;
+            result_frame.timestamp = video_frame.timestamp;
+        }
+        result_frame.frame_rate_N = video_frame.frame_rate_N;
+        result_frame.frame_rate_D = video_frame.frame_rate_D;
+        stats.convertTime.addSince(convert_start_ticks);
+
+        if (!is_local) ndiBackend->recvFreeVideo(pNdiReceiver, &video_frame);
+        return true;
+    }
+
+    void discardPendingVideo()
+    {
+        // Called once the receive tasks have stopped, the frame they left would never be converted.
+        const juce::SpinLock::ScopedLockType pending_lock(pendingLock);
+        if (hasPendingFrame && !isPendingLocal)
+            ndiBackend->recvFreeVideo(pNdiReceiver, &pendingFrame);
+
+        hasPendingFrame = false;
+    }
+
+    int readInProcessVideo(NdiWrapper::NdiVideoFrame& result_frame)
+    {
+        // Called by the video task. The subscriber guards against a concurrent connect itself.
+        // The image is left invalid when no new frame arrived.
+        if (!inProcessSubscriber.isAttached())
+            return idleIntervalMsec;
+
+        if (!inProcessSubscriber.readVideo(result_frame.image))
+            return inProcessPollIntervalMsec;
+
+        result_frame.xres = result_frame.image.getWidth();
+        result_frame.yres = result_frame.image.getHeight();
+        result_frame.frame_rate_N = 0;
+        result_frame.frame_rate_D = 1;
+
+        // Arrives at full size, scaled here rather than on the message thread.
+        const auto preview_bounds = getPreviewBounds(result_frame.xres, result_frame.yres);
+        if (!preview_bounds.isEmpty() && preview_bounds.getWidth() < result_frame.xres)
+        {
+            NDI_TRACE_ZONE("Scale video");
+            result_frame.image = result_frame.image.rescaled(preview_bounds.getWidth(), preview_bounds.getHeight(), juce::Graphics::mediumResamplingQuality);
+        }
+
+        return inProcessPollIntervalMsec;
+    }
+
+    void setPreferLocalTransport(bool shouldPrefer)
+    {
+        preferLocalTransport = shouldPrefer;
+    }
+
+    bool isPreferLocalTransport() const
+    {
+        return preferLocalTransport;
+    }
+
+    bool isConnectedLocally() const
+    {
+        const juce::ScopedLock frame_lock(lock);
+        return localReader.isOpen() || inProcessSubscriber.isAttached();
+    }
+
+    bool isConnectedInProcess() const
+    {
+        return inProcessSubscriber.isAttached();
+    }
+
+    int readInProcessAudio(juce::AudioBuffer<float>& buffer)
+    {
+        // Lock free, the subscriber itself guards against a concurrent connect.
+        return inProcessSubscriber.readAudio(buffer);
+    }
+
+    NdiWrapper::ReceivePerformance getReceivePerformance() const
+    {
+        const juce::SpinLock::ScopedLockType performance_lock(performanceLock);
+        return performance;
+    }
+
+    void setVideoCatchUp(bool shouldCatchUp)
+    {
+        videoCatchUp = shouldCatchUp;
+    }
+
+    bool isVideoCatchUp() const
+    {
+        return videoCatchUp;
+    }
+
+    bool startRecording(const juce::File& file)
+    {
+        juce::String source_name;
+        {
+            const juce::ScopedLock frame_lock(lock);
+            source_name = juce::String(connectedNdiName);
+        }
+
+        // Opening the file and allocating the buffer happen without holding up the capture.
+        auto new_recorder = std::make_unique<NdiRecorder>(file, source_name, stats);
+        if (!new_recorder->isOpen())
+            return false;
+
+        {
+            const juce::ScopedLock frame_lock(lock);
+            std::swap(recorder, new_recorder);
+        }
+
+        // A recording already running is finished here, outside the lock.
+        new_recorder.reset();
+        return true;
     }
 
-    int getTimeOutMsec() const
+    void stopRecording()
     {
-        return timeOutMsec;
+        std::unique_ptr<NdiRecorder> finished_recorder;
+        {
+            const juce::ScopedLock frame_lock(lock);
+            std::swap(recorder, finished_recorder);
+        }
+
+        // Writing out the buffer and the index can take a while, the capture goes on meanwhile.
+        finished_recorder.reset();
+    }
+
+    bool isRecording() const
+    {
+        const juce::ScopedLock frame_lock(lock);
+        return recorder != nullptr;
+    }
+
+    void setPreviewSize(int width, int height)
+    {
+        // Packed into one value so the receive tasks never see half of a change.
+        previewSize = ((juce::int64)juce::jmax(0, width) << 32) | (juce::uint32)juce::jmax(0, height);
     }
 
 private:
-    const NDIlib_v4* pNdiLib;
-    NDIlib_find_instance_t pNdiFinder;
-    NDIlib_recv_instance_t pNdiReceiver;
-    const NDIlib_source_t* pNdiSources;
+    //==============================================================================
+    void samplePerformance()
+    {
+        // Called with the lock held, after each capture through NDI.
+        const auto now_msec = juce::Time::getMillisecondCounter();
+        if (now_msec - lastPerformanceSampleMsec < (juce::uint32)performanceSampleIntervalMsec) return;
+        lastPerformanceSampleMsec = now_msec;
+
+        NDIlib_recv_performance_t total_frames{ 0, 0, 0 };
+        NDIlib_recv_performance_t dropped_frames{ 0, 0, 0 };
+        NDIlib_recv_queue_t queued_frames{ 0, 0, 0 };
+        ndiBackend->recvGetPerformance(pNdiReceiver, &total_frames, &dropped_frames);
+        ndiBackend->recvGetQueue(pNdiReceiver, &queued_frames);
+
+        // The counters belong to the receiver, they keep counting across connects.
+        const juce::int64 num_dropped = dropped_frames.video_frames + dropped_frames.audio_frames;
+        if (num_dropped > lastNumDroppedInNdi)
+            stats.framesDroppedInNdi.add((juce::uint64)(num_dropped - lastNumDroppedInNdi));
+        lastNumDroppedInNdi = num_dropped;
+
+        stats.ndiQueueAudio.set(queued_frames.audio_frames);
+        stats.ndiQueueVideo.set(queued_frames.video_frames);
+
+        const juce::SpinLock::ScopedLockType performance_lock(performanceLock);
+        performance.totalVideoFrames = total_frames.video_frames;
+        performance.totalAudioFrames = total_frames.audio_frames;
+        performance.droppedVideoFrames = dropped_frames.video_frames;
+        performance.droppedAudioFrames = dropped_frames.audio_frames;
+        performance.queuedVideoFrames = queued_frames.video_frames;
+        performance.queuedAudioFrames = queued_frames.audio_frames;
+    }
+
+    juce::Rectangle<int> getPreviewBounds(int xres, int yres) const
+    {
+        const juce::int64 preview_size = previewSize;
+        const juce::Rectangle<int> preview_area((int)(preview_size >> 32), (int)(preview_size & 0xffffffff));
+        if (preview_area.isEmpty() || xres <= 0 || yres <= 0)
+            return {};
+
+        // The picture fitted into the preview, never larger than the frame itself.
+        const auto fitted = juce::RectanglePlacement(juce::RectanglePlacement::centred | juce::RectanglePlacement::onlyReduceInSize)
+            .appliedTo(juce::Rectangle<int>(xres, yres), preview_area);
+        return fitted.withZeroOrigin();
+    }
+
+    void setPendingVideo(const NDIlib_video_frame_v2_t& frame, bool isLocal)
+    {
+        // Called with the lock held. A frame still waiting is replaced, so a slow machine shows fewer frames instead of older ones.
+        NDIlib_video_frame_v2_t pending_frame = frame;
+        if (isLocal)
+        {
+            // Copied before taking the pending lock, under it the buffers are only swapped.
+            const size_t data_size = NdiRecordingFormat::getVideoDataBytes(frame);
+            if (capturedData.getSize() < data_size)
+                capturedData.setSize(data_size, false);
+            std::memcpy(capturedData.getData(), frame.p_data, data_size);
+            pending_frame.p_data = static_cast<uint8_t*>(capturedData.getData());
+            pending_frame.p_metadata = NULL;
+        }
+
+        NDIlib_video_frame_v2_t replaced_frame;
+        bool has_replaced_frame = false;
+        bool is_replaced_local = false;
+        {
+            const juce::SpinLock::ScopedLockType pending_lock(pendingLock);
+
+            has_replaced_frame = hasPendingFrame;
+            is_replaced_local = isPendingLocal;
+            replaced_frame = pendingFrame;
+
+            pendingFrame = pending_frame;
+            isPendingLocal = isLocal;
+            hasPendingFrame = true;
+            if (isLocal) pendingData.swapWith(capturedData);
+        }
+
+        if (has_replaced_frame)
+        {
+            if (!is_replaced_local) ndiBackend->recvFreeVideo(pNdiReceiver, &replaced_frame);
+            stats.framesSkipped.add();
+        }
+    }
+
+    bool shouldSkipVideoFrame()
+    {
+        // Called with the lock held, for each video frame captured through NDI.
+        // Audio is still captured in between, only the conversion of stale video is saved.
+        if (!videoCatchUp)
+        {
+            numStaleVideoFrames = 0;
+            return false;
+        }
+
+        if (numStaleVideoFrames > 0)
+        {
+            --numStaleVideoFrames;
+            return true;
+        }
+
+        NDIlib_recv_queue_t queued_frames{ 0, 0, 0 };
+        ndiBackend->recvGetQueue(pNdiReceiver, &queued_frames);
+        stats.ndiQueueVideo.set(queued_frames.video_frames);
+
+        // Newer frames are already waiting behind this one, so skip ahead to the newest of them.
+        if (queued_frames.video_frames < catchUpQueuedVideoFrames)
+            return false;
+
+        numStaleVideoFrames = queued_frames.video_frames - 1;
+        return true;
+    }
+
+    //==============================================================================
+    void connectThroughNdi()
+    {
+        // Called with the lock held.
+        if (connectedNdiName.empty() || !ensureReceiver()) return;
+
+        // The receiver copies the description, the strings only have to outlive the call.
+        NDIlib_source_t ndi_source;
+        ndi_source.p_ndi_name = connectedNdiName.c_str();
+        ndi_source.p_url_address = connectedUrlAddress.empty() ? NULL : connectedUrlAddress.c_str();
+
+        // Connect to our sources
+        ndiBackend->recvConnect(pNdiReceiver, &ndi_source);
+    }
+
+    //==============================================================================
+    bool ensureReceiver()
+    {
+        const juce::ScopedLock frame_lock(lock);
+
+        if (pNdiReceiver) return true;
+
+        // We now have at least one source, so we create a receiver to look at it.
+        pNdiReceiver = ndiBackend->recvCreate();
+        return pNdiReceiver != nullptr;
+    }
+
+    //==============================================================================
+    NdiPipelineStats& stats;
+    std::shared_ptr<NdiBackend> ndiBackend{ NdiBackend::getDefault() };
+    juce::SharedResourcePointer<NdiDiscoveryService> ndiDiscovery;
+    NDIlib_recv_instance_t pNdiReceiver{ nullptr };
+    NdiSharedMemoryReader localReader;
+    int lastNumOverruns{ 0 };
+    juce::int64 lastNumDroppedInNdi{ 0 };
+    int numStaleVideoFrames{ 0 };
+    std::atomic<bool> videoCatchUp{ true };
+    juce::uint32 lastPerformanceSampleMsec{ 0 };
+    NdiWrapper::ReceivePerformance performance;
+    juce::SpinLock performanceLock;
+    NdiInProcessSubscriber inProcessSubscriber;
+    std::atomic<bool> preferLocalTransport{ true };
+    // Width in the upper half and height in the lower, 0 for frames at full size.
+    std::atomic<juce::int64> previewSize{ 0 };
+    // Frames from a sender in this process arrive converted already, so they are not recorded.
+    std::unique_ptr<NdiRecorder> recorder;
+
+    std::string connectedNdiName;
+    std::string connectedUrlAddress;
 
     juce::CriticalSection lock;
 
-    const int timeOutMsec{ 5000 };
+    // The frame waiting for conversion. Shared memory frames are copied, the reader reuses its data on the next capture.
+    juce::SpinLock pendingLock;
+    NDIlib_video_frame_v2_t pendingFrame;
+    bool hasPendingFrame{ false };
+    bool isPendingLocal{ false };
+    juce::MemoryBlock capturedData, pendingData, convertingData;
+    juce::uint32 lastCaptureMsec{ 0 };
+
+    // Captures never wait, they are polled while frames come in and rarely otherwise.
+    const int capturePollIntervalMsec{ 5 };
+    const int inProcessPollIntervalMsec{ 5 };
+    const int idleIntervalMsec{ 100 };
+    const int quietAfterMsec{ 1000 };
+    const int performanceSampleIntervalMsec{ 250 };
+    // One frame of slack absorbs network jitter, more than that is latency building up.
+    const int catchUpQueuedVideoFrames{ 2 };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Impl)
 };
@@ -250,11 +567,13 @@ private:
 //==============================================================================
 NdiWrapper::NdiWrapper()
 {
-    pImpl = std::make_unique<NdiWrapper::Impl>();
+    pImpl = std::make_unique<NdiWrapper::Impl>(stats);
 }
 
 NdiWrapper::~NdiWrapper()
 {
+    // The receive tasks read through the Impl, they are stopped first.
+    frameUpdater.reset();
     pImpl.reset();
 }
 
@@ -263,9 +582,19 @@ juce::Array<NdiWrapper::NdiSource> NdiWrapper::find() const
     return pImpl->find();
 }
 
-void NdiWrapper::connect(int sourceIndex)
+void NdiWrapper::connect(const NdiSource& source)
 {
-    return pImpl->connect(sourceIndex);
+    return pImpl->connect(source);
+}
+
+void NdiWrapper::addSourceListener(SourceListener* listener)
+{
+    pImpl->addSourceListener(listener);
+}
+
+void NdiWrapper::removeSourceListener(SourceListener* listener)
+{
+    pImpl->removeSourceListener(listener);
 }
 
 void NdiWrapper::disconnect()
@@ -273,14 +602,90 @@ void NdiWrapper::disconnect()
     return pImpl->disconnect();
 }
 
-NdiWrapper::NdiFrame NdiWrapper::getFrame()
+int NdiWrapper::captureFrame(NdiFrame& frame)
+{
+    return pImpl->captureFrame(frame);
+}
+
+bool NdiWrapper::convertPendingVideo(NdiVideoFrame& frame)
+{
+    return pImpl->convertPendingVideo(frame);
+}
+
+void NdiWrapper::discardPendingVideo()
+{
+    pImpl->discardPendingVideo();
+}
+
+int NdiWrapper::readInProcessVideo(NdiVideoFrame& frame)
+{
+    return pImpl->readInProcessVideo(frame);
+}
+
+void NdiWrapper::setPreferLocalTransport(bool shouldPrefer)
+{
+    pImpl->setPreferLocalTransport(shouldPrefer);
+}
+
+bool NdiWrapper::isPreferLocalTransport() const
+{
+    return pImpl->isPreferLocalTransport();
+}
+
+bool NdiWrapper::isConnectedLocally() const
+{
+    return pImpl->isConnectedLocally();
+}
+
+bool NdiWrapper::isConnectedInProcess() const
+{
+    return pImpl->isConnectedInProcess();
+}
+
+int NdiWrapper::readInProcessAudio(juce::AudioBuffer<float>& buffer)
+{
+    return pImpl->readInProcessAudio(buffer);
+}
+
+NdiWrapper::ReceivePerformance NdiWrapper::getReceivePerformance() const
+{
+    return pImpl->getReceivePerformance();
+}
+
+void NdiWrapper::setPreviewSize(int width, int height)
+{
+    pImpl->setPreviewSize(width, height);
+}
+
+double NdiWrapper::getVideoFrameRate() const
+{
+    const int frame_rate_d = videoFrameRateD.load();
+    return frame_rate_d > 0 ? videoFrameRateN.load() / (double)frame_rate_d : 0.0;
+}
+
+void NdiWrapper::setVideoCatchUp(bool shouldCatchUp)
+{
+    pImpl->setVideoCatchUp(shouldCatchUp);
+}
+
+bool NdiWrapper::isVideoCatchUp() const
+{
+    return pImpl->isVideoCatchUp();
+}
+
+bool NdiWrapper::startRecording(const juce::File& file)
+{
+    return pImpl->startRecording(file);
+}
+
+void NdiWrapper::stopRecording()
 {
-    return pImpl->getFrame();
+    pImpl->stopRecording();
 }
 
-int NdiWrapper::getTimeOutMsec()
+bool NdiWrapper::isRecording() const
 {
-    return pImpl->getTimeOutMsec();
+    return pImpl->isRecording();
 }
 
 void NdiWrapper::startReceive()
@@ -11,6 +11,9 @@
 #pragma once
 #include <JuceHeader.h>
 #include "RingBuffer.h"
+#include "NdiPipelineStats.h"
+#include "NdiExecutor.h"
+#include "NdiTrace.h"
 
 class NdiWrapper
 {
@@ -18,49 +21,92 @@ class NdiWrapper
     class Impl;
 
     //==============================================================================
-    class FrameUpdater : public juce::Thread
+    // Receives as two repeating tasks on the process wide executor. The capture never waits for a frame and runs on the audio lane,
+    // the video task converts what it captured on the normal lane, so a slow conversion never holds up the audio.
+    class FrameUpdater
     {
     public:
         //==============================================================================
         FrameUpdater(NdiWrapper& owner_)
-            : juce::Thread("NDI Frame Update Thread")
-            , owner(owner_)
+            : owner(owner_)
+            , queue("NDI Receive", NdiThreadPolicy::Role::capture, owner_.stats)
         {
-            startThread(10);
+            queue.submitRepeating([this]() { return capture(); }, NdiExecutor::Lane::audio);
+            queue.submitRepeating([this]() { return processVideo(); });
         }
 
         ~FrameUpdater()
         {
-            // Waiting time duration have to be longer than NDI receiver's time out msec.
-            stopThread(owner.getTimeOutMsec() + 1000);
+            // Returns once a capture or conversion in progress is done, nothing runs after this.
+            queue.cancelAndWait();
+            owner.discardPendingVideo();
         }
 
+    private:
         //==============================================================================
-        virtual void run() override
+        // Both return the msec until they want to run again.
+        int capture()
         {
-            while(!threadShouldExit())
+            NdiFrame frame;
+            const int next_msec = owner.captureFrame(frame);
+
+            if (frame.type == NdiFrameType::kVideo)
             {
-                auto frame = owner.getFrame();
-                if(frame.type == NdiFrameType::kVideo)
-                {
-                    owner.videoCache.push(frame.video.image);
-                }
-                else if (frame.type == NdiFrameType::kAudio)
-                {
-                    owner.audioCache.push(frame.audio.samples);
-                    owner.audioCache.sampleRate = frame.audio.sample_rate;
-                    owner.audioCache.numChannels = frame.audio.no_channels;
-                }
+                // Left for the video task, which idles otherwise.
+                queue.wake(NdiExecutor::Lane::normal);
+            }
+            else if (frame.type == NdiFrameType::kAudio)
+            {
+                NDI_TRACE_ZONE("Queue audio");
+                owner.stats.audioFramesReceived.add();
+                const int num_channels = juce::jlimit(1, AudioRingBuffer<float>::maxChannels, frame.audio.no_channels);
+                if (num_channels != owner.audioCache.numChannels)
+                    owner.audioCache.setNumChannels(num_channels);
+                // Before the push, so processBlock never reads these samples at the old rate.
+                owner.audioCache.sampleRate = frame.audio.sample_rate;
+                if (owner.audioCache.push(frame.audio.samples) < frame.audio.samples.getNumSamples())
+                    owner.stats.framesDropped.add();
+                owner.stats.audioRingFill.set(owner.audioCache.getNumReady());
             }
 
-            DBG("Thread exited!!");
+            return next_msec;
+        }
+
+        int processVideo()
+        {
+            // The only writer of videoCache.
+            NdiVideoFrame frame;
+            if (owner.convertPendingVideo(frame))
+            {
+                queueVideo(frame.image, frame.frame_rate_N, frame.frame_rate_D);
+                return 0;
+            }
+
+            const int next_msec = owner.readInProcessVideo(frame);
+            if (frame.image.isValid())
+            {
+                owner.stats.videoFramesReceived.add();
+                queueVideo(frame.image, frame.frame_rate_N, frame.frame_rate_D);
+            }
+
+            return next_msec;
+        }
+
+        void queueVideo(const juce::Image& image, int frameRateN, int frameRateD)
+        {
+            NDI_TRACE_ZONE("Queue video");
+            if (owner.videoCache.push(image) == 0)
+                owner.stats.framesDropped.add();
+            owner.stats.videoRingFill.set(owner.videoCache.getNumReady());
+            owner.videoFrameRateN = frameRateN;
+            owner.videoFrameRateD = frameRateD;
         }
 
-    private:
         //==============================================================================
         NdiWrapper& owner;
-        int interval{ 30 };
 
+        // Last, so it is gone before anything its tasks use.
+        NdiExecutor::Queue queue;
 
         //==============================================================================
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FrameUpdater)
@@ -77,6 +123,15 @@ public:
         JUCE_LEAK_DETECTOR(NdiSource)
     };
 
+    class SourceListener
+    {
+    public:
+        virtual ~SourceListener() = default;
+
+        // Called on the discovery thread.
+        virtual void ndiSourcesChanged() = 0;
+    };
+
     enum NdiFrameType
     {
         kNone,
@@ -116,6 +171,17 @@ public:
         JUCE_LEAK_DETECTOR(NdiAudioFrame)
     };
 
+    // Counters of the NDI receiver itself, as of the last sample.
+    struct ReceivePerformance
+    {
+        juce::int64 totalVideoFrames{ 0 };
+        juce::int64 totalAudioFrames{ 0 };
+        juce::int64 droppedVideoFrames{ 0 };
+        juce::int64 droppedAudioFrames{ 0 };
+        int queuedVideoFrames{ 0 };
+        int queuedAudioFrames{ 0 };
+    };
+
     struct NdiFrame
     {
         NdiFrameType type;
@@ -131,23 +197,74 @@ public:
 
     //==============================================================================
     juce::Array<NdiSource> find() const;
-    void connect(int sourceIndex);
+    void connect(const NdiSource& source);
+    void addSourceListener(SourceListener* listener);
+    void removeSourceListener(SourceListener* listener);
     void disconnect();
     void startReceive();
     void stopReceive();
     bool isReceiving() const;
-    NdiFrame getFrame();
-    int getTimeOutMsec();
 
     //==============================================================================
-    AudioRingBuffer<float> audioCache;
+    // Senders on the same host are read through shared memory instead of NDI when possible.
+    // Takes effect on the next connect().
+    void setPreferLocalTransport(bool shouldPrefer);
+    bool isPreferLocalTransport() const;
+    bool isConnectedLocally() const;
+
+    // A sender in this process delivers audio directly: read it from the audio thread with no added latency.
+    // Returns the number of samples written, the rest of the buffer is left untouched.
+    bool isConnectedInProcess() const;
+    int readInProcessAudio(juce::AudioBuffer<float>& buffer);
+
+    //==============================================================================
+    // Sampled a few times a second by the capture task while connected through NDI.
+    ReceivePerformance getReceivePerformance() const;
+
+    // When video backs up inside NDI, the stale frames are released without converting them
+    // and only the newest is passed on. Keeps the preview latency bounded when the CPU is busy. On by default.
+    void setVideoCatchUp(bool shouldCatchUp);
+    bool isVideoCatchUp() const;
+
+    //==============================================================================
+    // While set, video frames are decoded straight to the size they are shown at, fitted and centred,
+    // and the images in videoCache are that size. 0 by 0 converts them at full size.
+    void setPreviewSize(int width, int height);
+
+    // Of the last video frame queued, 0 if it is not known.
+    double getVideoFrameRate() const;
+
+    //==============================================================================
+    // Writes every frame captured through NDI or shared memory to a file as it arrived, before any conversion.
+    // The capture never waits for the disk, see NdiRecorder. Returns false if the file could not be created.
+    bool startRecording(const juce::File& file);
+    void stopRecording();
+    bool isRecording() const;
+
+    //==============================================================================
+    // About ten seconds at 48kHz, for each channel of the source.
+    AudioRingBuffer<float> audioCache{ 1 << 19 };
     VideoRingBuffer videoCache;
 
+    // Updated lock free by the receive tasks and the audio thread, read it from anywhere.
+    NdiPipelineStats stats;
+
 private:
+    //==============================================================================
+    // Used by the FrameUpdater's tasks, captureFrame() and readInProcessVideo() return the msec until they want to be called again.
+    // A captured video frame waits in the Impl until convertPendingVideo() takes it, kVideo says one is waiting.
+    int captureFrame(NdiFrame& frame);
+    bool convertPendingVideo(NdiVideoFrame& frame);
+    void discardPendingVideo();
+    int readInProcessVideo(NdiVideoFrame& frame);
+
     //==============================================================================
     std::unique_ptr<Impl> pImpl;
     std::unique_ptr<FrameUpdater> frameUpdater;
 
+    std::atomic<int> videoFrameRateN{ 0 };
+    std::atomic<int> videoFrameRateD{ 1 };
+
     NdiFrame currentVideoFrame;
     NdiFrame currentAudioFrame;
 
@@ -11,35 +11,13 @@
 
 //==============================================================================
 NdiReceiverAudioProcessorEditor::NdiReceiverAudioProcessorEditor (NdiReceiverAudioProcessor& p)
-    : AudioProcessorEditor (&p), audioProcessor (p)
+    : AudioProcessorEditor (&p), audioProcessor (p), statsOverlay (p.getNdiEngine().stats)
 {
     ndiFindButton.setButtonText("Find NDI source");
     ndiFindButton.onClick = [&]()
     {
-        ndiSourceList.setEnabled(false);
-
-        const std::function<juce::ThreadPoolJob::JobStatus()> findJob = [&]()
-        {
-            ndiSources = audioProcessor.getNdiEngine().find();
-
-            const std::function<void()> updateList = [&]()
-            {
-                ndiSourceList.clear(juce::dontSendNotification);
-
-                juce::StringArray items;
-                for (int idx = 0; idx < ndiSources.size(); ++idx)
-                {
-                    auto& source = ndiSources.getReference(idx);
-                    items.add(source.NdiName);
-                }
-                ndiSourceList.addItemList(items, 1);
-                ndiSourceList.setEnabled(true);
-            };
-            juce::MessageManager::getInstance()->callAsync(updateList);
-
-            return juce::ThreadPoolJob::JobStatus::jobHasFinished;
-        };
-        threadPool.addJob(findJob);
+        // Sources are discovered in the background, this only refreshes the list.
+        updateSourceList();
     };
     addAndMakeVisible(ndiFindButton);
 
@@ -52,10 +30,10 @@ NdiReceiverAudioProcessorEditor::NdiReceiverAudioProcessorEditor (NdiReceiverAud
     ndiConnectButton.setButtonText("Connect");
     ndiConnectButton.onClick = [&]()
     {
-        if (ndiSourceList.getSelectedId() > 0)
+        if (ndiSourceList.getSelectedId() > 0 && juce::isPositiveAndBelow(ndiSourceList.getSelectedItemIndex(), ndiSources.size()))
         {
-            auto src_idx = ndiSourceList.getSelectedItemIndex();
-            const std::function<juce::ThreadPoolJob::JobStatus()> coonectJob = [&, src_idx]()
+            const auto source = ndiSources[ndiSourceList.getSelectedItemIndex()];
+            const std::function<void()> coonectJob = [&, source]()
             {
                 if (audioProcessor.getNdiEngine().isReceiving())
                 {
@@ -63,12 +41,10 @@ NdiReceiverAudioProcessorEditor::NdiReceiverAudioProcessorEditor (NdiReceiverAud
                     audioProcessor.getNdiEngine().disconnect();
                 }
 
-                audioProcessor.getNdiEngine().connect(src_idx);
+                audioProcessor.getNdiEngine().connect(source);
                 audioProcessor.getNdiEngine().startReceive();
-
-                return juce::ThreadPoolJob::JobStatus::jobHasFinished;
             };
-            threadPool.addJob(coonectJob);
+            taskQueue.submit(coonectJob);
         }
     };
     addAndMakeVisible(ndiConnectButton);
@@ -77,20 +53,107 @@ NdiReceiverAudioProcessorEditor::NdiReceiverAudioProcessorEditor (NdiReceiverAud
     ndiDisconnectButton.setButtonText("Disconnect");
     ndiDisconnectButton.onClick = [&]()
     {
-        const std::function<juce::ThreadPoolJob::JobStatus()> discoonectJob = [&]()
+        const std::function<void()> discoonectJob = [&]()
         {
             audioProcessor.getNdiEngine().stopReceive();
             audioProcessor.getNdiEngine().disconnect();
-
-            return juce::ThreadPoolJob::JobStatus::jobHasFinished;
         };
-        threadPool.addJob(discoonectJob);
+        taskQueue.submit(discoonectJob);
     };
     addAndMakeVisible(ndiDisconnectButton);
 
-    setSize(820, 600);
+    // Sources added here are received alongside the connected one and their audio is mixed in.
+    addSourceButton.setButtonText("Add to mix");
+    addSourceButton.onClick = [&]()
+    {
+        if (ndiSourceList.getSelectedId() > 0 && juce::isPositiveAndBelow(ndiSourceList.getSelectedItemIndex(), ndiSources.size()))
+        {
+            const auto source = ndiSources[ndiSourceList.getSelectedItemIndex()];
+            const std::function<void()> addJob = [&, source]()
+            {
+                const int source_id = audioProcessor.getMultiReceiver().addSource(source);
+                if (source_id > 0)
+                    audioProcessor.getMultiReceiver().setAudioEnabled(source_id, true);
+            };
+            taskQueue.submit(addJob);
+        }
+    };
+    addAndMakeVisible(addSourceButton);
+
+    removeSourcesButton.setButtonText("Remove all");
+    removeSourcesButton.onClick = [&]()
+    {
+        const std::function<void()> removeJob = [&]()
+        {
+            audioProcessor.getMultiReceiver().removeAllSources();
+        };
+        taskQueue.submit(removeJob);
+    };
+    addAndMakeVisible(removeSourcesButton);
 
-    startTimerHz(120);
+    addAndMakeVisible(mixedSourcesLabel);
+
+    // The pipeline counters are drawn over the video on demand.
+    addChildComponent(statsOverlay);
+    statsButton.setButtonText("Stats");
+    statsButton.onClick = [&]()
+    {
+        statsOverlay.setVisible(statsButton.getToggleState());
+    };
+    addAndMakeVisible(statsButton);
+
+    // Shows every source added to the mix as a wall of tiles instead of the connected source.
+    multiviewButton.setButtonText("Multiview");
+    multiviewButton.onClick = [&]()
+    {
+        audioProcessor.getMultiReceiver().getMosaic().setEnabled(multiviewButton.getToggleState());
+        updateTimerRate();
+        repaint(videoArea);
+    };
+    addAndMakeVisible(multiviewButton);
+
+    // Archives the connected source as captured, into the documents folder.
+    recordButton.setButtonText("Record");
+    recordButton.onClick = [&]()
+    {
+        const bool should_record = recordButton.getToggleState();
+        const std::function<void()> recordJob = [&, should_record]()
+        {
+            if (should_record)
+            {
+                const auto file = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+                    .getNonexistentChildFile("NdiRecording_" + juce::Time::getCurrentTime().formatted("%Y%m%d_%H%M%S"), ".ndirec", false);
+                audioProcessor.getNdiEngine().startRecording(file);
+            }
+            else
+            {
+                audioProcessor.getNdiEngine().stopRecording();
+            }
+        };
+        taskQueue.submit(recordJob);
+    };
+    addAndMakeVisible(recordButton);
+
+    // Only offered in builds with NDI_TRACE_ENABLED.
+    traceButton.setButtonText("Save trace");
+    traceButton.onClick = [&]()
+    {
+        NdiTrace::saveChromeTraceAndReveal();
+    };
+    addChildComponent(traceButton);
+    traceButton.setVisible(NdiTrace::isEnabled());
+
+    setSize(820, 640);
+
+    audioProcessor.getMultiReceiver().getMosaic().setSize(videoArea.getWidth(), videoArea.getHeight());
+    audioProcessor.getNdiEngine().setPreviewSize(videoArea.getWidth(), videoArea.getHeight());
+    multiviewButton.setToggleState(audioProcessor.getMultiReceiver().getMosaic().isEnabled(), juce::dontSendNotification);
+    recordButton.setToggleState(audioProcessor.getNdiEngine().isRecording(), juce::dontSendNotification);
+
+    audioProcessor.getNdiEngine().addSourceListener(this);
+    updateSourceList();
+
+    updateTimerRate();
 
 #ifdef JUCE_OPENGL
     openGLContext.attachTo(*getTopLevelComponent());
@@ -99,6 +162,11 @@ NdiReceiverAudioProcessorEditor::NdiReceiverAudioProcessorEditor (NdiReceiverAud
 
 NdiReceiverAudioProcessorEditor::~NdiReceiverAudioProcessorEditor()
 {
+    audioProcessor.getNdiEngine().removeSourceListener(this);
+
+    // Nobody looks at the wall any more, go back to converting the sources as they are.
+    audioProcessor.getMultiReceiver().getMosaic().setEnabled(false);
+
 #ifdef JUCE_OPENGL
     openGLContext.detach();
 #endif // JUCE_OPENGL
@@ -107,29 +175,50 @@ NdiReceiverAudioProcessorEditor::~NdiReceiverAudioProcessorEditor()
 //==============================================================================
 void NdiReceiverAudioProcessorEditor::paint (juce::Graphics& g)
 {
+    NDI_TRACE_ZONE("Paint");
     g.fillAll(getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId));
 
-    juce::Rectangle<int> video_area{ 20, 100, 780, 480 };
     g.setColour(juce::Colours::black);
-    g.fillRect(video_area);
+    g.fillRect(videoArea);
 
-    if (audioProcessor.getNdiEngine().videoCache.pop(currentImage) > 0)
+    if (multiviewButton.getToggleState())
     {
-        timeupCounter = 0;
+        drawMultiview(g, videoArea);
+        return;
     }
-    else
+
+    // Already the size it is shown at, unless the frame is smaller than the area.
+    if (currentImage.isValid())
     {
-        timeupCounter++;
+        const auto image_bounds = juce::RectanglePlacement(juce::RectanglePlacement::centred | juce::RectanglePlacement::onlyReduceInSize)
+            .appliedTo(currentImage.getBounds(), videoArea);
+
+        if (image_bounds.getWidth() == currentImage.getWidth() && image_bounds.getHeight() == currentImage.getHeight())
+            g.drawImageAt(currentImage, image_bounds.getX(), image_bounds.getY());
+        else
+            g.drawImage(currentImage, image_bounds.toFloat(), juce::RectanglePlacement::centred);
     }
+}
 
-    if (timeupCounter > 60)
+void NdiReceiverAudioProcessorEditor::drawMultiview(juce::Graphics& g, const juce::Rectangle<int>& area)
+{
+    // The wall is the size of the video area, so it is drawn unscaled.
+    const auto& mosaic = audioProcessor.getMultiReceiver().getMosaic();
+    g.drawImageAt(mosaic.getImage(), area.getX(), area.getY());
+
+    g.setFont(14.0f);
+    for (const auto& tile : mosaic.getTiles())
     {
-        currentImage = juce::Image();
-    }
+        auto tile_bounds = tile.bounds + area.getPosition();
+        if (!g.clipRegionIntersects(tile_bounds))
+            continue;
 
-    g.drawImage(currentImage,
-        video_area.toFloat(),
-        juce::RectanglePlacement::Flags::centred);
+        const auto label_bounds = tile_bounds.removeFromBottom(20);
+        g.setColour(juce::Colours::black.withAlpha(0.6f));
+        g.fillRect(label_bounds);
+        g.setColour(juce::Colours::white);
+        g.drawText(audioProcessor.getMultiReceiver().getSourceName(tile.id), label_bounds.reduced(4, 0), juce::Justification::centredLeft, true);
+    }
 }
 
 void NdiReceiverAudioProcessorEditor::resized()
@@ -140,9 +229,108 @@ void NdiReceiverAudioProcessorEditor::resized()
     ndiSourceList.setBounds(220, 20, 180, 60);
     ndiConnectButton.setBounds(420, 20, 180, 60);
     ndiDisconnectButton.setBounds(620, 20, 180, 60);
+
+    statsOverlay.setBounds(videoArea);
+    addSourceButton.setBounds(20, 592, 180, 32);
+    removeSourcesButton.setBounds(220, 592, 180, 32);
+    mixedSourcesLabel.setBounds(420, 592, 380, 32);
+    statsButton.setBounds(720, 104, 76, 24);
+    traceButton.setBounds(636, 104, 80, 24);
+    multiviewButton.setBounds(20, 104, 96, 24);
+    recordButton.setBounds(120, 104, 80, 24);
 }
 
 void NdiReceiverAudioProcessorEditor::timerCallback()
 {
-    repaint();
+    const int num_mixed_sources = audioProcessor.getMultiReceiver().getSourceIds().size();
+    mixedSourcesLabel.setText(num_mixed_sources > 0 ? juce::String(num_mixed_sources) + " more source(s) in the mix" : juce::String(),
+                              juce::dontSendNotification);
+
+    if (!multiviewButton.getToggleState())
+    {
+        updateVideo();
+        return;
+    }
+
+    // Only the tiles whose source delivered a frame are copied and repainted.
+    for (const auto& changed_area : audioProcessor.getMultiReceiver().getMosaic().updateImage())
+        repaint(changed_area + videoArea.getPosition());
+
+    // The connected source is not shown meanwhile, but its frames must not pile up.
+    while (audioProcessor.getNdiEngine().videoCache.pop(currentImage) > 0)
+    {
+    }
+}
+
+void NdiReceiverAudioProcessorEditor::updateVideo()
+{
+    auto& ndi_engine = audioProcessor.getNdiEngine();
+
+    // Only the newest frame is shown, the ones the timer missed are dropped.
+    bool has_new_frame = false;
+    while (ndi_engine.videoCache.pop(currentImage) > 0)
+        has_new_frame = true;
+
+    const auto now_msec = juce::Time::getMillisecondCounter();
+    if (has_new_frame)
+    {
+        lastFrameMsec = now_msec;
+        ndi_engine.stats.videoRingFill.set(ndi_engine.videoCache.getNumReady());
+        repaint(videoArea);
+        updateTimerRate();
+    }
+    else if (currentImage.isValid() && now_msec - lastFrameMsec > (juce::uint32)videoTimeOutMsec)
+    {
+        // The source stopped sending, blank the picture once.
+        currentImage = juce::Image();
+        repaint(videoArea);
+    }
+}
+
+void NdiReceiverAudioProcessorEditor::updateTimerRate()
+{
+    // Checks twice per frame of the source, so the timer's jitter does not make it miss frames.
+    // A check without a new frame costs next to nothing. The wall's tiles may each run at their own rate.
+    const double frame_rate = audioProcessor.getNdiEngine().getVideoFrameRate();
+    const int rate_hz = multiviewButton.getToggleState() || frame_rate <= 0.0
+        ? defaultTimerRateHz
+        : juce::jlimit(minTimerRateHz, maxTimerRateHz, (int)std::ceil(frame_rate * 2.0));
+
+    if (rate_hz != timerRateHz)
+    {
+        timerRateHz = rate_hz;
+        startTimerHz(timerRateHz);
+    }
+}
+
+void NdiReceiverAudioProcessorEditor::ndiSourcesChanged()
+{
+    juce::Component::SafePointer<NdiReceiverAudioProcessorEditor> safeThis(this);
+    juce::MessageManager::callAsync([safeThis]()
+        {
+            if (safeThis != nullptr)
+                safeThis->updateSourceList();
+        });
+}
+
+void NdiReceiverAudioProcessorEditor::updateSourceList()
+{
+    // Keep the current selection when the source is still there.
+    const auto selected_name = ndiSourceList.getText();
+
+    ndiSources = audioProcessor.getNdiEngine().find();
+
+    ndiSourceList.clear(juce::dontSendNotification);
+
+    juce::StringArray items;
+    for (int idx = 0; idx < ndiSources.size(); ++idx)
+    {
+        auto& source = ndiSources.getReference(idx);
+        items.add(source.NdiName);
+    }
+    ndiSourceList.addItemList(items, 1);
+
+    const int selected_index = items.indexOf(selected_name);
+    if (selected_index >= 0)
+        ndiSourceList.setSelectedItemIndex(selected_index, juce::dontSendNotification);
 }
@@ -10,12 +10,15 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "NdiStatsOverlay.h"
+#include "NdiExecutor.h"
 
 //==============================================================================
 /**
 */
 class NdiReceiverAudioProcessorEditor  : public juce::AudioProcessorEditor
                                         , public juce::Timer
+                                        , private NdiWrapper::SourceListener
 {
 public:
     NdiReceiverAudioProcessorEditor (NdiReceiverAudioProcessor&);
@@ -28,6 +31,13 @@ public:
 private:
     //==============================================================================
     virtual void timerCallback() override;
+    virtual void ndiSourcesChanged() override;
+
+    //==============================================================================
+    void updateSourceList();
+    void updateVideo();
+    void updateTimerRate();
+    void drawMultiview(juce::Graphics& g, const juce::Rectangle<int>& area);
 
     //==============================================================================
     NdiReceiverAudioProcessor& audioProcessor;
@@ -38,11 +48,28 @@ private:
     juce::ComboBox ndiSourceList;
     juce::TextButton ndiConnectButton;
     juce::TextButton ndiDisconnectButton;
+    juce::ToggleButton statsButton;
+    juce::ToggleButton multiviewButton;
+    juce::ToggleButton recordButton;
+    juce::TextButton traceButton;
+    juce::TextButton addSourceButton;
+    juce::TextButton removeSourcesButton;
+    juce::Label mixedSourcesLabel;
+    NdiStatsOverlay statsOverlay;
 
-    juce::ThreadPool threadPool;
+    // Connecting and the like block for a while, they run on the shared NDI workers one after the other.
+    NdiExecutor::Queue taskQueue{ "NDI Receiver Editor" };
 
+    // Decoded at the size of the video area by the receive tasks, drawn unscaled.
     juce::Image currentImage;
-    int timeupCounter{ 0 };
+    juce::uint32 lastFrameMsec{ 0 };
+    int timerRateHz{ 0 };
+
+    const juce::Rectangle<int> videoArea{ 20, 100, 780, 480 };
+    const int videoTimeOutMsec{ 500 };
+    static constexpr int defaultTimerRateHz = 60;
+    static constexpr int minTimerRateHz = 10;
+    static constexpr int maxTimerRateHz = 120;
 
 #ifdef JUCE_OPENGL
     juce::OpenGLContext openGLContext;
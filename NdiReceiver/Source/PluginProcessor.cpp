@@ -22,10 +22,16 @@ NdiReceiverAudioProcessor::NdiReceiverAudioProcessor()
                        )
 #endif
 {
+    addParameter(targetLatencyMsec = new juce::AudioParameterFloat("targetLatency", "Target latency",
+                                                                   juce::NormalisableRange<float>(5.0f, 1000.0f, 1.0f), 50.0f, "ms"));
+    addParameter(maxConcealMsec = new juce::AudioParameterFloat("maxConceal", "Max concealment",
+                                                                juce::NormalisableRange<float>(0.0f, 200.0f, 1.0f), 40.0f, "ms"));
 }
 
 NdiReceiverAudioProcessor::~NdiReceiverAudioProcessor()
 {
+    cancelPendingUpdate();
+
     if (getNdiEngine().isReceiving())
     {
         getNdiEngine().stopReceive();
@@ -101,6 +107,8 @@ void NdiReceiverAudioProcessor::prepareToPlay (double sampleRate, int samplesPer
     deviceSampleRate = sampleRate;
     deviceMaxBufferSize = samplesPerBlock;
 
+    multiReceiver.prepareToPlay(sampleRate, samplesPerBlock, getTotalNumOutputChannels());
+
     interPolators_NdiToDevice.clear();
     for (int i = 0; i < getTotalNumOutputChannels(); ++i)
     {
@@ -108,6 +116,20 @@ void NdiReceiverAudioProcessor::prepareToPlay (double sampleRate, int samplesPer
         ip->reset();
         interPolators_NdiToDevice.add(ip);
     }
+
+    // The most a block can take from the ring, ahead of time so that processBlock does not allocate.
+    const int max_retrieve_samples = samplesPerBlock * maxResampleRatio + 1;
+    retrieveBuffer.setSize(AudioRingBuffer<float>::maxChannels, max_retrieve_samples);
+    routedBuffer.setSize(getTotalNumOutputChannels(), max_retrieve_samples);
+    channelRouter.setDefaultRouting(AudioRingBuffer<float>::defaultNumChannels, getTotalNumOutputChannels());
+
+    underrunConcealer.prepare(getTotalNumOutputChannels());
+
+    // Set straight away, the host reads it once this returns.
+    isLastRenderedSamplesShorten = true;
+    driftCorrector.reset(0);
+    reportedLatencySamples = calculateLatencySamples(getNdiEngine().audioCache.sampleRate);
+    setLatencySamples(reportedLatencySamples);
 }
 
 void NdiReceiverAudioProcessor::releaseResources()
@@ -121,10 +143,9 @@ bool NdiReceiverAudioProcessor::isBusesLayoutSupported (const BusesLayout& layou
     juce::ignoreUnused (layouts);
     return true;
   #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Any layout up to the channels the ring carries, the source's channels are routed onto it.
+    const int num_channels = layouts.getMainOutputChannelSet().size();
+    if (num_channels < 1 || num_channels > AudioRingBuffer<float>::maxChannels)
         return false;
 
     // This checks if the input layout matches the output layout
@@ -140,75 +161,124 @@ bool NdiReceiverAudioProcessor::isBusesLayoutSupported (const BusesLayout& layou
 
 void NdiReceiverAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    NDI_TRACE_ZONE("processBlock");
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
-    const bool will_fade_in_this_frame = isLastRenderedSamplesShorten && getNdiEngine().audioCache.isReady();
-
-    if (getNdiEngine().audioCache.isReady())
+    // A sender in this process hands over its blocks directly, no ring buffer and no resampling in between.
+    if (getNdiEngine().isConnectedInProcess())
     {
-        resamplingBuffer_NdiToDevice.reset(new juce::AudioBuffer<float>(buffer.getNumChannels(), buffer.getNumSamples()));
+        updateLatency(0);
 
-        const auto retrieve_ratio = (double)(getNdiEngine().audioCache.sampleRate) / getSampleRate();
-        juce::AudioBuffer<float> retrieve_buffer(getNdiEngine().audioCache.numChannels, buffer.getNumSamples() * retrieve_ratio);
-        retrieve_buffer.clear(0, retrieve_buffer.getNumSamples());
-        const int actual_retrieved_num_samples = getNdiEngine().audioCache.pop(retrieve_buffer);
+        const int num_read = getNdiEngine().readInProcessAudio(buffer);
+        if (num_read < buffer.getNumSamples())
+            buffer.clear(num_read, buffer.getNumSamples() - num_read);
 
-        // Apply fade out...
-        // If actual retrieved sample size is less than retrieving buffer size, to reduce the noise with applying gain.
-        if (actual_retrieved_num_samples < retrieve_buffer.getNumSamples())
-        {
-            retrieve_buffer.applyGainRamp(0, actual_retrieved_num_samples, 1.0f, 0.0f);
-            isLastRenderedSamplesShorten = true;
-        }
-        else
-        {
-            isLastRenderedSamplesShorten = false;
-        }
+        isLastRenderedSamplesShorten = true;
+        underrunConcealer.reset();
+        multiReceiver.mixAudio(buffer, targetLatencyMsec->get());
+        return;
+    }
+
+    auto& audio_cache = getNdiEngine().audioCache;
+    const int source_sample_rate = audio_cache.sampleRate;
+    updateLatency(source_sample_rate);
+
+    // After starting or fading out, play only once the ring holds the target, so that the latency is the reported one.
+    // While playing, a block is read even from an empty ring, the concealer fills in the gap.
+    // Nothing is resampled before the first frame has told the source's rate.
+    const double target_fill = targetLatencyMsec->get() * 0.001 * source_sample_rate;
+    const bool is_buffered = source_sample_rate > 0
+        && (!isLastRenderedSamplesShorten || (audio_cache.isReady() && audio_cache.getNumReady() >= target_fill));
+    const bool will_fade_in_this_frame = isLastRenderedSamplesShorten && is_buffered;
+
+    if (is_buffered)
+    {
+        // A burst from the sender or a stalled host leaves far more than the target, that is dropped at once.
+        if (const int num_excess = NdiDriftCorrector::getNumExcessSamples(audio_cache.getNumReady(), target_fill, source_sample_rate))
+            audio_cache.discard(num_excess);
 
-        // Apply fade in...
         if (will_fade_in_this_frame)
-        {
-            const int fade_sample_length = juce::jmin(256, juce::jmin(actual_retrieved_num_samples, retrieve_buffer.getNumSamples()));
-            retrieve_buffer.applyGainRamp(0, fade_sample_length, 0.0f, 1.0f);
-        }
+            driftCorrector.reset(audio_cache.getNumReady());
+
+        // The two clocks never quite agree, so the rate is bent slightly to keep the ring at the target.
+        const int num_retrieve_samples = driftCorrector.getNumToRetrieve(buffer.getNumSamples(), getSampleRate(), source_sample_rate,
+                                                                         audio_cache.getNumReady(), target_fill);
+
+        // Sized in prepareToPlay, these only reallocate if the host sends a longer block than it said.
+        const int num_source_channels = juce::jlimit(1, AudioRingBuffer<float>::maxChannels, audio_cache.numChannels);
+        const int num_output_channels = juce::jmin(buffer.getNumChannels(), interPolators_NdiToDevice.size());
+        retrieveBuffer.setSize(num_source_channels, num_retrieve_samples, false, false, true);
+        routedBuffer.setSize(num_output_channels, num_retrieve_samples, false, false, true);
+
+        retrieveBuffer.clear();
+        const int actual_retrieved_num_samples = audio_cache.pop(retrieveBuffer);
+        getNdiEngine().stats.audioRingFill.set(audio_cache.getNumReady());
+        getNdiEngine().stats.resampleRatio.store((float)driftCorrector.getRatio(), std::memory_order_relaxed);
+
+        // The source's channels are mapped onto the bus before resampling, so only the bus channels are resampled.
+        if (!channelRouter.matches(num_source_channels, num_output_channels))
+            channelRouter.setDefaultRouting(num_source_channels, num_output_channels);
+        channelRouter.process(retrieveBuffer, routedBuffer, num_retrieve_samples);
+
+        // Short gaps are filled in from the audio before them, longer ones fade out, and the audio fades in after.
+        underrunConcealer.setMaxConcealMsec(maxConcealMsec->get());
+        isLastRenderedSamplesShorten = !underrunConcealer.process(routedBuffer, actual_retrieved_num_samples,
+                                                                  source_sample_rate, getNdiEngine().stats);
 
         // Processing with re-sample...
-        const float actual_ratio_revert = (float)retrieve_buffer.getNumSamples() / (float)resamplingBuffer_NdiToDevice->getNumSamples();
+        NDI_TRACE_ZONE("Resample");
+        const double actual_ratio_revert = (double)num_retrieve_samples / (double)buffer.getNumSamples();
 
-        for (int ch_idx = 0; ch_idx < interPolators_NdiToDevice.size(); ++ch_idx)
+        for (int ch_idx = 0; ch_idx < num_output_channels; ++ch_idx)
         {
-            if(ch_idx < retrieve_buffer.getNumChannels())
-            {
-                interPolators_NdiToDevice.getUnchecked(ch_idx)->process(
-                    actual_ratio_revert, retrieve_buffer.getReadPointer(ch_idx),
-                    resamplingBuffer_NdiToDevice->getWritePointer(ch_idx), resamplingBuffer_NdiToDevice->getNumSamples()
-                );
-            }
-            else
-            {
-                juce::AudioBuffer<float> dummy_buffer(1, retrieve_buffer.getNumSamples());
-                dummy_buffer.clear();
-                interPolators_NdiToDevice.getUnchecked(ch_idx)->process(
-                    actual_ratio_revert, dummy_buffer.getReadPointer(0),
-                    resamplingBuffer_NdiToDevice->getWritePointer(ch_idx), resamplingBuffer_NdiToDevice->getNumSamples()
-                );
-            }
+            interPolators_NdiToDevice.getUnchecked(ch_idx)->process(
+                actual_ratio_revert, routedBuffer.getReadPointer(ch_idx),
+                buffer.getWritePointer(ch_idx), buffer.getNumSamples()
+            );
         }
 
-        // Copy buffer...
-        for(int ch_idx = 0; ch_idx < juce::jmin(buffer.getNumChannels(), resamplingBuffer_NdiToDevice->getNumChannels()); ++ch_idx)
-        {
-            jassert(buffer.getNumSamples() == resamplingBuffer_NdiToDevice->getNumSamples());
-            juce::FloatVectorOperations::copy(buffer.getWritePointer(ch_idx), resamplingBuffer_NdiToDevice->getReadPointer(ch_idx), buffer.getNumSamples());
-        }
+        for (int ch_idx = num_output_channels; ch_idx < buffer.getNumChannels(); ++ch_idx)
+            buffer.clear(ch_idx, 0, buffer.getNumSamples());
     }
     else
     {
         isLastRenderedSamplesShorten = true;
+        underrunConcealer.reset();
         buffer.clear(0, buffer.getNumSamples());
     }
+
+    multiReceiver.mixAudio(buffer, targetLatencyMsec->get());
+}
+
+//==============================================================================
+void NdiReceiverAudioProcessor::handleAsyncUpdate()
+{
+    setLatencySamples(reportedLatencySamples);
+}
+
+void NdiReceiverAudioProcessor::updateLatency(int sourceSampleRate)
+{
+    // Hosts may not change the latency from the audio thread, it is handed to the message thread.
+    const int latency_samples = calculateLatencySamples(sourceSampleRate);
+    if (reportedLatencySamples.exchange(latency_samples) != latency_samples)
+        triggerAsyncUpdate();
+}
+
+int NdiReceiverAudioProcessor::calculateLatencySamples(int sourceSampleRate) const
+{
+    // Blocks from a sender in this process are played as they arrive.
+    if (ndiWrapper.isConnectedInProcess())
+        return 0;
+
+    // The ring is held at the target, then the interpolator adds its delay in source samples.
+    const double device_sample_rate = getSampleRate();
+    double latency_samples = targetLatencyMsec->get() * 0.001 * device_sample_rate;
+    if (sourceSampleRate > 0)
+        latency_samples += interpolatorDelaySamples * device_sample_rate / sourceSampleRate;
+
+    return juce::roundToInt(latency_samples);
 }
 
 //==============================================================================
@@ -225,15 +295,23 @@ juce::AudioProcessorEditor* NdiReceiverAudioProcessor::createEditor()
 //==============================================================================
 void NdiReceiverAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
+    juce::MemoryOutputStream stream(destData, false);
+    stream.writeFloat(targetLatencyMsec->get());
+    stream.writeFloat(maxConcealMsec->get());
 }
 
 void NdiReceiverAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
+    // Sessions saved before there was any state are empty.
+    if (sizeInBytes < (int)sizeof(float))
+        return;
+
+    juce::MemoryInputStream stream(data, (size_t)sizeInBytes, false);
+    *targetLatencyMsec = stream.readFloat();
+
+    // Added later, older sessions keep the default.
+    if (!stream.isExhausted())
+        *maxConcealMsec = stream.readFloat();
 }
 
 //==============================================================================
@@ -10,11 +10,16 @@
 
 #include <JuceHeader.h>
 #include "NdiWrapper.h"
+#include "NdiMultiReceiver.h"
+#include "NdiUnderrunConcealer.h"
+#include "NdiDriftCorrector.h"
+#include "NdiChannelRouter.h"
 
 //==============================================================================
 /**
 */
 class NdiReceiverAudioProcessor  : public juce::AudioProcessor
+                                 , private juce::AsyncUpdater
 {
 public:
     //==============================================================================
@@ -57,16 +62,54 @@ public:
     //==============================================================================
     NdiWrapper& getNdiEngine() { return ndiWrapper; }
 
+    /** Further sources received alongside the connected one, their audio is mixed into the output. */
+    NdiMultiReceiver& getMultiReceiver() { return multiReceiver; }
+
+    /** The number of times the NDI audio ran dry for longer than could be concealed and the output was faded out. */
+    int getNumUnderrunFades() const { return (int)ndiWrapper.stats.underrunFades.get(); }
+
+    /** How much NDI audio is held back before playing, the host is told the resulting latency. */
+    juce::AudioParameterFloat& getTargetLatencyParameter() { return *targetLatencyMsec; }
+
+    /** The longest gap in the NDI audio that is filled in, a longer one fades out. */
+    juce::AudioParameterFloat& getMaxConcealParameter() { return *maxConcealMsec; }
+
+    /** The latency last worked out on the audio thread, it reaches the host shortly after. */
+    int getReportedLatencySamples() const { return reportedLatencySamples.load(); }
+
 private:
+    //==============================================================================
+    void handleAsyncUpdate() override;
+
+    /** Works out the latency for the current formats and has it reported if it changed. */
+    void updateLatency(int sourceSampleRate);
+    int calculateLatencySamples(int sourceSampleRate) const;
+
     //==============================================================================
     NdiWrapper ndiWrapper;
+    NdiMultiReceiver multiReceiver;
 
     double deviceSampleRate;
     int deviceMaxBufferSize;
     juce::OwnedArray<juce::LagrangeInterpolator> interPolators_NdiToDevice;
-    std::unique_ptr<juce::AudioBuffer<float>> resamplingBuffer_NdiToDevice;
+    juce::AudioBuffer<float> retrieveBuffer;
+    juce::AudioBuffer<float> routedBuffer;
+    NdiChannelRouter channelRouter;
 
     bool isLastRenderedSamplesShorten{ true };
+    NdiUnderrunConcealer underrunConcealer;
+
+    // Automatable, owned by the processor once added.
+    juce::AudioParameterFloat* targetLatencyMsec;
+    juce::AudioParameterFloat* maxConcealMsec;
+    std::atomic<int> reportedLatencySamples{ 0 };
+
+    NdiDriftCorrector driftCorrector;
+
+    // The LagrangeInterpolator's output lags its input by two input samples.
+    static constexpr double interpolatorDelaySamples = 2.0;
+    // Sources faster than this many times the device rate make processBlock allocate.
+    static constexpr int maxResampleRatio = 8;
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (NdiReceiverAudioProcessor)
@@ -0,0 +1,166 @@
+/*
+  ==============================================================================
+
+    AudioCapture.cpp
+    Created: 19 Oct 2026 7:24:10pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include "AudioCapture.h"
+
+//==============================================================================
+AudioCapture::AudioCapture(std::shared_ptr<NdiBackend> backend, NdiPipelineStats& stats_)
+    : juce::Thread("NDI Capture")
+    , ndiBackend(std::move(backend))
+    , stats(stats_)
+{
+}
+
+AudioCapture::~AudioCapture()
+{
+    // The capture returns within its time out.
+    stopThread(timeOutMsec + 1000);
+
+    if (pNdiReceiver)
+        ndiBackend->recvDestroy(pNdiReceiver);
+}
+
+//==============================================================================
+juce::StringArray AudioCapture::findSources(NdiBackend& backend, int timeOutMsec)
+{
+    juce::StringArray names;
+
+    NDIlib_find_instance_t p_ndi_finder = backend.findCreate();
+    if (!p_ndi_finder) return names;
+
+    // Sources keep showing up for a while, so the whole time out is waited.
+    const auto deadline_msec = juce::Time::getMillisecondCounter() + (juce::uint32)timeOutMsec;
+    while (juce::Time::getMillisecondCounter() < deadline_msec)
+        backend.findWaitForSources(p_ndi_finder, deadline_msec - juce::Time::getMillisecondCounter());
+
+    uint32_t num_sources = 0;
+    const NDIlib_source_t* p_ndi_sources = backend.findGetCurrentSources(p_ndi_finder, &num_sources);
+    for (uint32_t src_idx = 0; src_idx < num_sources; ++src_idx)
+        names.add(juce::String::fromUTF8(p_ndi_sources[src_idx].p_ndi_name));
+
+    backend.findDestroy(p_ndi_finder);
+    return names;
+}
+
+juce::String AudioCapture::connect(const juce::String& sourceName, int connectTimeOutMsec)
+{
+    jassert(!isThreadRunning());
+
+    NDIlib_find_instance_t p_ndi_finder = ndiBackend->findCreate();
+    if (!p_ndi_finder) return {};
+
+    const auto deadline_msec = juce::Time::getMillisecondCounter() + (juce::uint32)connectTimeOutMsec;
+    while (connectedName.empty() && juce::Time::getMillisecondCounter() < deadline_msec)
+    {
+        ndiBackend->findWaitForSources(p_ndi_finder, (uint32_t)timeOutMsec);
+
+        // Copied out, the source pointers are only valid until the next call.
+        uint32_t num_sources = 0;
+        const NDIlib_source_t* p_ndi_sources = ndiBackend->findGetCurrentSources(p_ndi_finder, &num_sources);
+        for (uint32_t src_idx = 0; src_idx < num_sources; ++src_idx)
+        {
+            const auto name = juce::String::fromUTF8(p_ndi_sources[src_idx].p_ndi_name);
+            if (sourceName.isEmpty() || name.containsIgnoreCase(sourceName))
+            {
+                connectedName = name.toStdString();
+                connectedUrlAddress = p_ndi_sources[src_idx].p_url_address ? p_ndi_sources[src_idx].p_url_address : "";
+                break;
+            }
+        }
+    }
+
+    ndiBackend->findDestroy(p_ndi_finder);
+
+    if (connectedName.empty()) return {};
+
+    pNdiReceiver = ndiBackend->recvCreate();
+    if (!pNdiReceiver) return {};
+
+    NDIlib_source_t ndi_source;
+    ndi_source.p_ndi_name = connectedName.c_str();
+    ndi_source.p_url_address = connectedUrlAddress.empty() ? NULL : connectedUrlAddress.c_str();
+    ndiBackend->recvConnect(pNdiReceiver, &ndi_source);
+
+    startThread(10);
+    return juce::String(connectedName);
+}
+
+//==============================================================================
+int AudioCapture::read(juce::AudioBuffer<float>& buffer)
+{
+    const int num_read = audioCache.pop(buffer);
+    stats.audioRingFill.set(audioCache.getNumReady());
+    return num_read;
+}
+
+void AudioCapture::run()
+{
+    const int max_channels = AudioRingBuffer<float>::maxChannels;
+    float* channels[max_channels] = {};
+
+    NdiThreadPolicy::applyToCurrentThread(NdiThreadPolicy::Role::capture, stats);
+
+    while (!threadShouldExit())
+    {
+        NDIlib_audio_frame_v2_t audio_frame;
+        const auto capture_start_ticks = juce::Time::getHighResolutionTicks();
+
+        // No video descriptor, NDI drops the video before decoding it.
+        const auto frame_type = ndiBackend->recvCapture(pNdiReceiver, nullptr, &audio_frame, (uint32_t)timeOutMsec);
+        samplePerformance();
+
+        if (frame_type != NDIlib_frame_type_audio)
+            continue;
+
+        stats.captureTime.addSince(capture_start_ticks);
+        stats.audioFramesReceived.add();
+
+        // The ring takes the planes where NDI left them, nothing is copied twice.
+        const int num_channels = juce::jmin(audio_frame.no_channels, max_channels);
+        const int channel_stride = audio_frame.channel_stride_in_bytes > 0 ? audio_frame.channel_stride_in_bytes : audio_frame.no_samples * (int)sizeof(float);
+        for (int ch_idx = 0; ch_idx < num_channels; ++ch_idx)
+            channels[ch_idx] = reinterpret_cast<float*>(reinterpret_cast<char*>(audio_frame.p_data) + ch_idx * channel_stride);
+
+        if (num_channels > 0 && audio_frame.no_samples > 0)
+        {
+            sampleRate = audio_frame.sample_rate;
+            if (num_channels != audioCache.numChannels)
+                audioCache.setNumChannels(num_channels);
+            numChannels = num_channels;
+
+            const juce::AudioBuffer<float> planes(channels, num_channels, audio_frame.no_samples);
+            if (audioCache.push(planes) < audio_frame.no_samples)
+                stats.framesDropped.add();
+            stats.audioRingFill.set(audioCache.getNumReady());
+        }
+
+        ndiBackend->recvFreeAudio(pNdiReceiver, &audio_frame);
+    }
+}
+
+void AudioCapture::samplePerformance()
+{
+    const auto now_msec = juce::Time::getMillisecondCounter();
+    if (now_msec - lastPerformanceSampleMsec < (juce::uint32)performanceSampleIntervalMsec) return;
+    lastPerformanceSampleMsec = now_msec;
+
+    NDIlib_recv_performance_t total_frames{ 0, 0, 0 };
+    NDIlib_recv_performance_t dropped_frames{ 0, 0, 0 };
+    NDIlib_recv_queue_t queued_frames{ 0, 0, 0 };
+    ndiBackend->recvGetPerformance(pNdiReceiver, &total_frames, &dropped_frames);
+    ndiBackend->recvGetQueue(pNdiReceiver, &queued_frames);
+
+    const juce::int64 num_dropped = dropped_frames.audio_frames;
+    if (num_dropped > lastNumDroppedInNdi)
+        stats.framesDroppedInNdi.add((juce::uint64)(num_dropped - lastNumDroppedInNdi));
+    lastNumDroppedInNdi = num_dropped;
+
+    stats.ndiQueueAudio.set(queued_frames.audio_frames);
+}
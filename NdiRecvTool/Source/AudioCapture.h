@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+
+    AudioCapture.h
+    Created: 19 Oct 2026 7:24:10pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <Processing.NDI.Lib.h>
+#include "NdiBackend.h"
+#include "NdiPipelineStats.h"
+#include "NdiThreadPolicy.h"
+#include "RingBuffer.h"
+
+//==============================================================================
+/**
+    Receives the audio of one NDI source on a thread of its own, without a GUI.
+
+    Video is never asked for, so NDI does not decode it. The samples go into an
+    AudioRingBuffer for the caller to take at its own pace. Whatever does not
+    fit is counted in the stats, the capture never waits for the reader.
+*/
+class AudioCapture : private juce::Thread
+{
+public:
+    //==============================================================================
+    AudioCapture(std::shared_ptr<NdiBackend> backend, NdiPipelineStats& stats);
+    ~AudioCapture() override;
+
+    /** The names of the sources found within the time out. */
+    static juce::StringArray findSources(NdiBackend& backend, int timeOutMsec);
+
+    /** Connects to the first source whose name contains the text, or the first one found
+        if it is empty, and starts capturing. Returns the name, or nothing if none showed up.
+    */
+    juce::String connect(const juce::String& sourceName, int timeOutMsec);
+
+    //==============================================================================
+    /** Takes up to a buffer full of samples. Returns how many, call from one thread only. */
+    int read(juce::AudioBuffer<float>& buffer);
+
+    /** Both 0 until the first audio has arrived. */
+    int getSampleRate() const { return sampleRate.load(); }
+    int getNumChannels() const { return numChannels.load(); }
+
+private:
+    //==============================================================================
+    void run() override;
+    void samplePerformance();
+
+    //==============================================================================
+    std::shared_ptr<NdiBackend> ndiBackend;
+    NdiPipelineStats& stats;
+    NDIlib_recv_instance_t pNdiReceiver{ nullptr };
+
+    // About ten seconds at 48 kHz, the reader takes a block every few milliseconds.
+    AudioRingBuffer<float> audioCache{ 1 << 19 };
+    std::atomic<int> sampleRate{ 0 };
+    std::atomic<int> numChannels{ 0 };
+
+    std::string connectedName;
+    std::string connectedUrlAddress;
+
+    juce::uint32 lastPerformanceSampleMsec{ 0 };
+    juce::int64 lastNumDroppedInNdi{ 0 };
+
+    const int timeOutMsec{ 100 };
+    const int performanceSampleIntervalMsec{ 500 };
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioCapture)
+};
@@ -0,0 +1,176 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 19 Oct 2026 7:24:10pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <csignal>
+#include <cstdio>
+#include <iostream>
+#include "AudioCapture.h"
+
+//==============================================================================
+namespace
+{
+    volatile std::sig_atomic_t shouldQuit = 0;
+
+    void handleSignal(int)
+    {
+        shouldQuit = 1;
+    }
+
+    void printUsage()
+    {
+        std::cerr << "Usage: ndi-recv [options]\n"
+                  << "  --list                          List the sources found and quit\n"
+                  << "  --source=<text>                 Receive the first source whose name contains the text\n"
+                  << "                                  (default: the first source found)\n"
+                  << "  --wav=<file>                    Write the audio to a 32 bit float WAV file\n"
+                  << "  --stdout                        Write the audio to stdout as interleaved 32 bit floats\n"
+                  << "  --seconds=<seconds>             Stop after this long (default: until interrupted)\n"
+                  << "  --stats=<seconds>               Print the pipeline stats this often, 0 for never (default 5)\n"
+                  << "  --timeout=<seconds>             How long to look for sources (default 10)\n"
+                  << "  --capture-threads=<policy>      Scheduling of the capture thread, e.g. \"fifo=20 nice=-5 cpus=2-3\"\n"
+                  << "                                  (default: NDI_CAPTURE_THREADS, or the normal scheduler)\n";
+    }
+
+    void printStats(const juce::String& sourceName, const NdiPipelineStats& stats)
+    {
+        std::cerr << sourceName << std::endl << stats.toText().joinIntoString("\n") << std::endl;
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    const int time_out_msec = juce::roundToInt(1000.0 * (args.containsOption("--timeout") ? args.getValueForOption("--timeout").getDoubleValue() : 10.0));
+    const int stats_interval_msec = juce::roundToInt(1000.0 * (args.containsOption("--stats") ? args.getValueForOption("--stats").getDoubleValue() : 5.0));
+    const double max_seconds = args.getValueForOption("--seconds").getDoubleValue();
+    const bool is_to_stdout = args.containsOption("--stdout");
+    const auto wav_path = args.getValueForOption("--wav");
+
+    if (args.containsOption("--capture-threads"))
+        NdiThreadPolicy::setForRole(NdiThreadPolicy::Role::capture, NdiThreadPolicy::fromString(args.getValueForOption("--capture-threads")));
+
+    auto backend = NdiBackend::getDefault();
+    if (!backend->isAvailable())
+    {
+        std::cerr << "The NDI runtime is not installed" << std::endl;
+        return 1;
+    }
+
+    if (args.containsOption("--list"))
+    {
+        for (const auto& name : AudioCapture::findSources(*backend, time_out_msec))
+            std::cout << name << std::endl;
+        return 0;
+    }
+
+    if (!is_to_stdout && wav_path.isEmpty())
+        std::cerr << "Neither --wav nor --stdout given, only the stats are printed" << std::endl;
+
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+#ifdef SIGPIPE
+    // A closed pipe shows up as a failed write instead.
+    std::signal(SIGPIPE, SIG_IGN);
+#endif
+
+    NdiPipelineStats stats;
+    AudioCapture capture(backend, stats);
+
+    const auto source_name = capture.connect(args.getValueForOption("--source"), time_out_msec);
+    if (source_name.isEmpty())
+    {
+        std::cerr << "No source found" << std::endl;
+        return 1;
+    }
+    std::cerr << "Receiving " << source_name << std::endl;
+
+    // The WAV header needs the format, which is only known from the first frame.
+    std::unique_ptr<juce::AudioFormatWriter> wav_writer;
+    juce::AudioBuffer<float> block(AudioRingBuffer<float>::maxChannels, 1024);
+    juce::HeapBlock<float> interleaved(AudioRingBuffer<float>::maxChannels * block.getNumSamples());
+
+    const auto start_msec = juce::Time::getMillisecondCounter();
+    auto last_stats_msec = start_msec;
+    bool has_failed = false;
+
+    while (!shouldQuit && !has_failed)
+    {
+        const auto now_msec = juce::Time::getMillisecondCounter();
+        if (max_seconds > 0.0 && now_msec - start_msec >= (juce::uint32)(max_seconds * 1000.0))
+            break;
+
+        if (stats_interval_msec > 0 && now_msec - last_stats_msec >= (juce::uint32)stats_interval_msec)
+        {
+            printStats(source_name, stats);
+            last_stats_msec = now_msec;
+        }
+
+        const int num_samples = capture.read(block);
+        if (num_samples == 0)
+        {
+            juce::Thread::sleep(5);
+            continue;
+        }
+
+        const int num_channels = juce::jmax(1, capture.getNumChannels());
+
+        if (wav_path.isNotEmpty() && wav_writer == nullptr)
+        {
+            auto wav_file = juce::File::getCurrentWorkingDirectory().getChildFile(wav_path);
+            wav_file.deleteFile();
+
+            if (auto file_stream = wav_file.createOutputStream())
+            {
+                juce::WavAudioFormat wav_format;
+                wav_writer.reset(wav_format.createWriterFor(file_stream.get(), capture.getSampleRate(), (unsigned int)num_channels, 32, {}, 0));
+                if (wav_writer != nullptr)
+                    file_stream.release();
+            }
+
+            if (wav_writer == nullptr)
+            {
+                std::cerr << "Could not write " << wav_file.getFullPathName() << std::endl;
+                has_failed = true;
+                break;
+            }
+        }
+
+        if (wav_writer != nullptr)
+            has_failed = !wav_writer->writeFromAudioSampleBuffer(block, 0, num_samples);
+
+        if (is_to_stdout && !has_failed)
+        {
+            for (int ch_idx = 0; ch_idx < num_channels; ++ch_idx)
+            {
+                const float* src = block.getReadPointer(juce::jmin(ch_idx, block.getNumChannels() - 1));
+                for (int sample_idx = 0; sample_idx < num_samples; ++sample_idx)
+                    interleaved[sample_idx * num_channels + ch_idx] = src[sample_idx];
+            }
+
+            const size_t num_values = (size_t)(num_samples * num_channels);
+            has_failed = std::fwrite(interleaved.get(), sizeof(float), num_values, stdout) != num_values;
+        }
+    }
+
+    std::fflush(stdout);
+    wav_writer.reset();
+
+    printStats(source_name, stats);
+    return has_failed ? 1 : 0;
+}
@@ -0,0 +1,34 @@
+#!/bin/sh
+
+echo '--- Define script directory ---'
+SCRIPT_DIRECTORY=$(cd $(dirname $0);pwd)
+cd ${SCRIPT_DIRECTORY}
+
+# Script job will terminate when error occured.
+set -e
+
+echo '--- Set variables ---'
+PROJECT_NAME=NdiRecvTool
+BUILD_CONFIG=Release
+# The executable is named after the tool, not the project.
+TARGET_NAME=ndi-recv
+EXPORTER_NAME=LinuxMakefile
+# Only the macOS Projucer is checked in, point PROJUCER at a Linux build of it.
+PROJUCER=${PROJUCER:-${SCRIPT_DIRECTORY}/../Projucer/Projucer}
+
+echo '--- Show variables ---'
+echo 'SCRIPT_DIRECTORY: '${SCRIPT_DIRECTORY}
+echo 'PROJECT_NAME: '${PROJECT_NAME}
+echo 'BUILD_CONFIG: '${BUILD_CONFIG}
+echo 'TARGET_NAME: '${TARGET_NAME}
+echo 'EXPORTER_NAME: '${EXPORTER_NAME}
+echo 'PROJUCER: '${PROJUCER}
+echo 'NDI_SDK_DIR: '${NDI_SDK_DIR}
+
+echo '--- Generate Makefile by Projucer ---'
+${PROJUCER} --resave ${SCRIPT_DIRECTORY}/${PROJECT_NAME}.jucer
+
+echo '--- Run make ---'
+make -C "${SCRIPT_DIRECTORY}/Builds/${EXPORTER_NAME}" CONFIG=${BUILD_CONFIG} -j$(nproc)
+
+echo '--- Built '${SCRIPT_DIRECTORY}/Builds/${EXPORTER_NAME}/build/${TARGET_NAME}' ---'
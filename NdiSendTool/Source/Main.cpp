@@ -0,0 +1,208 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 19 Oct 2026 8:02:37pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <csignal>
+#include <iostream>
+#include "SendPipeline.h"
+
+//==============================================================================
+namespace
+{
+    volatile std::sig_atomic_t shouldQuit = 0;
+
+    void handleSignal(int)
+    {
+        shouldQuit = 1;
+    }
+
+    void printUsage()
+    {
+        std::cerr << "Usage: ndi-send [options]\n"
+                  << "  --name=<text>                   Name of the NDI source (default ndi-send)\n"
+                  << "  --count=<senders>               Run this many independent sources, numbered after the name\n"
+                  << "  --file=<file>                   Stream an audio file instead of a tone\n"
+                  << "  --loop                          Play the file again when it ends\n"
+                  << "  --noise                         Send white noise instead of a tone\n"
+                  << "  --tone=<hz>                     Frequency of the tone (default 1000)\n"
+                  << "  --level=<db>                    Level of the tone or noise (default -20)\n"
+                  << "  --sample-rate=<hz>              Sample rate of the tone or noise (default 48000)\n"
+                  << "  --channels=<count>              Channels of the tone or noise (default 2)\n"
+                  << "  --block=<samples>               Samples per audio frame (default 1024)\n"
+                  << "  --video=<width>x<height>        Also send a test pattern\n"
+                  << "  --pattern=bars|noise            Scrolling colour bars, or noise for the worst case encode (default bars)\n"
+                  << "  --fourcc=<type>                 UYVY, UYVA, BGRA, BGRX, RGBA, RGBX, NV12, I420 or YV12 (default UYVY)\n"
+                  << "  --fps=<rate>                    Frame rate of the test pattern (default 30)\n"
+                  << "  --seconds=<seconds>             Stop after this long (default: until interrupted)\n"
+                  << "  --stats=<seconds>               Print the pipeline stats this often, 0 for never (default 5)\n"
+                  << "  --send-threads=<policy>         Scheduling of the send threads, e.g. \"fifo=20 nice=-5 cpus=2-3\"\n"
+                  << "                                  (default: NDI_SEND_THREADS, or the normal scheduler)\n";
+    }
+
+    std::unique_ptr<SignalSource> createSignalSource(const juce::ArgumentList& args)
+    {
+        if (args.containsOption("--file"))
+            return SignalSource::createFromFile(juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--file")), args.containsOption("--loop"));
+
+        const float gain = juce::Decibels::decibelsToGain(args.containsOption("--level") ? args.getValueForOption("--level").getFloatValue() : -20.0f);
+        const double sample_rate = juce::jlimit(8000.0, 192000.0, args.containsOption("--sample-rate") ? args.getValueForOption("--sample-rate").getDoubleValue() : 48000.0);
+        const int num_channels = juce::jlimit(1, 64, args.containsOption("--channels") ? args.getValueForOption("--channels").getIntValue() : 2);
+
+        if (args.containsOption("--noise"))
+            return SignalSource::createNoise(gain, sample_rate, num_channels);
+
+        return SignalSource::createTone(args.containsOption("--tone") ? args.getValueForOption("--tone").getDoubleValue() : 1000.0,
+                                        gain, sample_rate, num_channels);
+    }
+
+    void printStats(const juce::OwnedArray<SendPipeline>& pipelines, const NdiPipelineStats& stats,
+                    double seconds, double frameRate, bool hasVideo)
+    {
+        int num_connections = 0;
+        for (auto* pipeline : pipelines)
+            num_connections += pipeline->getNumConnections();
+
+        std::cerr << pipelines.size() << " sender(s), " << num_connections << " connection(s)";
+        if (hasVideo && seconds > 0.0)
+            std::cerr << ", " << juce::String(stats.videoFramesSent.get() / seconds / pipelines.size(), 2)
+                      << " of " << frameRate << " fps per sender";
+        std::cerr << std::endl << stats.toText().joinIntoString("\n") << std::endl;
+
+        // Only the senders that fell behind, to find the point where the box runs out.
+        for (auto* pipeline : pipelines)
+        {
+            if (pipeline->getNumLateFrames() > 0)
+                std::cerr << "  " << pipeline->getName() << ": " << (juce::int64)pipeline->getNumLateFrames() << " late" << std::endl;
+        }
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    SendPipeline::Settings settings;
+    if (args.containsOption("--name"))
+        settings.name = args.getValueForOption("--name");
+    settings.blockSize = juce::jlimit(32, 16384, args.containsOption("--block") ? args.getValueForOption("--block").getIntValue() : 1024);
+    settings.frameRate = juce::jlimit(1.0, 240.0, args.containsOption("--fps") ? args.getValueForOption("--fps").getDoubleValue() : 30.0);
+
+    const int num_senders = juce::jlimit(1, 256, args.containsOption("--count") ? args.getValueForOption("--count").getIntValue() : 1);
+    const int stats_interval_msec = juce::roundToInt(1000.0 * (args.containsOption("--stats") ? args.getValueForOption("--stats").getDoubleValue() : 5.0));
+    const double max_seconds = args.getValueForOption("--seconds").getDoubleValue();
+
+    if (args.containsOption("--send-threads"))
+        NdiThreadPolicy::setForRole(NdiThreadPolicy::Role::send, NdiThreadPolicy::fromString(args.getValueForOption("--send-threads")));
+
+    // One pattern for all senders, it does not change once drawn.
+    std::shared_ptr<const NdiTestPattern> test_pattern;
+    if (args.containsOption("--video"))
+    {
+        const auto video_size = args.getValueForOption("--video");
+        const int video_width = video_size.upToFirstOccurrenceOf("x", false, true).getIntValue();
+        const int video_height = video_size.fromFirstOccurrenceOf("x", false, true).getIntValue();
+        if (video_width <= 0 || video_height <= 0)
+        {
+            std::cerr << "--video wants <width>x<height>, e.g. 1920x1080" << std::endl;
+            return 1;
+        }
+
+        NDIlib_FourCC_video_type_e four_cc = NDIlib_FourCC_video_type_UYVY;
+        if (args.containsOption("--fourcc") && !NdiTestPattern::parseFourCC(args.getValueForOption("--fourcc"), four_cc))
+        {
+            std::cerr << "Unknown --fourcc " << args.getValueForOption("--fourcc") << std::endl;
+            return 1;
+        }
+
+        const auto pattern_type = args.getValueForOption("--pattern") == "noise" ? NdiTestPattern::Type::noise : NdiTestPattern::Type::bars;
+        test_pattern = std::make_shared<const NdiTestPattern>(video_width, video_height, four_cc, pattern_type);
+    }
+
+    auto backend = NdiBackend::getDefault();
+    if (!backend->isAvailable())
+    {
+        std::cerr << "The NDI runtime is not installed" << std::endl;
+        return 1;
+    }
+
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+
+    //==============================================================================
+    NdiPipelineStats stats;
+    juce::OwnedArray<SendPipeline> pipelines;
+
+    for (int sender_idx = 0; sender_idx < num_senders; ++sender_idx)
+    {
+        auto signal_source = createSignalSource(args);
+        if (signal_source == nullptr)
+        {
+            std::cerr << "Could not read " << args.getValueForOption("--file") << std::endl;
+            return 1;
+        }
+
+        auto pipeline_settings = settings;
+        if (num_senders > 1)
+            pipeline_settings.name << " " << (sender_idx + 1);
+
+        auto* pipeline = pipelines.add(new SendPipeline(backend, pipeline_settings, std::move(signal_source), test_pattern, stats));
+        if (!pipeline->start())
+        {
+            std::cerr << "Could not create the NDI source " << pipeline->getName() << std::endl;
+            return 1;
+        }
+    }
+
+    std::cerr << "Sending " << num_senders << " source(s) named " << settings.name;
+    if (test_pattern != nullptr)
+        std::cerr << ", " << test_pattern->getWidth() << "x" << test_pattern->getHeight() << " at " << settings.frameRate << " fps";
+    std::cerr << std::endl;
+
+    //==============================================================================
+    const auto start_msec = juce::Time::getMillisecondCounter();
+    auto last_stats_msec = start_msec;
+
+    const auto is_all_finished = [&pipelines]
+    {
+        for (auto* pipeline : pipelines)
+        {
+            if (!pipeline->isFinished())
+                return false;
+        }
+        return true;
+    };
+
+    while (!shouldQuit && !is_all_finished())
+    {
+        const auto now_msec = juce::Time::getMillisecondCounter();
+        if (max_seconds > 0.0 && now_msec - start_msec >= (juce::uint32)(max_seconds * 1000.0))
+            break;
+
+        if (stats_interval_msec > 0 && now_msec - last_stats_msec >= (juce::uint32)stats_interval_msec)
+        {
+            printStats(pipelines, stats, (now_msec - start_msec) / 1000.0, settings.frameRate, test_pattern != nullptr);
+            last_stats_msec = now_msec;
+        }
+
+        juce::Thread::sleep(50);
+    }
+
+    printStats(pipelines, stats, (juce::Time::getMillisecondCounter() - start_msec) / 1000.0, settings.frameRate, test_pattern != nullptr);
+    pipelines.clear();
+
+    return 0;
+}
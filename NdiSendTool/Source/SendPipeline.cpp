@@ -0,0 +1,145 @@
+/*
+  ==============================================================================
+
+    SendPipeline.cpp
+    Created: 19 Oct 2026 9:16:48pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include "SendPipeline.h"
+#include <limits>
+
+//==============================================================================
+SendPipeline::SendPipeline(std::shared_ptr<NdiBackend> backend, const Settings& settings_,
+                           std::unique_ptr<SignalSource> signalSource_, std::shared_ptr<const NdiTestPattern> pattern,
+                           NdiPipelineStats& stats_)
+    : juce::Thread("NDI Send " + settings_.name)
+    , ndiBackend(std::move(backend))
+    , settings(settings_)
+    , signalSource(std::move(signalSource_))
+    , testPattern(std::move(pattern))
+    , stats(stats_)
+    , nameUtf8(settings_.name.toStdString())
+{
+}
+
+SendPipeline::~SendPipeline()
+{
+    stopThread(2000);
+
+    if (pNdiSend)
+        ndiBackend->sendDestroy(pNdiSend);
+}
+
+bool SendPipeline::start()
+{
+    // The thread paces the frames, so NDI is not asked to clock them.
+    NDIlib_send_create_t ndi_send_desc;
+    ndi_send_desc.p_ndi_name = nameUtf8.c_str();
+    ndi_send_desc.p_groups = NULL;
+    ndi_send_desc.clock_video = false;
+    ndi_send_desc.clock_audio = false;
+
+    pNdiSend = ndiBackend->sendCreate(&ndi_send_desc);
+    if (!pNdiSend) return false;
+
+    hasStarted = true;
+    startThread(8);
+    return true;
+}
+
+int SendPipeline::getNumConnections() const
+{
+    return pNdiSend ? ndiBackend->sendGetNoConnections(pNdiSend, 0) : 0;
+}
+
+//==============================================================================
+void SendPipeline::run()
+{
+    NdiThreadPolicy::applyToCurrentThread(NdiThreadPolicy::Role::send, stats);
+
+    const int num_channels = signalSource->getNumChannels();
+    const double sample_rate = signalSource->getSampleRate();
+    const int block_size = settings.blockSize;
+
+    // NDI takes planar float, one channel after the other.
+    juce::HeapBlock<float> audio_data((size_t)(num_channels * block_size), true);
+    juce::HeapBlock<float*> channels((size_t)num_channels);
+    for (int ch_idx = 0; ch_idx < num_channels; ++ch_idx)
+        channels[ch_idx] = audio_data + ch_idx * block_size;
+    juce::AudioBuffer<float> audio_block(channels.get(), num_channels, block_size);
+
+    NDIlib_audio_frame_v2_t audio_frame;
+    audio_frame.sample_rate = juce::roundToInt(sample_rate);
+    audio_frame.no_channels = num_channels;
+    audio_frame.no_samples = block_size;
+    audio_frame.timecode = NDIlib_send_timecode_synthesize;
+    audio_frame.p_data = audio_data.get();
+    audio_frame.channel_stride_in_bytes = block_size * (int)sizeof(float);
+
+    // Each pipeline draws its own frames, like a real sender converting its own.
+    juce::HeapBlock<uint8_t> video_data(testPattern != nullptr ? testPattern->getFrameSize() : 0);
+    NDIlib_video_frame_v2_t video_frame;
+    if (testPattern != nullptr)
+        testPattern->describe(video_frame);
+    video_frame.frame_rate_N = juce::roundToInt(settings.frameRate * 1000.0);
+    video_frame.frame_rate_D = 1000;
+    video_frame.frame_format_type = NDIlib_frame_format_type_progressive;
+    video_frame.timecode = NDIlib_send_timecode_synthesize;
+    video_frame.p_data = video_data.get();
+
+    const double ticks_per_second = (double)juce::Time::getHighResolutionTicksPerSecond();
+    const auto audio_period_ticks = (juce::int64)(block_size * ticks_per_second / sample_rate);
+    const auto video_period_ticks = (juce::int64)(ticks_per_second / settings.frameRate);
+    const auto start_ticks = juce::Time::getHighResolutionTicks();
+    juce::int64 num_audio_frames = 0;
+    juce::int64 num_video_frames = 0;
+
+    while (!threadShouldExit() && !signalSource->isFinished())
+    {
+        const auto audio_due_ticks = start_ticks + (juce::int64)(num_audio_frames * block_size * ticks_per_second / sample_rate);
+        const auto video_due_ticks = testPattern != nullptr
+            ? start_ticks + (juce::int64)(num_video_frames * ticks_per_second / settings.frameRate)
+            : std::numeric_limits<juce::int64>::max();
+
+        const auto due_ticks = juce::jmin(audio_due_ticks, video_due_ticks);
+        const auto now_ticks = juce::Time::getHighResolutionTicks();
+        if (now_ticks < due_ticks)
+        {
+            wait(juce::jmin(100, juce::jmax(1, (int)(juce::Time::highResolutionTicksToSeconds(due_ticks - now_ticks) * 1000.0))));
+            continue;
+        }
+
+        const bool is_audio = audio_due_ticks <= video_due_ticks;
+        if (now_ticks - due_ticks > (is_audio ? audio_period_ticks : video_period_ticks))
+        {
+            stats.framesLate.add();
+            ++numLateFrames;
+        }
+
+        if (is_audio)
+        {
+            signalSource->read(audio_block);
+
+            const auto send_start_ticks = juce::Time::getHighResolutionTicks();
+            ndiBackend->sendAudio(pNdiSend, &audio_frame);
+            stats.sendTime.addSince(send_start_ticks);
+            stats.audioFramesSent.add();
+            ++num_audio_frames;
+        }
+        else
+        {
+            const auto render_start_ticks = juce::Time::getHighResolutionTicks();
+            testPattern->render(num_video_frames, video_data.get());
+            stats.convertTime.addSince(render_start_ticks);
+
+            const auto send_start_ticks = juce::Time::getHighResolutionTicks();
+            ndiBackend->sendVideo(pNdiSend, &video_frame);
+            stats.sendTime.addSince(send_start_ticks);
+            stats.videoFramesSent.add();
+            ++num_video_frames;
+        }
+    }
+}
@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    SendPipeline.h
+    Created: 19 Oct 2026 9:16:48pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <Processing.NDI.Lib.h>
+#include "NdiBackend.h"
+#include "NdiPipelineStats.h"
+#include "NdiThreadPolicy.h"
+#include "NdiTestPattern.h"
+#include "SignalSource.h"
+
+//==============================================================================
+/**
+    One NDI source sending audio and optionally test pattern video, on a thread of its own.
+
+    Frames are due on a fixed grid from the start and a late frame does not
+    move the next one, so a sender that cannot keep up shows in the late
+    count instead of a slower frame rate. Several pipelines can share one
+    pattern and one NdiPipelineStats, which then holds their totals.
+*/
+class SendPipeline : private juce::Thread
+{
+public:
+    //==============================================================================
+    struct Settings
+    {
+        juce::String name{ "ndi-send" };
+        int blockSize{ 1024 };
+        double frameRate{ 30.0 };
+    };
+
+    /** Without a pattern only audio is sent. */
+    SendPipeline(std::shared_ptr<NdiBackend> backend, const Settings& settings,
+                 std::unique_ptr<SignalSource> signalSource, std::shared_ptr<const NdiTestPattern> pattern,
+                 NdiPipelineStats& stats);
+    ~SendPipeline() override;
+
+    /** Creates the NDI source and starts sending, false if the source could not be created. */
+    bool start();
+
+    //==============================================================================
+    const juce::String& getName() const { return settings.name; }
+    int getNumConnections() const;
+    juce::uint64 getNumLateFrames() const { return numLateFrames.load(); }
+
+    /** True once a file that does not loop has been sent to its end. */
+    bool isFinished() const { return !isThreadRunning() && hasStarted; }
+
+private:
+    //==============================================================================
+    void run() override;
+
+    //==============================================================================
+    std::shared_ptr<NdiBackend> ndiBackend;
+    const Settings settings;
+    std::unique_ptr<SignalSource> signalSource;
+    std::shared_ptr<const NdiTestPattern> testPattern;
+    NdiPipelineStats& stats;
+
+    NDIlib_send_instance_t pNdiSend{ nullptr };
+    std::string nameUtf8;
+    bool hasStarted{ false };
+    std::atomic<juce::uint64> numLateFrames{ 0 };
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SendPipeline)
+};
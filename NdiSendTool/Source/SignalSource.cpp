@@ -0,0 +1,101 @@
+/*
+  ==============================================================================
+
+    SignalSource.cpp
+    Created: 19 Oct 2026 8:02:37pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#include "SignalSource.h"
+
+//==============================================================================
+namespace
+{
+    // Only a hint to the sources, the send loop may ask for any block size.
+    constexpr int expectedBlockSize = 4096;
+
+    class NoiseAudioSource : public juce::AudioSource
+    {
+    public:
+        explicit NoiseAudioSource(float gain_) : gain(gain_) {}
+
+        void prepareToPlay(int, double) override {}
+        void releaseResources() override {}
+
+        void getNextAudioBlock(const juce::AudioSourceChannelInfo& info) override
+        {
+            for (int ch_idx = 0; ch_idx < info.buffer->getNumChannels(); ++ch_idx)
+            {
+                float* dest = info.buffer->getWritePointer(ch_idx, info.startSample);
+                for (int sample_idx = 0; sample_idx < info.numSamples; ++sample_idx)
+                    dest[sample_idx] = gain * (2.0f * random.nextFloat() - 1.0f);
+            }
+        }
+
+    private:
+        const float gain;
+        juce::Random random;
+    };
+}
+
+//==============================================================================
+std::unique_ptr<SignalSource> SignalSource::createFromFile(const juce::File& file, bool shouldLoop)
+{
+    juce::AudioFormatManager format_manager;
+    format_manager.registerBasicFormats();
+
+    auto* reader = format_manager.createReaderFor(file);
+    if (reader == nullptr) return nullptr;
+
+    const double sample_rate = reader->sampleRate;
+    const int num_channels = (int)reader->numChannels;
+
+    auto reader_source = std::make_unique<juce::AudioFormatReaderSource>(reader, true);
+    reader_source->setLooping(shouldLoop);
+
+    auto* positionable = reader_source.get();
+    return std::unique_ptr<SignalSource>(new SignalSource(std::move(reader_source), positionable, sample_rate, num_channels));
+}
+
+std::unique_ptr<SignalSource> SignalSource::createTone(double frequencyHz, float gain, double sampleRate, int numChannels)
+{
+    auto tone_source = std::make_unique<juce::ToneGeneratorAudioSource>();
+    tone_source->setFrequency(frequencyHz);
+    tone_source->setAmplitude(gain);
+
+    return std::unique_ptr<SignalSource>(new SignalSource(std::move(tone_source), nullptr, sampleRate, numChannels));
+}
+
+std::unique_ptr<SignalSource> SignalSource::createNoise(float gain, double sampleRate, int numChannels)
+{
+    return std::unique_ptr<SignalSource>(new SignalSource(std::make_unique<NoiseAudioSource>(gain), nullptr, sampleRate, numChannels));
+}
+
+SignalSource::SignalSource(std::unique_ptr<juce::AudioSource> source, juce::PositionableAudioSource* positionable, double sampleRate_, int numChannels_)
+    : audioSource(std::move(source))
+    , positionableSource(positionable)
+    , sampleRate(sampleRate_)
+    , numChannels(numChannels_)
+{
+    audioSource->prepareToPlay(expectedBlockSize, sampleRate);
+}
+
+SignalSource::~SignalSource()
+{
+    audioSource->releaseResources();
+}
+
+//==============================================================================
+void SignalSource::read(juce::AudioBuffer<float>& buffer)
+{
+    audioSource->getNextAudioBlock(juce::AudioSourceChannelInfo(buffer));
+}
+
+bool SignalSource::isFinished() const
+{
+    return positionableSource != nullptr
+        && !positionableSource->isLooping()
+        && positionableSource->getNextReadPosition() >= positionableSource->getTotalLength();
+}
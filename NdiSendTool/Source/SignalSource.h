@@ -0,0 +1,54 @@
+/*
+  ==============================================================================
+
+    SignalSource.h
+    Created: 19 Oct 2026 8:02:37pm
+    Author:  Tatsuya Shiozawa
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    The audio ndi-send streams: an audio file, a sine tone or white noise.
+
+    Blocks are pulled by the send loop, which paces itself, so nothing here
+    knows about time. Video comes from an NdiTestPattern.
+*/
+class SignalSource
+{
+public:
+    //==============================================================================
+    /** Nothing if the file cannot be read. */
+    static std::unique_ptr<SignalSource> createFromFile(const juce::File& file, bool shouldLoop);
+    static std::unique_ptr<SignalSource> createTone(double frequencyHz, float gain, double sampleRate, int numChannels);
+    /** Independent noise on every channel. */
+    static std::unique_ptr<SignalSource> createNoise(float gain, double sampleRate, int numChannels);
+
+    ~SignalSource();
+
+    //==============================================================================
+    double getSampleRate() const { return sampleRate; }
+    int getNumChannels() const { return numChannels; }
+
+    /** Fills the buffer, silence past the end of a file that does not loop. */
+    void read(juce::AudioBuffer<float>& buffer);
+
+    /** True once a file that does not loop has played to its end. */
+    bool isFinished() const;
+
+private:
+    //==============================================================================
+    SignalSource(std::unique_ptr<juce::AudioSource> source, juce::PositionableAudioSource* positionable, double sampleRate, int numChannels);
+
+    std::unique_ptr<juce::AudioSource> audioSource;
+    juce::PositionableAudioSource* positionableSource;
+    const double sampleRate;
+    const int numChannels;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SignalSource)
+};
@@ -12,113 +12,43 @@
 #include <Processing.NDI.Lib.h>
 #include "NdiVideoHelper.h"
 #include "NdiAudioHelper.h"
-
-#if JUCE_MAC
-#include <dlfcn.h>
-#endif
+#include "NdiBackend.h"
+#include "NdiSharedMemoryTransport.h"
+#include "NdiInProcessRouter.h"
 
 //==============================================================================
 class NdiSendWrapper::Impl
 {
 public:
     //==============================================================================
-    Impl()
-        : uuid_dashed_str(uuid.toDashedString().toStdString())
+    explicit Impl(NdiPipelineStats& stats_)
+        : stats(stats_)
+        , uuid_dashed_str(uuid.toDashedString().toStdString())
     {
-#if JUCE_MAC
-        std::string ndi_path;
-        
-        // ToDo
-        const char* p_NDI_runtime_folder = std::getenv("NDI_RUNTIME_DIR_V4");
-        if (p_NDI_runtime_folder)
-        {
-            ndi_path = p_NDI_runtime_folder;
-            ndi_path += "/libndi.dylib";
-        }
-        else
-        {
-            ndi_path = "libndi.4.dylib"; // The standard versioning scheme on Linux based systems using sym links
-        }
-        
-        // Try to load the library
-        void* handle_ndi_lib = ::dlopen(ndi_path.c_str(), RTLD_LOCAL | RTLD_LAZY);
-        
-        // If handle is NULL, Re-try to load the library by absolute path.
-        if(!handle_ndi_lib)
-        {
-            ndi_path = "/usr/local/lib/libndi.4.dylib";
-            handle_ndi_lib = ::dlopen(ndi_path.c_str(), RTLD_LOCAL | RTLD_LAZY);
-        }
-        
-        // The main NDI entry point for dynamic loading if we got the library
-        const NDIlib_v4* (*funcPtr_NDIlib_v4_load)(void) = NULL;
-        if(handle_ndi_lib)
-        {
-            *((void**)&funcPtr_NDIlib_v4_load) = ::dlsym(handle_ndi_lib, "NDIlib_v4_load");
-        }
-        
-        if (!funcPtr_NDIlib_v4_load)
-        {
-            DBG("Please re-install the NewTek NDI Runtimes to use this application.");
-            return;
-        }
-        
-        // Lets get all of the DLL entry points
-        pNdiLib = funcPtr_NDIlib_v4_load();
-        
-        // We can now run as usual
-        if (!pNdiLib->NDIlib_initialize())
-        {    // Cannot run NDI. Most likely because the CPU is not sufficient (see SDK documentation).
-            // you can check this directly with a call to NDIlib_is_supported_CPU()
-            DBG("Cannot run NDI.");
-            return;
-        }
-        
-        // Create an NDI source that is called "My Video and Audio" and is clocked to the video.
-        ndiSendDesc.p_ndi_name = uuid_dashed_str.c_str();
-        ndiSendDesc.clock_audio = true;
-
-        // We create the NDI sender
-        pNdiSender = pNdiLib->NDIlib_send_create(&ndiSendDesc);
-        if (!pNdiSender) return;
-#else
-        // Not required, but "correct" (see the SDK documentation.
-        if (!NDIlib_initialize()) return;
-
-        // Create an NDI source that is called "My Video and Audio" and is clocked to the video.
-        ndiSendDesc.p_ndi_name = uuid_dashed_str.c_str();
-        ndiSendDesc.clock_audio = true;
-
-        // We create the NDI sender
-        pNdiSender = NDIlib_send_create(&ndiSendDesc);
-        if (!pNdiSender) return;
-#endif
+        // Nothing is loaded or created here, so plugin scans and session loads stay fast.
+        // The sender is created when the send thread first needs it.
     }
 
     ~Impl()
     {
-#if JUCE_MAC
-        if(pNdiLib)
-        {
-            // Destroy the NDI sender
-            pNdiLib->NDIlib_send_destroy(pNdiSender);
-
-            // Not required, but nice
-            pNdiLib->NDIlib_destroy();
-        }
-#else
         // Destroy the NDI sender
-        NDIlib_send_destroy(pNdiSender);
+        if(pNdiSender) ndiBackend->sendDestroy(pNdiSender);
 
-        // Not required, but nice
-        NDIlib_destroy();
-#endif
+        // The backend, and the runtime behind it, are destroyed along with their last user.
     }
 
     //==============================================================================
-    void sendFrame(const NdiSendWrapper::NdiFrame& frame) const
+    // Audio and video come from their own tasks at the same time. Nothing is locked while converting,
+    // so a large video frame never holds up the audio.
+    void sendFrame(const NdiSendWrapper::NdiFrame& frame)
     {
-        const juce::ScopedLock frame_lock(lock);
+        if (!ensureSender()) return;
+
+        // Local readers get the raw frame through shared memory, NDI only encodes for remote receivers.
+        const bool has_local_readers = localWriter && localWriter->hasReaders();
+        const bool has_ndi_receivers = pNdiSender && numNdiConnections > 0;
+
+        if (!has_local_readers && !has_ndi_receivers) return;
 
         switch (frame.type)
         {
@@ -127,17 +57,26 @@ public:
             {
                 // Create an video buffer
                 NDIlib_video_frame_v2_t NDI_video_frame;
-                NdiVideoHelper::convertVideoFrame(NDI_video_frame, frame.video);
-#if JUCE_MAC
-                if(pNdiLib)
+                const auto convert_start_ticks = juce::Time::getHighResolutionTicks();
                 {
-                    // Send data
-                    pNdiLib->NDIlib_send_send_video_v2(pNdiSender, &NDI_video_frame);
+                    NDI_TRACE_ZONE("Convert video");
+                    NdiVideoHelper::convertVideoFrame(NDI_video_frame, frame.video);
                 }
-#else
+                stats.convertTime.addSince(convert_start_ticks);
+
+                // Images carry no time of their own, NDI stamps the frame as it is sent.
+                NDI_video_frame.timecode = NDIlib_send_timecode_synthesize;
+                NDI_video_frame.timestamp = 0;
+
                 // Send data
-                NDIlib_send_send_video_v2(pNdiSender, &NDI_video_frame);
-#endif
+                const auto send_start_ticks = juce::Time::getHighResolutionTicks();
+                {
+                    NDI_TRACE_ZONE("Send video");
+                    if (has_local_readers) writeLocal([&] { localWriter->writeVideo(NDI_video_frame); });
+                    if (has_ndi_receivers) ndiBackend->sendVideo(pNdiSender, &NDI_video_frame);
+                }
+                stats.sendTime.addSince(send_start_ticks);
+
                 // Free the data
                 free((void*)NDI_video_frame.p_data);
             }
@@ -148,18 +87,22 @@ public:
             {
                 // Create an audio buffer
                 NDIlib_audio_frame_v2_t NDI_audio_frame;
-                NdiAudioHelper::convertAudioFrame(NDI_audio_frame, frame.audio);
-
-#if JUCE_MAC
-                if(pNdiLib)
+                const auto convert_start_ticks = juce::Time::getHighResolutionTicks();
                 {
-                    // Send data
-                    pNdiLib->NDIlib_send_send_audio_v2(pNdiSender, &NDI_audio_frame);
+                    NDI_TRACE_ZONE("Convert audio");
+                    NdiAudioHelper::convertAudioFrame(NDI_audio_frame, frame.audio);
                 }
-#else
+                stats.convertTime.addSince(convert_start_ticks);
+
                 // Send data
-                NDIlib_send_send_audio_v2(pNdiSender, &NDI_audio_frame);
-#endif
+                const auto send_start_ticks = juce::Time::getHighResolutionTicks();
+                {
+                    NDI_TRACE_ZONE("Send audio");
+                    if (has_local_readers) writeLocal([&] { localWriter->writeAudio(NDI_audio_frame); });
+                    if (has_ndi_receivers) ndiBackend->sendAudio(pNdiSender, &NDI_audio_frame);
+                }
+                stats.sendTime.addSince(send_start_ticks);
+
                 // Free the data
                 free((void*)NDI_audio_frame.p_data);
             }
@@ -170,22 +113,134 @@ public:
         }
     }
 
-    int getTimeOutMsec() const
+    //==============================================================================
+    void startPublishing()
+    {
+        // Registered under the same name as the NDI sender, so receivers can map one to the other.
+        if (!inProcessPublisher)
+            inProcessPublisher = std::make_unique<NdiInProcessPublisher>(uuid_dashed_str);
+    }
+
+    void preparePublishing(int maxNumChannels, int maxNumSamples)
+    {
+        if (inProcessPublisher) inProcessPublisher->prepareAudio(maxNumChannels, maxNumSamples);
+    }
+
+    void publishAudio(const juce::AudioBuffer<float>& buffer, int sampleRate)
+    {
+        if (inProcessPublisher) inProcessPublisher->publishAudio(buffer, sampleRate);
+    }
+
+    void publishVideo(const juce::Image& image)
+    {
+        if (inProcessPublisher) inProcessPublisher->publishVideo(image);
+    }
+
+    bool hasInProcessReceivers() const
+    {
+        return inProcessPublisher && inProcessPublisher->hasSubscribers();
+    }
+
+    //==============================================================================
+    void updateConnectionState()
+    {
+        int num_ndi_connections = 0;
+        NDIlib_tally_t tally;
+        tally.on_program = false;
+        tally.on_preview = false;
+
+        if(ensureSender() && pNdiSender)
+        {
+            // Time out of zero, these only query the current state.
+            num_ndi_connections = ndiBackend->sendGetNoConnections(pNdiSender, 0);
+            ndiBackend->sendGetTally(pNdiSender, &tally, 0);
+        }
+
+        // Readers take a writer that stops beating for crashed.
+        if (localWriter) localWriter->updateHeartbeat();
+
+        // All local readers share the one segment, so they count as a single connection.
+        const bool has_local_readers = localWriter && localWriter->hasReaders();
+
+        numNdiConnections = num_ndi_connections;
+        numConnections = num_ndi_connections + (has_local_readers ? 1 : 0);
+        isTallyOnProgram = tally.on_program;
+        isTallyOnPreview = tally.on_preview;
+    }
+
+    int getNumConnections() const
+    {
+        return numConnections;
+    }
+
+    bool isOnProgram() const
+    {
+        return isTallyOnProgram;
+    }
+
+    bool isOnPreview() const
     {
-        return timeOutMsec;
+        return isTallyOnPreview;
     }
 
 private:
-    const NDIlib_v4* pNdiLib;
-    NDIlib_find_instance_t pNdiFinder;
-    NDIlib_send_instance_t pNdiSender;
+    //==============================================================================
+    // Created once and kept until the Impl is gone, so they are used without the lock afterwards.
+    bool ensureSender()
+    {
+        const juce::ScopedLock sender_lock(senderLock);
+
+        if (pNdiSender || localWriter) return true;
+
+        // Do not retry on every frame when the runtime is missing.
+        if (hasTriedCreatingSender) return false;
+        hasTriedCreatingSender = true;
+
+        // Receivers on this host read the frames from shared memory instead, keyed by the same name.
+        if (NdiSharedMemoryWriter::isSupported())
+        {
+            localWriter = std::make_unique<NdiSharedMemoryWriter>(uuid_dashed_str);
+            if (!localWriter->isOpen()) localWriter.reset();
+        }
+
+        // Create an NDI source named by our UUID. It is not clocked: the host audio and the camera
+        // already deliver frames in real time, and clocked sends would block the send thread.
+        ndiSendDesc.p_ndi_name = uuid_dashed_str.c_str();
+        ndiSendDesc.clock_video = false;
+        ndiSendDesc.clock_audio = false;
+
+        // We create the NDI sender
+        pNdiSender = ndiBackend->sendCreate(&ndiSendDesc);
+        return pNdiSender != nullptr || localWriter != nullptr;
+    }
+
+    // The shared memory ring takes one writer at a time, held only for the copy into it.
+    // NDI itself takes audio and video sends from separate threads.
+    template <typename Function>
+    void writeLocal(Function&& write)
+    {
+        const juce::ScopedLock local_write_lock(localWriteLock);
+        write();
+    }
+
+    //==============================================================================
+    NdiPipelineStats& stats;
+    std::shared_ptr<NdiBackend> ndiBackend{ NdiBackend::getDefault() };
+    NDIlib_send_instance_t pNdiSender{ nullptr };
+    bool hasTriedCreatingSender{ false };
     NDIlib_send_create_t ndiSendDesc;
+    std::unique_ptr<NdiSharedMemoryWriter> localWriter;
+    std::unique_ptr<NdiInProcessPublisher> inProcessPublisher;
 
     juce::Uuid uuid;
     std::string uuid_dashed_str;
-    juce::CriticalSection lock;
+    juce::CriticalSection senderLock;
+    juce::CriticalSection localWriteLock;
 
-    const int timeOutMsec{ 5000 };
+    std::atomic<int> numConnections{ 0 };
+    std::atomic<int> numNdiConnections{ 0 };
+    std::atomic<bool> isTallyOnProgram{ false };
+    std::atomic<bool> isTallyOnPreview{ false };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Impl)
 };
@@ -193,16 +248,19 @@ private:
 //==============================================================================
 NdiSendWrapper::NdiSendWrapper()
 {
-    pImpl = std::make_unique<NdiSendWrapper::Impl>();
+    pImpl = std::make_unique<NdiSendWrapper::Impl>(stats);
 }
 
 NdiSendWrapper::~NdiSendWrapper()
 {
+    // Its tasks send through the Impl, they are stopped first.
+    frameUpdater.reset();
     pImpl.reset();
 }
 
 void NdiSendWrapper::startSend()
 {
+    pImpl->startPublishing();
     frameUpdater = std::make_unique<FrameUpdater>(*this);
 }
 
@@ -221,8 +279,62 @@ void NdiSendWrapper::sendFrame(NdiFrame& frame) const
     pImpl->sendFrame(frame);
 }
 
-int NdiSendWrapper::getTimeOutMsec()
+void NdiSendWrapper::notifyAudioQueued()
+{
+    if (frameUpdater) frameUpdater->wakeAudio();
+}
+
+void NdiSendWrapper::notifyVideoQueued()
 {
-    return pImpl->getTimeOutMsec();
+    if (frameUpdater) frameUpdater->wakeVideo();
 }
 
+int NdiSendWrapper::getNumConnections() const
+{
+    return pImpl->getNumConnections();
+}
+
+bool NdiSendWrapper::hasReceivers() const
+{
+    return pImpl->getNumConnections() > 0 || pImpl->hasInProcessReceivers();
+}
+
+void NdiSendWrapper::preparePublishing(int maxNumChannels, int maxNumSamples)
+{
+    pImpl->preparePublishing(maxNumChannels, maxNumSamples);
+}
+
+void NdiSendWrapper::publishAudio(const juce::AudioBuffer<float>& buffer, int sampleRate)
+{
+    pImpl->publishAudio(buffer, sampleRate);
+}
+
+void NdiSendWrapper::publishVideo(const juce::Image& image)
+{
+    pImpl->publishVideo(image);
+}
+
+bool NdiSendWrapper::isOnProgram() const
+{
+    return pImpl->isOnProgram();
+}
+
+bool NdiSendWrapper::isOnPreview() const
+{
+    return pImpl->isOnPreview();
+}
+
+void NdiSendWrapper::setLowerFrameRateWhenOffProgram(bool shouldLower)
+{
+    lowerFrameRateWhenOffProgram = shouldLower;
+}
+
+bool NdiSendWrapper::isLowerFrameRateWhenOffProgram() const
+{
+    return lowerFrameRateWhenOffProgram;
+}
+
+void NdiSendWrapper::updateConnectionState()
+{
+    pImpl->updateConnectionState();
+}
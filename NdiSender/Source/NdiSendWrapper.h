@@ -11,6 +11,9 @@
 #pragma once
 #include <JuceHeader.h>
 #include "RingBuffer.h"
+#include "NdiPipelineStats.h"
+#include "NdiExecutor.h"
+#include "NdiTrace.h"
 
 class NdiSendWrapper
 {
@@ -18,90 +21,139 @@ class NdiSendWrapper
     class Impl;
 
     //==============================================================================
-    class FrameUpdater : public juce::Thread
+    // Sends what the audio and message threads queued, as two repeating tasks on the process wide executor.
+    // They idle while the caches are empty and are woken by whoever queues into them.
+    class FrameUpdater
     {
     public:
         //==============================================================================
         FrameUpdater(NdiSendWrapper& owner_)
-            : juce::Thread("NDI Frame Update Thread")
-            , owner(owner_)
+            : owner(owner_)
+            , queue("NDI Send", NdiThreadPolicy::Role::send, owner_.stats)
         {
-            retrieveBuffer.setSize(channel_size, sample_size);
-
-            startThread(10);
+            // Separate lanes, and the video is converted outside any lock, so a slow video frame never holds up the audio.
+            queue.submitRepeating([this]() { return sendAudio(); }, NdiExecutor::Lane::audio);
+            queue.submitRepeating([this]() { return sendVideo(); });
         }
 
         ~FrameUpdater()
         {
-            // Waiting time duration have to be longer than NDI receiver's time out msec.
-            stopThread(owner.getTimeOutMsec() + 1000);
+            // Returns once a send in progress is done, nothing runs after this.
+            queue.cancelAndWait();
         }
 
+        void wakeAudio() { queue.wake(NdiExecutor::Lane::audio); }
+        void wakeVideo() { queue.wake(NdiExecutor::Lane::normal); }
+
+    private:
         //==============================================================================
-        virtual void run() override
+        // Both return the msec until they want to run again.
+        int sendAudio()
         {
-            while(!threadShouldExit())
+            // Nobody is watching, drop everything without converting and idle.
+            if (!owner.hasReceivers())
             {
-                // Send audio...
-                if(owner.audioCache.isReady())
-                {
-                    retrieveBuffer.clear();
-                    const int actual_sample_size = owner.audioCache.pop(retrieveBuffer);
-
-                    NdiFrame frame;
-                    frame.type = NdiFrameType::kAudio;
-                    frame.audio.sample_rate = owner.audioCache.sampleRate;
-                    frame.audio.no_channels = owner.audioCache.numChannels;
-                    frame.audio.no_samples = actual_sample_size;
-                    frame.audio.p_data = NULL;
-                    frame.audio.p_metadata = NULL;
-
-                    frame.audio.samples = retrieveBuffer;
-
-                    frame.audio.timecode = 0;
-                    frame.audio.timestamp = 0;
-
-                    owner.sendFrame(frame);
-                }
-                
-                // Send video...
-                if (owner.videoCache.isReady())
-                {
-                    retrieveImage.clear({0, 0, 0, 0});
-                    const int actual_image_size = owner.videoCache.pop(retrieveImage);
-
-                    NdiFrame frame;
-                    frame.type = NdiFrameType::kVideo;
-
-                    frame.video.xres = retrieveImage.getWidth();
-                    frame.video.yres = retrieveImage.getHeight();
-                    frame.video.image = retrieveImage;
-
-                    frame.video.frame_rate_N = 30000;
-                    frame.video.frame_rate_D = 1001;
-
-                    frame.video.timecode;
-                    frame.video.timestamp;
-
-                    frame.video.p_metadata = NULL;
-
-                    owner.sendFrame(frame);
-                }
+                owner.audioCache.discardAll();
+                return idleIntervalMsec;
             }
 
-            DBG("Thread exited!!");
+            if (!owner.audioCache.isReady())
+                return idleIntervalMsec;
+
+            // As many channels as the bus, sized again only when the bus changes.
+            const int num_channels = juce::jmax(1, owner.audioCache.numChannels);
+            if (retrieveBuffer.getNumChannels() != num_channels || retrieveBuffer.getNumSamples() != sample_size)
+                retrieveBuffer.setSize(num_channels, sample_size);
+
+            retrieveBuffer.clear();
+            const int actual_sample_size = owner.audioCache.pop(retrieveBuffer);
+            owner.stats.sendQueueAudio.set(owner.audioCache.getNumReady());
+
+            NdiFrame frame;
+            frame.type = NdiFrameType::kAudio;
+            frame.audio.sample_rate = owner.audioCache.sampleRate;
+            frame.audio.no_channels = owner.audioCache.numChannels;
+            frame.audio.no_samples = actual_sample_size;
+            frame.audio.p_data = NULL;
+            frame.audio.p_metadata = NULL;
+
+            frame.audio.samples = retrieveBuffer;
+
+            frame.audio.timecode = 0;
+            frame.audio.timestamp = 0;
+
+            owner.sendFrame(frame);
+            owner.stats.audioFramesSent.add();
+
+            // More may be waiting, it is sent after the other instances had their turn.
+            return 0;
+        }
+
+        int sendVideo()
+        {
+            // Poll receivers at a low rate, the state only matters on a human time scale.
+            const auto now_msec = juce::Time::getMillisecondCounter();
+            if (now_msec - lastConnectionPollMsec >= (juce::uint32)connectionPollIntervalMsec)
+            {
+                owner.updateConnectionState();
+                lastConnectionPollMsec = now_msec;
+            }
+
+            if (!owner.hasReceivers())
+            {
+                owner.videoCache.discardAll();
+                return idleIntervalMsec;
+            }
+
+            if (!owner.videoCache.isReady())
+                return idleIntervalMsec;
+
+            retrieveImage.clear({0, 0, 0, 0});
+            owner.videoCache.pop(retrieveImage);
+            owner.stats.sendQueueVideo.set(owner.videoCache.getNumReady());
+
+            // Off program, the frame rate can be lowered by skipping the conversion of some frames.
+            const bool is_throttled = owner.isLowerFrameRateWhenOffProgram() && !owner.isOnProgram()
+                && (now_msec - lastVideoSendMsec) < (juce::uint32)offProgramFrameIntervalMsec;
+
+            if (!is_throttled)
+            {
+                NdiFrame frame;
+                frame.type = NdiFrameType::kVideo;
+
+                frame.video.xres = retrieveImage.getWidth();
+                frame.video.yres = retrieveImage.getHeight();
+                frame.video.image = retrieveImage;
+
+                frame.video.frame_rate_N = 30000;
+                frame.video.frame_rate_D = 1001;
+
+                frame.video.p_metadata = NULL;
+
+                owner.sendFrame(frame);
+                owner.stats.videoFramesSent.add();
+                lastVideoSendMsec = now_msec;
+            }
+
+            return 0;
         }
 
-    private:
         //==============================================================================
         NdiSendWrapper& owner;
-        int interval{ 30 };
 
-        const int channel_size = 16;
+        const int connectionPollIntervalMsec = 500;
+        const int idleIntervalMsec = 100;
+        const int offProgramFrameIntervalMsec = 200;
+        juce::uint32 lastConnectionPollMsec{ 0 };
+        juce::uint32 lastVideoSendMsec{ 0 };
+
         const int sample_size = 1U << 11;
         juce::AudioBuffer<float> retrieveBuffer;
         juce::Image retrieveImage;
 
+        // Last, so it is gone before anything its tasks use.
+        NdiExecutor::Queue queue;
+
         //==============================================================================
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FrameUpdater)
     };
@@ -171,17 +223,44 @@ public:
     void stopSend();
     bool isSending() const;
     void sendFrame(NdiFrame& frame) const;
-    int getTimeOutMsec();
+
+    // Call after pushing into audioCache or videoCache, the send task runs right away instead of after its idle interval.
+    // Neither allocates, the audio one is meant for the audio thread.
+    void notifyAudioQueued();
+    void notifyVideoQueued();
+
+    //==============================================================================
+    int getNumConnections() const;
+    bool hasReceivers() const;
+
+    // Receivers in the same process get these directly, with no NDI encode and no added latency.
+    // The audio one is lock free and meant for the audio thread, it never allocates once prepared for the largest block.
+    void preparePublishing(int maxNumChannels, int maxNumSamples);
+    void publishAudio(const juce::AudioBuffer<float>& buffer, int sampleRate);
+    void publishVideo(const juce::Image& image);
+    bool isOnProgram() const;
+    bool isOnPreview() const;
+    void setLowerFrameRateWhenOffProgram(bool shouldLower);
+    bool isLowerFrameRateWhenOffProgram() const;
 
     //==============================================================================
-    AudioRingBuffer<float> audioCache;
+    // About ten seconds at 48kHz for each channel of the bus, the send task empties it as soon as it is notified.
+    AudioRingBuffer<float> audioCache{ 1 << 19 };
     VideoRingBuffer videoCache;
 
+    // Updated lock free by the audio, message and send threads, read it from anywhere.
+    NdiPipelineStats stats;
+
 private:
     //==============================================================================
     std::unique_ptr<Impl> pImpl;
     std::unique_ptr<FrameUpdater> frameUpdater;
 
+    std::atomic<bool> lowerFrameRateWhenOffProgram{ false };
+
+    //==============================================================================
+    void updateConnectionState();
+
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NdiSendWrapper)
 };
\ No newline at end of file
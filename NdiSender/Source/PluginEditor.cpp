@@ -11,7 +11,7 @@
 
 //==============================================================================
 NdiSenderAudioProcessorEditor::NdiSenderAudioProcessorEditor (NdiSenderAudioProcessor& p)
-    : AudioProcessorEditor (&p), audioProcessor (p)
+    : AudioProcessorEditor (&p), audioProcessor (p), statsOverlay (p.getNdiEngine().stats)
 {
     addAndMakeVisible(cameraSelectorComboBox);
     updateCameraList();
@@ -21,6 +21,22 @@ NdiSenderAudioProcessorEditor::NdiSenderAudioProcessorEditor (NdiSenderAudioProc
         cameraChanged();
     };
 
+    // The pipeline counters are drawn over the preview on demand.
+    addChildComponent(statsOverlay);
+    statsButton.onClick = [this]
+    {
+        statsOverlay.setVisible(statsButton.getToggleState());
+    };
+    addAndMakeVisible(statsButton);
+
+    // Only offered in builds with NDI_TRACE_ENABLED.
+    traceButton.onClick = [this]
+    {
+        NdiTrace::saveChromeTraceAndReveal();
+    };
+    addChildComponent(traceButton);
+    traceButton.setVisible(NdiTrace::isEnabled());
+
     setSize (820, 600);
 
     startTimerHz(120);
@@ -66,11 +82,17 @@ void NdiSenderAudioProcessorEditor::resized()
 
     if (cameraPreviewComp.get() != nullptr)
         cameraPreviewComp->setBounds(previewArea);
+
+    statsButton.setBounds(getWidth() - 85, 5, 80, 25);
+    traceButton.setBounds(getWidth() - 170, 5, 80, 25);
+    statsOverlay.setBounds(previewArea);
 }
 
 void NdiSenderAudioProcessorEditor::timerCallback()
 {
-    takeSnapshot();
+    // Snapshots would be dropped by the sender anyway while no receiver is connected.
+    if (audioProcessor.getNdiEngine().hasReceivers())
+        takeSnapshot();
 }
 
 void NdiSenderAudioProcessorEditor::updateCameraList()
@@ -110,6 +132,7 @@ void NdiSenderAudioProcessorEditor::cameraDeviceOpenResult(juce::CameraDevice* d
     {
         cameraPreviewComp.reset(cameraDevice->createViewerComponent());
         addAndMakeVisible(cameraPreviewComp.get());
+        statsOverlay.toFront(false);
     }
     else
     {
@@ -133,8 +156,18 @@ void NdiSenderAudioProcessorEditor::takeSnapshot()
 
 void NdiSenderAudioProcessorEditor::imageReceived(const Image& image)
 {
+    NDI_TRACE_ZONE("Capture");
     if (!image.isValid())
         return;
 
-    audioProcessor.getNdiEngine().videoCache.push(image);
+    audioProcessor.getNdiEngine().publishVideo(image);
+
+    if (audioProcessor.getNdiEngine().getNumConnections() > 0)
+    {
+        NDI_TRACE_ZONE("Queue video");
+        if (audioProcessor.getNdiEngine().videoCache.push(image) == 0)
+            audioProcessor.getNdiEngine().stats.framesDropped.add();
+        audioProcessor.getNdiEngine().stats.sendQueueVideo.set(audioProcessor.getNdiEngine().videoCache.getNumReady());
+        audioProcessor.getNdiEngine().notifyVideoQueued();
+    }
 }
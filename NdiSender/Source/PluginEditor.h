@@ -10,6 +10,7 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "NdiStatsOverlay.h"
 
 //==============================================================================
 /**
@@ -46,6 +47,9 @@ private:
     juce::ComboBox cameraSelectorComboBox{ "Camera" };
     juce::TextButton snapshotButton{ "Take a snapshot" };
     juce::Label ndiName;
+    juce::ToggleButton statsButton{ "Stats" };
+    juce::TextButton traceButton{ "Save trace" };
+    NdiStatsOverlay statsOverlay;
 
 
 #ifdef JUCE_OPENGL
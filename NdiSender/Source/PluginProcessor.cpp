@@ -22,11 +22,13 @@ NdiSenderAudioProcessor::NdiSenderAudioProcessor()
                        )
 #endif
 {
-    getNdiEngine().startSend();
+    addParameter(lowerFrameRateOffProgram = new juce::AudioParameterBool("lowerFrameRateOffProgram", "Lower frame rate off program", false));
+    lowerFrameRateOffProgram->addListener(this);
 }
 
 NdiSenderAudioProcessor::~NdiSenderAudioProcessor()
 {
+    lowerFrameRateOffProgram->removeListener(this);
     getNdiEngine().stopSend();
 }
 
@@ -95,9 +97,15 @@ void NdiSenderAudioProcessor::changeProgramName (int index, const juce::String&
 //==============================================================================
 void NdiSenderAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    ndiWrapper.audioCache.numChannels = getTotalNumOutputChannels();
     ndiWrapper.audioCache.sampleRate = sampleRate;
-    ndiWrapper.audioCache.reset();
+    ndiWrapper.audioCache.setNumChannels(getTotalNumOutputChannels());
+
+    // Started here rather than in the constructor, so plugin scans never touch NDI.
+    if (!ndiWrapper.isSending())
+        ndiWrapper.startSend();
+
+    // Every block processBlock() may publish, so the audio thread never allocates for it.
+    ndiWrapper.preparePublishing(juce::jmax(getTotalNumInputChannels(), getTotalNumOutputChannels()), samplesPerBlock);
 }
 
 void NdiSenderAudioProcessor::releaseResources()
@@ -113,10 +121,9 @@ bool NdiSenderAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts
     juce::ignoreUnused (layouts);
     return true;
   #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Any layout up to the channels the ring carries, NDI sends the channels as they are.
+    const int num_channels = layouts.getMainOutputChannelSet().size();
+    if (num_channels < 1 || num_channels > AudioRingBuffer<float>::maxChannels)
         return false;
 
     // This checks if the input layout matches the output layout
@@ -132,13 +139,27 @@ bool NdiSenderAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts
 
 void NdiSenderAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    NDI_TRACE_ZONE("processBlock");
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
-    ndiWrapper.audioCache.numChannels = buffer.getNumChannels();
+    // Nothing to do while no receiver is connected.
+    if (!ndiWrapper.hasReceivers())
+        return;
+
+    // Receivers in this process take the block as it is, within the same host cycle.
+    ndiWrapper.publishAudio(buffer, static_cast<int>(getSampleRate()));
+
+    if (ndiWrapper.getNumConnections() == 0)
+        return;
+
+    NDI_TRACE_ZONE("Queue audio");
     ndiWrapper.audioCache.sampleRate = static_cast<int>(getSampleRate());
-    ndiWrapper.audioCache.push(buffer);
+    if (ndiWrapper.audioCache.push(buffer) < buffer.getNumSamples())
+        ndiWrapper.stats.framesDropped.add();
+    ndiWrapper.stats.sendQueueAudio.set(ndiWrapper.audioCache.getNumReady());
+    ndiWrapper.notifyAudioQueued();
 }
 
 //==============================================================================
@@ -152,18 +173,28 @@ juce::AudioProcessorEditor* NdiSenderAudioProcessor::createEditor()
     return new NdiSenderAudioProcessorEditor (*this);
 }
 
+//==============================================================================
+void NdiSenderAudioProcessor::parameterValueChanged(int parameterIndex, float newValue)
+{
+    // The send task reads it from the wrapper, on whatever thread the host changed it.
+    ndiWrapper.setLowerFrameRateWhenOffProgram(lowerFrameRateOffProgram->get());
+}
+
 //==============================================================================
 void NdiSenderAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
+    juce::MemoryOutputStream stream(destData, false);
+    stream.writeBool(lowerFrameRateOffProgram->get());
 }
 
 void NdiSenderAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
+    // Sessions saved before there was any state are empty.
+    if (sizeInBytes < 1)
+        return;
+
+    juce::MemoryInputStream stream(data, (size_t)sizeInBytes, false);
+    *lowerFrameRateOffProgram = stream.readBool();
 }
 
 //==============================================================================
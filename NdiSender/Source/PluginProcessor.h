@@ -15,6 +15,7 @@
 /**
 */
 class NdiSenderAudioProcessor  : public juce::AudioProcessor
+                               , private juce::AudioProcessorParameter::Listener
 {
 public:
     //==============================================================================
@@ -57,10 +58,20 @@ public:
     //==============================================================================
     NdiSendWrapper& getNdiEngine() { return ndiWrapper; }
 
+    /** Sends video at 5 fps while no receiver has the source on program. */
+    juce::AudioParameterBool& getLowerFrameRateOffProgramParameter() { return *lowerFrameRateOffProgram; }
+
 private:
+    //==============================================================================
+    void parameterValueChanged(int parameterIndex, float newValue) override;
+    void parameterGestureChanged(int parameterIndex, bool gestureIsStarting) override {}
+
     //==============================================================================
     NdiSendWrapper ndiWrapper;
 
+    // Owned by the processor once added.
+    juce::AudioParameterBool* lowerFrameRateOffProgram;
+
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (NdiSenderAudioProcessor)
 };